@@ -0,0 +1,184 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include "batch_engine.h"
+#include "thread_pool.h"
+
+static const Gameboy_Keys k_batch_engine_keys[8] = {
+    Right_Key, Left_Key, Up_Key, Down_Key, A_Key, B_Key, Select_Key, Start_Key
+};
+
+BatchEngine::BatchEngine()
+{
+    InitPointer(m_pool);
+}
+
+BatchEngine::~BatchEngine()
+{
+    Shutdown();
+}
+
+bool BatchEngine::Init(int instances, int threads, GB_Color_Format pixel_format)
+{
+    Shutdown();
+
+    if (instances <= 0)
+        return false;
+
+    if (threads <= 0)
+        threads = ThreadPool::GetHardwareThreads();
+
+    m_instances.resize(instances);
+
+    for (int i = 0; i < instances; i++)
+    {
+        Instance& instance = m_instances[i];
+        instance.core = new GearboyCore();
+        instance.core->Init(pixel_format);
+        instance.frame_buffer = new u16[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+        instance.sample_buffer = new s16[AUDIO_BUFFER_SIZE];
+        instance.sample_count = 0;
+        instance.frame_count = 0;
+        instance.keys = 0;
+        instance.applied_keys = 0;
+        instance.loaded = false;
+        memset(instance.frame_buffer, 0, SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * sizeof(u16));
+    }
+
+    m_pool = new ThreadPool(MIN(threads, instances));
+    return true;
+}
+
+void BatchEngine::Shutdown()
+{
+    SafeDelete(m_pool);
+
+    for (size_t i = 0; i < m_instances.size(); i++)
+    {
+        SafeDelete(m_instances[i].core);
+        SafeDeleteArray(m_instances[i].frame_buffer);
+        SafeDeleteArray(m_instances[i].sample_buffer);
+    }
+
+    m_instances.clear();
+}
+
+int BatchEngine::GetInstanceCount() const
+{
+    return (int)m_instances.size();
+}
+
+int BatchEngine::GetThreadCount() const
+{
+    return IsValidPointer(m_pool) ? m_pool->GetThreadCount() : 0;
+}
+
+GearboyCore* BatchEngine::GetCore(int index)
+{
+    return m_instances[index].core;
+}
+
+bool BatchEngine::LoadROM(int index, const char* path, bool force_dmg)
+{
+    Instance& instance = m_instances[index];
+    instance.loaded = instance.core->LoadROM(path, force_dmg);
+    instance.keys = 0;
+    instance.applied_keys = 0;
+    instance.frame_count = 0;
+    return instance.loaded;
+}
+
+bool BatchEngine::LoadROMFromBuffer(int index, const u8* buffer, int size, bool force_dmg)
+{
+    Instance& instance = m_instances[index];
+    instance.loaded = instance.core->LoadROMFromBuffer(buffer, size, force_dmg);
+    instance.keys = 0;
+    instance.applied_keys = 0;
+    instance.frame_count = 0;
+    return instance.loaded;
+}
+
+// Keys are a mask of Gameboy_Keys values, applied before the next frame runs
+void BatchEngine::SetInput(int index, u8 keys)
+{
+    m_instances[index].keys = keys;
+}
+
+void BatchEngine::RunFrames(int frames)
+{
+    if (!IsValidPointer(m_pool) || frames <= 0)
+        return;
+
+    m_pool->ParallelFor((int)m_instances.size(), [this, frames](int index) {
+        RunInstance(index, frames);
+    });
+}
+
+const u16* BatchEngine::GetFrameBuffer(int index) const
+{
+    return m_instances[index].frame_buffer;
+}
+
+const s16* BatchEngine::GetSampleBuffer(int index) const
+{
+    return m_instances[index].sample_buffer;
+}
+
+int BatchEngine::GetSampleCount(int index) const
+{
+    return m_instances[index].sample_count;
+}
+
+u64 BatchEngine::GetFrameCount(int index) const
+{
+    return m_instances[index].frame_count;
+}
+
+void BatchEngine::RunInstance(int index, int frames)
+{
+    Instance& instance = m_instances[index];
+
+    if (!instance.loaded)
+        return;
+
+    u8 changed = instance.keys ^ instance.applied_keys;
+    if (changed != 0)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            Gameboy_Keys key = k_batch_engine_keys[i];
+            if ((changed & key) == 0)
+                continue;
+            if (instance.keys & key)
+                instance.core->KeyPressed(key);
+            else
+                instance.core->KeyReleased(key);
+        }
+        instance.applied_keys = instance.keys;
+    }
+
+    // Only the last frame of a step is observed, the rest skip pixel work
+    for (int i = 0; i < frames; i++)
+    {
+        bool render = (i == (frames - 1));
+        instance.sample_count = 0;
+        instance.core->RunToVBlank(instance.frame_buffer, instance.sample_buffer, &instance.sample_count, false, NULL, render);
+        instance.frame_count++;
+    }
+}
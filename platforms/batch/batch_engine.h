@@ -0,0 +1,67 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#ifndef BATCH_ENGINE_H
+#define BATCH_ENGINE_H
+
+#include <vector>
+#include "gearboy.h"
+
+class ThreadPool;
+
+class BatchEngine
+{
+public:
+    BatchEngine();
+    ~BatchEngine();
+    bool Init(int instances, int threads, GB_Color_Format pixel_format = GB_PIXEL_RGB565);
+    int GetInstanceCount() const;
+    int GetThreadCount() const;
+    GearboyCore* GetCore(int index);
+    bool LoadROM(int index, const char* path, bool force_dmg = false);
+    bool LoadROMFromBuffer(int index, const u8* buffer, int size, bool force_dmg = false);
+    void SetInput(int index, u8 keys);
+    void RunFrames(int frames = 1);
+    const u16* GetFrameBuffer(int index) const;
+    const s16* GetSampleBuffer(int index) const;
+    int GetSampleCount(int index) const;
+    u64 GetFrameCount(int index) const;
+
+private:
+    struct Instance
+    {
+        GearboyCore* core;
+        u16* frame_buffer;
+        s16* sample_buffer;
+        int sample_count;
+        u64 frame_count;
+        u8 keys;
+        u8 applied_keys;
+        bool loaded;
+    };
+
+    void Shutdown();
+    void RunInstance(int index, int frames);
+
+private:
+    std::vector<Instance> m_instances;
+    ThreadPool* m_pool;
+};
+
+#endif /* BATCH_ENGINE_H */
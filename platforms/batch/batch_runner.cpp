@@ -0,0 +1,312 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include <chrono>
+#include "batch_runner.h"
+#include "batch_engine.h"
+#include "thread_pool.h"
+
+#define BATCH_HASH_SEED 0xCBF29CE484222325ULL
+#define BATCH_HASH_PRIME 0x100000001B3ULL
+
+static u64 hash_bytes(u64 hash, const void* data, size_t size)
+{
+    const u8* bytes = (const u8*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= BATCH_HASH_PRIME;
+    }
+    return hash;
+}
+
+static double elapsed_ms(const std::chrono::steady_clock::time_point& start)
+{
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+static void write_json_string(FILE* file, const char* text)
+{
+    fputc('"', file);
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++)
+    {
+        switch (*p)
+        {
+            case '"': fputs("\\\"", file); break;
+            case '\\': fputs("\\\\", file); break;
+            case '\n': fputs("\\n", file); break;
+            case '\r': fputs("\\r", file); break;
+            case '\t': fputs("\\t", file); break;
+            default:
+                if (*p < 0x20)
+                    fprintf(file, "\\u%04X", *p);
+                else
+                    fputc(*p, file);
+                break;
+        }
+    }
+    fputc('"', file);
+}
+
+static const char* model_name(Batch_Model model)
+{
+    switch (model)
+    {
+        case Batch_Model_DMG: return "dmg";
+        case Batch_Model_SGB: return "sgb";
+        case Batch_Model_GBA: return "gba";
+        default: return "auto";
+    }
+}
+
+void batch_options_default(BatchOptions& options)
+{
+    options.frames = 600;
+    options.hash_interval = 0;
+    options.model = Batch_Model_Auto;
+    options.input = NULL;
+}
+
+void batch_run_rom(const char* path, const BatchOptions& options, BatchResult& result)
+{
+    result.rom = path;
+    result.success = false;
+    result.error.clear();
+    result.title.clear();
+    result.cgb = false;
+    result.sgb = false;
+    result.width = GAMEBOY_WIDTH;
+    result.height = GAMEBOY_HEIGHT;
+    result.frames = 0;
+    result.frame_hash = BATCH_HASH_SEED;
+    result.video_hash = BATCH_HASH_SEED;
+    result.audio_hash = BATCH_HASH_SEED;
+    result.audio_samples = 0;
+    result.load_ms = 0.0;
+    result.run_ms = 0.0;
+    result.frame_hashes.clear();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Every ROM gets a fresh core so results never depend on the previous job
+    GearboyCore* core = new GearboyCore();
+    core->Init();
+    core->SetSGBEnabled(options.model == Batch_Model_SGB);
+    core->SetSGBBorder(options.model == Batch_Model_SGB);
+
+    if (!core->LoadROM(path, options.model == Batch_Model_DMG, Cartridge::CartridgeNotSupported, options.model == Batch_Model_GBA))
+    {
+        result.error = "Unable to load ROM";
+        result.load_ms = elapsed_ms(start);
+        SafeDelete(core);
+        return;
+    }
+
+    result.title = core->GetCartridge()->GetName();
+    result.cgb = core->IsCGB();
+    result.sgb = core->IsSGB();
+    result.load_ms = elapsed_ms(start);
+
+    u16* frame_buffer = new u16[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+    s16* sample_buffer = new s16[AUDIO_BUFFER_SIZE];
+    memset(frame_buffer, 0, SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * sizeof(u16));
+
+    size_t next_event = 0;
+    size_t event_count = IsValidPointer(options.input) ? options.input->events.size() : 0;
+
+    start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < options.frames; frame++)
+    {
+        while (next_event < event_count && options.input->events[next_event].frame <= frame)
+        {
+            const InputScriptEvent& event = options.input->events[next_event];
+            if (event.pressed)
+                core->KeyPressed(event.key);
+            else
+                core->KeyReleased(event.key);
+            next_event++;
+        }
+
+        int sample_count = 0;
+        core->RunToVBlank(frame_buffer, sample_buffer, &sample_count);
+
+        GB_RuntimeInfo runtime_info;
+        core->GetRuntimeInfo(runtime_info);
+        result.width = runtime_info.screen_width;
+        result.height = runtime_info.screen_height;
+
+        result.frame_hash = hash_bytes(BATCH_HASH_SEED, frame_buffer,
+            (size_t)(result.width * result.height) * sizeof(u16));
+        result.video_hash = hash_bytes(result.video_hash, &result.frame_hash, sizeof(result.frame_hash));
+
+        if (sample_count > 0)
+        {
+            result.audio_hash = hash_bytes(result.audio_hash, sample_buffer, (size_t)sample_count * sizeof(s16));
+            result.audio_samples += (u64)sample_count;
+        }
+
+        if ((options.hash_interval > 0) && (((frame + 1) % options.hash_interval) == 0))
+            result.frame_hashes.push_back(result.frame_hash);
+
+        result.frames++;
+    }
+
+    result.run_ms = elapsed_ms(start);
+    result.success = true;
+
+    SafeDeleteArray(sample_buffer);
+    SafeDeleteArray(frame_buffer);
+    SafeDelete(core);
+}
+
+void batch_write_json(FILE* file, const BatchOptions& options,
+    const std::vector<BatchResult>& results, double total_ms)
+{
+    u64 total_frames = 0;
+    int failed = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        total_frames += (u64)results[i].frames;
+        if (!results[i].success)
+            failed++;
+    }
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"emulator\": ");
+    write_json_string(file, GEARBOY_TITLE " " GEARBOY_VERSION);
+    fprintf(file, ",\n");
+    fprintf(file, "  \"frames\": %d,\n", options.frames);
+    fprintf(file, "  \"model\": \"%s\",\n", model_name(options.model));
+    fprintf(file, "  \"hash_interval\": %d,\n", options.hash_interval);
+    fprintf(file, "  \"roms\": %d,\n", (int)results.size());
+    fprintf(file, "  \"failed\": %d,\n", failed);
+    fprintf(file, "  \"total_frames\": %llu,\n", (unsigned long long)total_frames);
+    fprintf(file, "  \"total_ms\": %.3f,\n", total_ms);
+    fprintf(file, "  \"results\": [");
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BatchResult& r = results[i];
+
+        fprintf(file, "%s\n    {\n", i == 0 ? "" : ",");
+        fprintf(file, "      \"rom\": ");
+        write_json_string(file, r.rom.c_str());
+        fprintf(file, ",\n      \"status\": \"%s\"", r.success ? "ok" : "error");
+
+        if (!r.success)
+        {
+            fprintf(file, ",\n      \"error\": ");
+            write_json_string(file, r.error.c_str());
+            fprintf(file, "\n    }");
+            continue;
+        }
+
+        double fps = r.run_ms > 0.0 ? (double)r.frames * 1000.0 / r.run_ms : 0.0;
+
+        fprintf(file, ",\n      \"title\": ");
+        write_json_string(file, r.title.c_str());
+        fprintf(file, ",\n      \"cgb\": %s", r.cgb ? "true" : "false");
+        fprintf(file, ",\n      \"sgb\": %s", r.sgb ? "true" : "false");
+        fprintf(file, ",\n      \"width\": %d", r.width);
+        fprintf(file, ",\n      \"height\": %d", r.height);
+        fprintf(file, ",\n      \"frames\": %d", r.frames);
+        fprintf(file, ",\n      \"frame_hash\": \"%016llx\"", (unsigned long long)r.frame_hash);
+        fprintf(file, ",\n      \"video_hash\": \"%016llx\"", (unsigned long long)r.video_hash);
+        fprintf(file, ",\n      \"audio_hash\": \"%016llx\"", (unsigned long long)r.audio_hash);
+        fprintf(file, ",\n      \"audio_samples\": %llu", (unsigned long long)r.audio_samples);
+        fprintf(file, ",\n      \"load_ms\": %.3f", r.load_ms);
+        fprintf(file, ",\n      \"run_ms\": %.3f", r.run_ms);
+        fprintf(file, ",\n      \"fps\": %.1f", fps);
+
+        if (options.hash_interval > 0)
+        {
+            fprintf(file, ",\n      \"frame_hashes\": [");
+            for (size_t h = 0; h < r.frame_hashes.size(); h++)
+                fprintf(file, "%s\"%016llx\"", h == 0 ? "" : ", ", (unsigned long long)r.frame_hashes[h]);
+            fprintf(file, "]");
+        }
+
+        fprintf(file, "\n    }");
+    }
+
+    fprintf(file, "%s]\n}\n", results.empty() ? "" : "\n  ");
+}
+
+// Runs the same workload on a BatchEngine with 1, 2, 4... threads up to
+// the hardware thread count and reports aggregate frames per second
+bool batch_run_scaling(FILE* file, const std::vector<std::string>& roms,
+    const BatchOptions& options, int instances)
+{
+    int hardware_threads = ThreadPool::GetHardwareThreads();
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < hardware_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(hardware_threads);
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"emulator\": ");
+    write_json_string(file, GEARBOY_TITLE " " GEARBOY_VERSION);
+    fprintf(file, ",\n");
+    fprintf(file, "  \"benchmark\": \"scaling\",\n");
+    fprintf(file, "  \"instances\": %d,\n", instances);
+    fprintf(file, "  \"frames\": %d,\n", options.frames);
+    fprintf(file, "  \"hardware_threads\": %d,\n", hardware_threads);
+    fprintf(file, "  \"results\": [");
+
+    double base_fps = 0.0;
+
+    for (size_t t = 0; t < thread_counts.size(); t++)
+    {
+        BatchEngine engine;
+        engine.Init(instances, thread_counts[t]);
+
+        for (int i = 0; i < instances; i++)
+        {
+            GearboyCore* core = engine.GetCore(i);
+            core->SetSGBEnabled(options.model == Batch_Model_SGB);
+            core->SetSGBBorder(options.model == Batch_Model_SGB);
+
+            const char* path = roms[i % roms.size()].c_str();
+            if (!engine.LoadROM(i, path, options.model == Batch_Model_DMG))
+            {
+                fprintf(stderr, "Unable to load ROM: %s\n", path);
+                return false;
+            }
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for (int frame = 0; frame < options.frames; frame++)
+            engine.RunFrames(1);
+
+        double ms = elapsed_ms(start);
+        double fps = ms > 0.0 ? ((double)instances * options.frames * 1000.0) / ms : 0.0;
+        if (t == 0)
+            base_fps = fps;
+
+        fprintf(file, "%s\n    { \"threads\": %d, \"ms\": %.3f, \"fps\": %.1f, \"speedup\": %.2f }",
+                t == 0 ? "" : ",", engine.GetThreadCount(), ms, fps, base_fps > 0.0 ? fps / base_fps : 0.0);
+        fflush(file);
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+    return true;
+}
@@ -0,0 +1,71 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <string>
+#include <vector>
+#include "gearboy.h"
+#include "input_script.h"
+
+enum Batch_Model
+{
+    Batch_Model_Auto = 0,
+    Batch_Model_DMG,
+    Batch_Model_SGB,
+    Batch_Model_GBA
+};
+
+struct BatchOptions
+{
+    int frames;
+    int hash_interval;
+    Batch_Model model;
+    const InputScript* input;
+};
+
+struct BatchResult
+{
+    std::string rom;
+    bool success;
+    std::string error;
+    std::string title;
+    bool cgb;
+    bool sgb;
+    int width;
+    int height;
+    int frames;
+    u64 frame_hash;
+    u64 video_hash;
+    u64 audio_hash;
+    u64 audio_samples;
+    double load_ms;
+    double run_ms;
+    std::vector<u64> frame_hashes;
+};
+
+void batch_options_default(BatchOptions& options);
+void batch_run_rom(const char* path, const BatchOptions& options, BatchResult& result);
+void batch_write_json(FILE* file, const BatchOptions& options,
+    const std::vector<BatchResult>& results, double total_ms);
+bool batch_run_scaling(FILE* file, const std::vector<std::string>& roms,
+    const BatchOptions& options, int instances);
+
+#endif /* BATCH_RUNNER_H */
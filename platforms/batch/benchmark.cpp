@@ -0,0 +1,684 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include <chrono>
+#include <vector>
+#include "gearboy.h"
+
+#define BENCHMARK_ROM_SIZE 0x8000
+#define BENCHMARK_DEFAULT_FRAMES 1800
+#define BENCHMARK_WARMUP_FRAMES 150
+
+#define BENCHMARK_COPY_ADDR 0x0070
+#define BENCHMARK_SGB_SEND_ADDR 0x0090
+#define BENCHMARK_INIT_ADDR 0x0150
+#define BENCHMARK_VBLANK_ADDR 0x0400
+#define BENCHMARK_TILES_ADDR 0x4000
+#define BENCHMARK_MAP_ADDR 0x5800
+#define BENCHMARK_ATTR_ADDR 0x6000
+#define BENCHMARK_BG_PALETTE_ADDR 0x6800
+#define BENCHMARK_OBJ_PALETTE_ADDR 0x6840
+#define BENCHMARK_OAM_ADDR 0x6880
+#define BENCHMARK_WAVE_ADDR 0x6920
+#define BENCHMARK_SGB_PACKETS_ADDR 0x6940
+
+#define BENCHMARK_HASH_SEED 0xCBF29CE484222325ULL
+#define BENCHMARK_HASH_PRIME 0x100000001B3ULL
+
+#if defined(PERFORMANCE)
+static const char* k_renderer = "performance";
+#else
+static const char* k_renderer = "accurate";
+#endif
+
+struct BenchmarkWorkload
+{
+    const char* name;
+    const char* description;
+    bool cgb;
+    bool sgb;
+    bool sprites;
+    bool hdma;
+    bool audio;
+};
+
+static const BenchmarkWorkload k_workloads[] = {
+    { "dmg_bg", "DMG scrolling background", false, false, false, false, false },
+    { "cgb_bg", "CGB scrolling background with attributes", true, false, false, false, false },
+    { "dmg_sprites", "DMG background and 40 moving 8x16 sprites", false, false, true, false, false },
+    { "cgb_sprites", "CGB background and 40 moving 8x16 sprites", true, false, true, false, false },
+    { "cgb_hdma", "CGB general purpose and HBlank HDMA every frame", true, false, false, true, false },
+    { "dmg_audio", "DMG all channels retriggered, NR13 written in a loop", false, false, false, false, true },
+    { "sgb_border", "SGB scrolling background with a PCT_TRN border", false, true, false, false, false }
+};
+
+static const int k_workload_count = (int)(sizeof(k_workloads) / sizeof(k_workloads[0]));
+
+struct BenchmarkResult
+{
+    const BenchmarkWorkload* workload;
+    int frames;
+    double ms;
+    double fps;
+    double instructions_per_second;
+    u64 frame_hash;
+    bool profiled;
+    GB_Profiler_Frame profile;
+};
+
+struct RomWriter
+{
+    u8* rom;
+    u16 pc;
+};
+
+static void emit(RomWriter& w, u8 a)
+{
+    w.rom[w.pc++] = a;
+}
+
+static void emit(RomWriter& w, u8 a, u8 b)
+{
+    emit(w, a);
+    emit(w, b);
+}
+
+static void emit16(RomWriter& w, u8 opcode, u16 value)
+{
+    emit(w, opcode, value & 0xFF);
+    emit(w, value >> 8);
+}
+
+static void emit_jr(RomWriter& w, u8 opcode, u16 target)
+{
+    emit(w, opcode, (u8)(target - (w.pc + 2)));
+}
+
+// LDH (n),A with A loaded first
+static void emit_io(RomWriter& w, u8 reg, u8 value)
+{
+    if (value == 0)
+        emit(w, 0xAF);
+    else
+        emit(w, 0x3E, value);
+    emit(w, 0xE0, reg);
+}
+
+// HL = source, DE = destination, BC = length
+static void emit_copy(RomWriter& w, u16 src, u16 dst, u16 length)
+{
+    emit16(w, 0x21, src);
+    emit16(w, 0x11, dst);
+    emit16(w, 0x01, length);
+    emit16(w, 0xCD, BENCHMARK_COPY_ADDR);
+}
+
+static void emit_palette(RomWriter& w, u8 index_reg, u16 src)
+{
+    emit_io(w, index_reg, 0x80);
+    emit16(w, 0x21, src);
+    emit(w, 0x06, 64);
+    u16 loop = w.pc;
+    emit(w, 0x2A);
+    emit(w, 0xE0, index_reg + 1);
+    emit(w, 0x05);
+    emit_jr(w, 0x20, loop);
+}
+
+static void emit_sgb_packet(RomWriter& w, int packet)
+{
+    emit16(w, 0x21, BENCHMARK_SGB_PACKETS_ADDR + (packet * 16));
+    emit16(w, 0xCD, BENCHMARK_SGB_SEND_ADDR);
+}
+
+// Waits for the given number of VBlank interrupts
+static void emit_wait_frames(RomWriter& w, u8 frames)
+{
+    emit(w, 0x06, frames);
+    u16 loop = w.pc;
+    emit(w, 0x76);
+    emit(w, 0x05);
+    emit_jr(w, 0x20, loop);
+}
+
+static void build_data(u8* rom, const BenchmarkWorkload& workload)
+{
+    u32 seed = 0x12345678;
+
+    for (int i = 0; i < 0x1800; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        rom[BENCHMARK_TILES_ADDR + i] = (u8)(seed >> 16);
+    }
+
+    for (int i = 0; i < 0x800; i++)
+    {
+        rom[BENCHMARK_MAP_ADDR + i] = (u8)((i * 7) + (i >> 5));
+        rom[BENCHMARK_ATTR_ADDR + i] = (u8)((i & 0x07) | ((i << 1) & 0x68) | ((i & 0x100) >> 1));
+    }
+
+    for (int i = 0; i < 32; i++)
+    {
+        u16 bg_color = (u16)((i * 0x0843) ^ 0x7FFF) & 0x7FFF;
+        u16 obj_color = (u16)(i * 0x1CE7) & 0x7FFF;
+        rom[BENCHMARK_BG_PALETTE_ADDR + (i * 2)] = bg_color & 0xFF;
+        rom[BENCHMARK_BG_PALETTE_ADDR + (i * 2) + 1] = bg_color >> 8;
+        rom[BENCHMARK_OBJ_PALETTE_ADDR + (i * 2)] = obj_color & 0xFF;
+        rom[BENCHMARK_OBJ_PALETTE_ADDR + (i * 2) + 1] = obj_color >> 8;
+    }
+
+    // Four rows of ten overlapping 8x16 sprites keep the line limit busy
+    for (int i = 0; i < 40 && workload.sprites; i++)
+    {
+        u8* sprite = &rom[BENCHMARK_OAM_ADDR + (i * 4)];
+        sprite[0] = (u8)(16 + ((i / 10) * 34) + ((i % 10) * 2));
+        sprite[1] = (u8)(8 + ((i % 10) * 15) + ((i / 10) * 4));
+        sprite[2] = (u8)(i * 2);
+        sprite[3] = (u8)((i & 0x0F) | ((i << 1) & 0x60) | ((i & 0x10) << 3));
+    }
+
+    for (int i = 0; i < 16; i++)
+        rom[BENCHMARK_WAVE_ADDR + i] = (u8)((i * 0x11) ^ 0x0F);
+
+    // PAL01, CHR_TRN low and high, PCT_TRN and MASK_EN cancel. The VRAM
+    // transfers pick up whatever is on screen, which makes a busy border
+    static const u16 k_sgb_colors[7] = { 0x7FFF, 0x5294, 0x294A, 0x0000, 0x7C00, 0x03E0, 0x001F };
+    u8* packets = &rom[BENCHMARK_SGB_PACKETS_ADDR];
+    packets[0] = (SGB::PAL01 << 3) | 1;
+    for (int i = 0; i < 7; i++)
+    {
+        packets[1 + (i * 2)] = k_sgb_colors[i] & 0xFF;
+        packets[2 + (i * 2)] = k_sgb_colors[i] >> 8;
+    }
+    packets[16] = (SGB::CHR_TRN << 3) | 1;
+    packets[32] = (SGB::CHR_TRN << 3) | 1;
+    packets[33] = 1;
+    packets[48] = (SGB::PCT_TRN << 3) | 1;
+    packets[64] = (SGB::MASK_EN << 3) | 1;
+}
+
+static void build_rom(u8* rom, const BenchmarkWorkload& workload)
+{
+    memset(rom, 0, BENCHMARK_ROM_SIZE);
+    build_data(rom, workload);
+
+    RomWriter w;
+    w.rom = rom;
+
+    w.pc = 0x0040;
+    emit16(w, 0xC3, BENCHMARK_VBLANK_ADDR);
+
+    // copy: LD A,(HL+); LD (DE),A; INC DE; DEC BC; LD A,B; OR C; JR NZ copy; RET
+    w.pc = BENCHMARK_COPY_ADDR;
+    emit(w, 0x2A);
+    emit(w, 0x12);
+    emit(w, 0x13);
+    emit(w, 0x0B);
+    emit(w, 0x78);
+    emit(w, 0xB1);
+    emit_jr(w, 0x20, BENCHMARK_COPY_ADDR);
+    emit(w, 0xC9);
+
+    // sgb_send: sends the 16 byte packet at HL through JOYP
+    w.pc = BENCHMARK_SGB_SEND_ADDR;
+    emit_io(w, 0x00, 0x00);
+    emit_io(w, 0x00, 0x30);
+    emit(w, 0x06, 16);
+    u16 byte_loop = w.pc;
+    emit(w, 0x2A);
+    emit(w, 0x5F);
+    emit(w, 0x0E, 8);
+    u16 bit_loop = w.pc;
+    emit(w, 0xCB, 0x3B);
+    emit(w, 0x3E, 0x10);
+    emit(w, 0x38, 0x02);
+    emit(w, 0x3E, 0x20);
+    emit(w, 0xE0, 0x00);
+    emit_io(w, 0x00, 0x30);
+    emit(w, 0x0D);
+    emit_jr(w, 0x20, bit_loop);
+    emit(w, 0x05);
+    emit_jr(w, 0x20, byte_loop);
+    emit_io(w, 0x00, 0x20);
+    emit_io(w, 0x00, 0x30);
+    emit(w, 0xC9);
+
+    assert(w.pc <= 0x0100);
+
+    w.pc = 0x0100;
+    emit(w, 0x00);
+    emit16(w, 0xC3, BENCHMARK_INIT_ADDR);
+
+    snprintf((char*)&rom[0x134], 11, "%s", "GBBENCH");
+    rom[0x143] = workload.cgb ? 0xC0 : 0x00;
+    rom[0x146] = workload.sgb ? 0x03 : 0x00;
+    rom[0x14B] = workload.sgb ? 0x33 : 0x01;
+
+    u8 checksum = 0;
+    for (int i = 0x134; i < 0x14D; i++)
+        checksum = checksum - rom[i] - 1;
+    rom[0x14D] = checksum;
+
+    w.pc = BENCHMARK_INIT_ADDR;
+    emit(w, 0xF3);
+    emit16(w, 0x31, 0xFFFE);
+    emit_io(w, 0x40, 0x00);
+
+    emit_copy(w, BENCHMARK_TILES_ADDR, 0x8000, 0x1800);
+    emit_copy(w, BENCHMARK_MAP_ADDR, 0x9800, 0x0800);
+
+    if (workload.cgb)
+    {
+        emit_io(w, 0x4F, 0x01);
+        emit_copy(w, BENCHMARK_TILES_ADDR, 0x8000, 0x1800);
+        emit_copy(w, BENCHMARK_ATTR_ADDR, 0x9800, 0x0800);
+        emit_io(w, 0x4F, 0x00);
+        emit_palette(w, 0x68, BENCHMARK_BG_PALETTE_ADDR);
+        emit_palette(w, 0x6A, BENCHMARK_OBJ_PALETTE_ADDR);
+    }
+
+    emit_io(w, 0x47, 0xE4);
+    emit_io(w, 0x48, 0xE4);
+    emit_io(w, 0x49, 0x1B);
+    emit_copy(w, BENCHMARK_OAM_ADDR, 0xFE00, 160);
+
+    if (workload.audio)
+    {
+        emit_io(w, 0x26, 0x80);
+        emit_io(w, 0x24, 0x77);
+        emit_io(w, 0x25, 0xFF);
+        emit_io(w, 0x1A, 0x00);
+        emit_copy(w, BENCHMARK_WAVE_ADDR, 0xFF30, 16);
+    }
+
+    emit_io(w, 0x42, 0x00);
+    emit_io(w, 0x43, 0x00);
+    emit_io(w, 0x40, workload.sprites ? 0x97 : 0x91);
+    emit_io(w, 0xFF, 0x01);
+    emit_io(w, 0x0F, 0x00);
+    emit(w, 0xFB);
+
+    if (workload.sgb)
+    {
+        emit_sgb_packet(w, 0);
+        for (int packet = 1; packet < 4; packet++)
+        {
+            emit_sgb_packet(w, packet);
+            emit_wait_frames(w, 4);
+        }
+        emit_sgb_packet(w, 4);
+    }
+
+    // main: the same ALU and memory loop keeps the CPU busy in every workload
+    u16 main_loop = w.pc;
+    emit16(w, 0x21, 0xC100);
+    emit(w, 0x0E, 0x00);
+    u16 inner = w.pc;
+    emit(w, 0x7E);
+    emit(w, 0x81);
+    emit(w, 0x07);
+    emit(w, 0x22);
+    if (workload.audio)
+        emit(w, 0xE0, 0x13);
+    emit(w, 0x0D);
+    emit_jr(w, 0x20, inner);
+    emit_jr(w, 0x18, main_loop);
+
+    assert(w.pc <= BENCHMARK_VBLANK_ADDR);
+
+    w.pc = BENCHMARK_VBLANK_ADDR;
+    emit(w, 0xF5);
+    emit(w, 0xC5);
+    emit(w, 0xE5);
+
+    // SCX++, SCY--
+    emit(w, 0xF0, 0x43);
+    emit(w, 0x3C);
+    emit(w, 0xE0, 0x43);
+    emit(w, 0xF0, 0x42);
+    emit(w, 0x3D);
+    emit(w, 0xE0, 0x42);
+
+    if (workload.sprites)
+    {
+        // Move every sprite one pixel to the right
+        emit16(w, 0x21, 0xFE01);
+        emit(w, 0x06, 40);
+        u16 loop = w.pc;
+        emit(w, 0x34);
+        emit(w, 0x2C);
+        emit(w, 0x2C);
+        emit(w, 0x2C);
+        emit(w, 0x2C);
+        emit(w, 0x05);
+        emit_jr(w, 0x20, loop);
+    }
+
+    if (workload.hdma)
+    {
+        // 2 KB general purpose DMA to 0x8800, source moves with SCX
+        emit(w, 0xF0, 0x43);
+        emit(w, 0xE6, 0x07);
+        emit(w, 0xC6, 0x48);
+        emit(w, 0xE0, 0x51);
+        emit_io(w, 0x52, 0x00);
+        emit_io(w, 0x53, 0x08);
+        emit_io(w, 0x54, 0x00);
+        emit_io(w, 0x55, 0x7F);
+        // 2 KB HBlank DMA to 0x8000 during the next frame
+        emit(w, 0xF0, 0x43);
+        emit(w, 0xE6, 0x07);
+        emit(w, 0xC6, 0x40);
+        emit(w, 0xE0, 0x51);
+        emit_io(w, 0x52, 0x00);
+        emit_io(w, 0x53, 0x00);
+        emit_io(w, 0x54, 0x00);
+        emit_io(w, 0x55, 0xFF);
+    }
+
+    if (workload.audio)
+    {
+        emit_io(w, 0x10, 0x15);
+        emit_io(w, 0x11, 0x80);
+        emit_io(w, 0x12, 0xF3);
+        emit_io(w, 0x14, 0x87);
+        emit_io(w, 0x16, 0x40);
+        emit_io(w, 0x17, 0xF2);
+        emit(w, 0xF0, 0x43);
+        emit(w, 0xE0, 0x18);
+        emit_io(w, 0x19, 0x86);
+        emit_io(w, 0x1A, 0x80);
+        emit_io(w, 0x1B, 0x00);
+        emit_io(w, 0x1C, 0x20);
+        emit(w, 0xF0, 0x42);
+        emit(w, 0xE0, 0x1D);
+        emit_io(w, 0x1E, 0x87);
+        emit_io(w, 0x20, 0x00);
+        emit_io(w, 0x21, 0xF1);
+        emit_io(w, 0x22, 0x45);
+        emit_io(w, 0x23, 0x80);
+    }
+
+    emit(w, 0xE1);
+    emit(w, 0xC1);
+    emit(w, 0xF1);
+    emit(w, 0xD9);
+
+    assert(w.pc <= BENCHMARK_TILES_ADDR);
+}
+
+static u64 hash_bytes(u64 hash, const void* data, size_t size)
+{
+    const u8* bytes = (const u8*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= BENCHMARK_HASH_PRIME;
+    }
+    return hash;
+}
+
+static bool run_workload(const BenchmarkWorkload& workload, int frames, bool profile, bool no_render, bool no_audio, BenchmarkResult& result)
+{
+    u8* rom = new u8[BENCHMARK_ROM_SIZE];
+    build_rom(rom, workload);
+
+    GearboyCore* core = new GearboyCore();
+    core->Init();
+    core->SetSGBEnabled(workload.sgb);
+    core->SetSGBBorder(workload.sgb);
+
+    bool loaded = core->LoadROMFromBuffer(rom, BENCHMARK_ROM_SIZE, false);
+    SafeDeleteArray(rom);
+
+    if (!loaded)
+    {
+        SafeDelete(core);
+        return false;
+    }
+
+    u16* frame_buffer = new u16[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+    s16* sample_buffer = new s16[AUDIO_BUFFER_SIZE];
+    int sample_count = 0;
+
+    for (int i = 0; i < BENCHMARK_WARMUP_FRAMES; i++)
+        core->RunToVBlank(frame_buffer, sample_buffer, &sample_count);
+
+    // Timing every section costs a few clock reads per instruction,
+    // so profiled throughput is only comparable with other profiled runs
+    core->GetProfiler()->Enable(profile);
+
+    u64 start_instructions = core->GetProcessor()->GetInstructionCount();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // The last frame is always rendered so the hash stays comparable
+    s16* run_sample_buffer = no_audio ? NULL : sample_buffer;
+
+    for (int i = 0; i < frames; i++)
+    {
+        bool render = !no_render || (i == (frames - 1));
+        core->RunToVBlank(frame_buffer, run_sample_buffer, &sample_count, false, NULL, render);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    u64 instructions = core->GetProcessor()->GetInstructionCount() - start_instructions;
+
+    GB_RuntimeInfo runtime_info;
+    core->GetRuntimeInfo(runtime_info);
+
+    double seconds = elapsed.count();
+    result.workload = &workload;
+    result.frames = frames;
+    result.ms = seconds * 1000.0;
+    result.fps = seconds > 0.0 ? frames / seconds : 0.0;
+    result.instructions_per_second = seconds > 0.0 ? instructions / seconds : 0.0;
+    result.frame_hash = hash_bytes(BENCHMARK_HASH_SEED, frame_buffer,
+        (size_t)(runtime_info.screen_width * runtime_info.screen_height) * sizeof(u16));
+    result.profiled = profile;
+    result.profile = *core->GetProfiler()->GetTotals();
+
+    SafeDeleteArray(sample_buffer);
+    SafeDeleteArray(frame_buffer);
+    SafeDelete(core);
+    return true;
+}
+
+static void write_text(const std::vector<BenchmarkResult>& results, int frames)
+{
+    printf("%s %s benchmark, %s renderer, %d frames per workload\n\n", GEARBOY_TITLE, GEARBOY_VERSION, k_renderer, frames);
+    printf("%-12s %10s %10s %10s  %-16s  %s\n", "workload", "ms", "fps", "Minstr/s", "frame hash", "description");
+
+    double total_ms = 0.0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& r = results[i];
+        printf("%-12s %10.1f %10.1f %10.2f  %016llx  %s\n", r.workload->name, r.ms, r.fps,
+               r.instructions_per_second / 1000000.0, (unsigned long long)r.frame_hash, r.workload->description);
+        total_ms += r.ms;
+    }
+
+    printf("\nTotal: %.1f ms\n", total_ms);
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& r = results[i];
+        if (!r.profiled)
+            continue;
+
+        double frame_ns = (double)r.profile.sections[PROFILER_FRAME].time_ns;
+
+        printf("\n%s profile\n", r.workload->name);
+        printf("%-24s %12s %8s %14s\n", "section", "us/frame", "%", "calls/frame");
+
+        for (int s = 0; s < PROFILER_SECTION_COUNT; s++)
+        {
+            GB_Profiler_Section section = (GB_Profiler_Section)s;
+            const GB_Profiler_Counter& counter = r.profile.sections[s];
+            int depth = Profiler::GetSectionDepth(section);
+            printf("%*s%-*s %12.2f %8.1f %14.1f\n", depth * 2, "", 24 - (depth * 2), Profiler::GetSectionName(section),
+                   (double)counter.time_ns / 1000.0 / r.frames,
+                   frame_ns > 0.0 ? ((double)counter.time_ns * 100.0) / frame_ns : 0.0,
+                   (double)counter.calls / r.frames);
+        }
+    }
+}
+
+static void write_json(const std::vector<BenchmarkResult>& results, int frames)
+{
+    printf("{\n");
+    printf("  \"emulator\": \"%s %s\",\n", GEARBOY_TITLE, GEARBOY_VERSION);
+    printf("  \"renderer\": \"%s\",\n", k_renderer);
+    printf("  \"frames\": %d,\n", frames);
+    printf("  \"results\": [");
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& r = results[i];
+        printf("%s\n    { \"workload\": \"%s\", \"ms\": %.3f, \"fps\": %.1f, \"instructions_per_second\": %.0f, \"frame_hash\": \"%016llx\"",
+               i == 0 ? "" : ",", r.workload->name, r.ms, r.fps, r.instructions_per_second, (unsigned long long)r.frame_hash);
+
+        if (r.profiled)
+        {
+            printf(", \"profile_us_per_frame\": {");
+            for (int s = 0; s < PROFILER_SECTION_COUNT; s++)
+            {
+                printf("%s\"%s\": %.3f", s == 0 ? " " : ", ", Profiler::GetSectionName((GB_Profiler_Section)s),
+                       (double)r.profile.sections[s].time_ns / 1000.0 / r.frames);
+            }
+            printf(" }");
+        }
+
+        printf(" }");
+    }
+
+    printf("%s]\n}\n", results.empty() ? "" : "\n  ");
+}
+
+static void print_usage(const char* name)
+{
+    printf("Usage: %s [options] [workload ...]\n", name);
+    printf("Runs deterministic synthetic workloads through the core and reports throughput.\n\n");
+    printf("Options:\n");
+    printf("  -f, --frames <n>        Frames to run per workload (default: %d)\n", BENCHMARK_DEFAULT_FRAMES);
+    printf("  -j, --json              Print the report as JSON\n");
+    printf("  -p, --profile           Add a per-subsystem time breakdown (needs PROFILER=1)\n");
+    printf("  -n, --no-render         Skip pixel work on every frame but the last\n");
+    printf("  -a, --no-audio          Skip audio synthesis\n");
+    printf("  -h, --help              Display this help\n\n");
+    printf("Workloads:\n");
+    for (int i = 0; i < k_workload_count; i++)
+        printf("  %-22s  %s\n", k_workloads[i].name, k_workloads[i].description);
+}
+
+int main(int argc, char* argv[])
+{
+    // The core logs to stdout, keep it quiet so the report stays clean
+    Log_set_quiet(true);
+
+    int frames = BENCHMARK_DEFAULT_FRAMES;
+    bool json = false;
+    bool profile = false;
+    bool no_render = false;
+    bool no_audio = false;
+    std::vector<const BenchmarkWorkload*> selected;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+
+        if ((strcmp(arg, "-h") == 0) || (strcmp(arg, "--help") == 0))
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        else if ((strcmp(arg, "-j") == 0) || (strcmp(arg, "--json") == 0))
+            json = true;
+        else if ((strcmp(arg, "-p") == 0) || (strcmp(arg, "--profile") == 0))
+        {
+#if defined(GEARBOY_DISABLE_PROFILER)
+            fprintf(stderr, "The profiler is compiled out, rebuild with \"make PROFILER=1\" to use %s\n", arg);
+            return 2;
+#else
+            profile = true;
+#endif
+        }
+        else if ((strcmp(arg, "-n") == 0) || (strcmp(arg, "--no-render") == 0))
+            no_render = true;
+        else if ((strcmp(arg, "-a") == 0) || (strcmp(arg, "--no-audio") == 0))
+            no_audio = true;
+        else if ((strcmp(arg, "-f") == 0) || (strcmp(arg, "--frames") == 0))
+        {
+            char* end = NULL;
+            long value = (i + 1) < argc ? strtol(argv[++i], &end, 10) : 0;
+            if (!end || *end != '\0' || value < 1 || value > 0x7FFFFFFF)
+            {
+                fprintf(stderr, "Invalid value for %s\n", arg);
+                return 2;
+            }
+            frames = (int)value;
+        }
+        else if (arg[0] == '-')
+        {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            print_usage(argv[0]);
+            return 2;
+        }
+        else
+        {
+            const BenchmarkWorkload* workload = NULL;
+            for (int w = 0; w < k_workload_count; w++)
+            {
+                if (strcmp(arg, k_workloads[w].name) == 0)
+                    workload = &k_workloads[w];
+            }
+            if (!IsValidPointer(workload))
+            {
+                fprintf(stderr, "Unknown workload: %s\n", arg);
+                return 2;
+            }
+            selected.push_back(workload);
+        }
+    }
+
+    if (selected.empty())
+    {
+        for (int w = 0; w < k_workload_count; w++)
+            selected.push_back(&k_workloads[w]);
+    }
+
+    std::vector<BenchmarkResult> results;
+
+    for (size_t i = 0; i < selected.size(); i++)
+    {
+        BenchmarkResult result;
+        if (!run_workload(*selected[i], frames, profile, no_render, no_audio, result))
+        {
+            fprintf(stderr, "Unable to load workload: %s\n", selected[i]->name);
+            return 1;
+        }
+        results.push_back(result);
+    }
+
+    if (json)
+        write_json(results, frames);
+    else
+        write_text(results, frames);
+
+    return 0;
+}
@@ -0,0 +1,350 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include "gearboy.h"
+
+#define TESTS_ROM_SIZE 0x8000
+#define TESTS_FRAMES 120
+
+static int s_failures = 0;
+
+static void check(bool condition, const char* test, const char* message)
+{
+    if (!condition)
+    {
+        printf("FAIL %s: %s\n", test, message);
+        s_failures++;
+    }
+}
+
+// Entry point jumping to 0x0150 and a valid header
+static void build_rom_header(u8* rom, bool cgb)
+{
+    memset(rom, 0, TESTS_ROM_SIZE);
+
+    // NOP; JP 0x0150
+    rom[0x0100] = 0x00;
+    rom[0x0101] = 0xC3;
+    rom[0x0102] = 0x50;
+    rom[0x0103] = 0x01;
+
+    snprintf((char*)&rom[0x134], 11, "%s", "GBTESTS");
+
+    if (cgb)
+        rom[0x143] = 0x80;
+
+    u8 checksum = 0;
+    for (int i = 0x134; i < 0x14D; i++)
+        checksum = checksum - rom[i] - 1;
+    rom[0x14D] = checksum;
+}
+
+// DMG ROM that enables the VBlank interrupt and then loops on HALT; JR,
+// returns the address of the HALT instruction
+static u16 build_halt_loop_rom(u8* rom)
+{
+    build_rom_header(rom, false);
+
+    // VBlank vector: RETI
+    rom[0x0040] = 0xD9;
+
+    static const u8 k_code[] = {
+        0xF3,               // DI
+        0x31, 0xFE, 0xFF,   // LD SP,0xFFFE
+        0x3E, 0x01,         // LD A,0x01
+        0xE0, 0xFF,         // LDH (IE),A
+        0xAF,               // XOR A
+        0xE0, 0x0F,         // LDH (IF),A
+        0xFB,               // EI
+        0x76,               // HALT
+        0x18, 0xFD          // JR HALT
+    };
+
+    memcpy(&rom[0x0150], k_code, sizeof(k_code));
+
+    return 0x0150 + (u16)sizeof(k_code) - 3;
+}
+
+static bool run_halt_loop(bool halt_skip, u16* halt_address, u64* halt_cycles, u64* loop_cycles, u64* total_cycles)
+{
+    u8* rom = new u8[TESTS_ROM_SIZE];
+    *halt_address = build_halt_loop_rom(rom);
+
+    GearboyCore* core = new GearboyCore();
+    core->Init();
+    core->EnableHaltSkip(halt_skip);
+
+    bool loaded = core->LoadROMFromBuffer(rom, TESTS_ROM_SIZE, true);
+    SafeDeleteArray(rom);
+
+    if (!loaded)
+    {
+        SafeDelete(core);
+        return false;
+    }
+
+    u16* frame_buffer = new u16[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+    CodeProfiler* profiler = core->GetCodeProfiler();
+    profiler->Enable(true);
+
+    for (int i = 0; i < TESTS_FRAMES; i++)
+        core->RunToVBlank(frame_buffer, NULL, NULL, false, NULL, false);
+
+    const GB_Code_Profiler_Counter* halt = profiler->GetCounter(*halt_address, 0);
+    const GB_Code_Profiler_Counter* loop = profiler->GetCounter(*halt_address + 1, 0);
+    *halt_cycles = IsValidPointer(halt) ? halt->cycles : 0;
+    *loop_cycles = IsValidPointer(loop) ? loop->cycles : 0;
+    *total_cycles = profiler->GetTotalCycles();
+
+    SafeDeleteArray(frame_buffer);
+    SafeDelete(core);
+    return true;
+}
+
+// ROM that draws tile 0 with all four colors over the whole background.
+// On CGB it also loads background palette 0 with four distinct colors
+static void build_color_rom(u8* rom, bool cgb)
+{
+    build_rom_header(rom, cgb);
+
+    static const u8 k_code[] = {
+        0x21, 0x00, 0x80,   // LD HL,0x8000
+        0x06, 0x08,         // LD B,8
+        0x3E, 0x0F,         // LD A,0x0F
+        0x22,               // LD (HL+),A
+        0x3E, 0x33,         // LD A,0x33
+        0x22,               // LD (HL+),A
+        0x05,               // DEC B
+        0x20, 0xF7,         // JR NZ,-9
+        0x3E, 0xE4,         // LD A,0xE4
+        0xE0, 0x47,         // LDH (BGP),A
+        0x3E, 0x80,         // LD A,0x80
+        0xE0, 0x68,         // LDH (BCPS),A
+        0x21, 0x00, 0x02,   // LD HL,0x0200
+        0x06, 0x08,         // LD B,8
+        0x2A,               // LD A,(HL+)
+        0xE0, 0x69,         // LDH (BCPD),A
+        0x05,               // DEC B
+        0x20, 0xFA,         // JR NZ,-6
+        0x18, 0xFE          // JR -2
+    };
+
+    // White, a red, a green-blue and a dark purple in BGR555
+    static const u8 k_palette[] = { 0xFF, 0x7F, 0x1F, 0x10, 0xE0, 0x5E, 0x0A, 0x28 };
+
+    memcpy(&rom[0x0150], k_code, sizeof(k_code));
+    memcpy(&rom[0x0200], k_palette, sizeof(k_palette));
+}
+
+static bool run_color_rom(bool cgb, bool color_correction, GB_Color_Format format, void* frame_buffer)
+{
+    u8* rom = new u8[TESTS_ROM_SIZE];
+    build_color_rom(rom, cgb);
+
+    GearboyCore* core = new GearboyCore();
+    core->Init(format);
+    core->EnableColorCorrection(color_correction);
+
+    bool loaded = core->LoadROMFromBuffer(rom, TESTS_ROM_SIZE, !cgb);
+    SafeDeleteArray(rom);
+
+    if (loaded)
+    {
+        for (int i = 0; i < 10; i++)
+        {
+            if (Is32BitPixelFormat(format))
+                core->RunToVBlank(static_cast<u32*>(frame_buffer), NULL, NULL);
+            else
+                core->RunToVBlank(static_cast<u16*>(frame_buffer), NULL, NULL);
+        }
+    }
+
+    SafeDelete(core);
+    return loaded;
+}
+
+// Reads a pixel back following the layouts documented for GB_Color_Format,
+// returns false if the alpha byte is not opaque
+static bool unpack_color_32bit(u32 pixel, GB_Color_Format format, int* rgb)
+{
+    const u8* bytes = reinterpret_cast<const u8*>(&pixel);
+
+    switch (format)
+    {
+        case GB_PIXEL_RGBA8888:
+            rgb[0] = bytes[0];
+            rgb[1] = bytes[1];
+            rgb[2] = bytes[2];
+            return bytes[3] == 0xFF;
+        case GB_PIXEL_BGRA8888:
+            rgb[0] = bytes[2];
+            rgb[1] = bytes[1];
+            rgb[2] = bytes[0];
+            return bytes[3] == 0xFF;
+        default:
+            rgb[0] = (pixel >> 16) & 0xFF;
+            rgb[1] = (pixel >> 8) & 0xFF;
+            rgb[2] = pixel & 0xFF;
+            return true;
+    }
+}
+
+// 32-bit formats must show the same picture as RGB565, only with more
+// precision per channel, so every channel stays within one 565 step
+static void test_32bit_pixel_formats()
+{
+    const char* test = "32bit_pixel_formats";
+    const GB_Color_Format k_formats[] = { GB_PIXEL_RGBA8888, GB_PIXEL_BGRA8888, GB_PIXEL_XRGB8888 };
+    const int pixels = GAMEBOY_WIDTH * GAMEBOY_HEIGHT;
+
+    u16* frame_565 = new u16[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+    u32* frame_32 = new u32[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+
+    for (int mode = 0; mode < 3; mode++)
+    {
+        bool cgb = (mode > 0);
+        bool correction = (mode == 2);
+
+        check(run_color_rom(cgb, correction, GB_PIXEL_RGB565, frame_565), test, "the test ROM did not load");
+
+        int distinct = 1;
+        for (int i = 1; i < 8; i++)
+        {
+            if (frame_565[i] != frame_565[0])
+                distinct++;
+        }
+        check(distinct >= 4, test, "the test ROM does not draw four colors");
+
+        for (int f = 0; f < 3; f++)
+        {
+            run_color_rom(cgb, correction, k_formats[f], frame_32);
+
+            int mismatches = 0;
+            for (int i = 0; i < pixels; i++)
+            {
+                int expected[3];
+                expected[0] = (((frame_565[i] >> 11) & 0x1F) * 255) / 31;
+                expected[1] = (((frame_565[i] >> 5) & 0x3F) * 255) / 63;
+                expected[2] = ((frame_565[i] & 0x1F) * 255) / 31;
+
+                int actual[3];
+                bool matches = unpack_color_32bit(frame_32[i], k_formats[f], actual);
+
+                for (int c = 0; c < 3; c++)
+                {
+                    int diff = expected[c] - actual[c];
+                    if (diff < -8 || diff > 8)
+                        matches = false;
+                }
+
+                if (!matches)
+                    mismatches++;
+            }
+
+            check(mismatches == 0, test, cgb ? (correction ? "CGB corrected frame differs" : "CGB frame differs") : "DMG frame differs");
+        }
+    }
+
+    SafeDeleteArray(frame_565);
+    SafeDeleteArray(frame_32);
+}
+
+// Debugger views rebuild only when the write generations move, so they must
+// follow VRAM and palette writes and stay put while the game idles
+static void test_video_write_generations()
+{
+    const char* test = "video_write_generations";
+    u8* rom = new u8[TESTS_ROM_SIZE];
+    build_color_rom(rom, true);
+
+    GearboyCore* core = new GearboyCore();
+    core->Init();
+
+    bool loaded = core->LoadROMFromBuffer(rom, TESTS_ROM_SIZE, false);
+    SafeDeleteArray(rom);
+    check(loaded, test, "the test ROM did not load");
+
+    u16* frame_buffer = new u16[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+    Video* video = core->GetVideo();
+    u32 video_start = video->GetVideoDataGeneration();
+
+    for (int i = 0; i < 10; i++)
+        core->RunToVBlank(frame_buffer, NULL, NULL);
+
+    u32 video_drawn = video->GetVideoDataGeneration();
+    u32 oam_drawn = video->GetOAMGeneration();
+
+    for (int i = 0; i < 10; i++)
+        core->RunToVBlank(frame_buffer, NULL, NULL);
+
+    check(video_drawn != video_start, test, "VRAM and palette writes did not move the generation");
+    check(video->GetVideoDataGeneration() == video_drawn, test, "the generation moved while the game was idle");
+    check(video->GetOAMGeneration() == oam_drawn, test, "the OAM generation moved while the game was idle");
+
+    core->GetMemory()->Write(0xFE00, 0x10);
+    check(video->GetOAMGeneration() != oam_drawn, test, "an OAM write did not move the OAM generation");
+
+    SafeDeleteArray(frame_buffer);
+    SafeDelete(core);
+}
+
+// Idle time skipped by the halt fast path must still be charged to the
+// HALT instruction, exactly as when the CPU steps through it
+static void test_code_profiler_halt_skip()
+{
+    const char* test = "code_profiler_halt_skip";
+    u16 address = 0;
+    u64 stepped_halt = 0, stepped_loop = 0, stepped_total = 0;
+    u64 skipped_halt = 0, skipped_loop = 0, skipped_total = 0;
+
+    bool stepped = run_halt_loop(false, &address, &stepped_halt, &stepped_loop, &stepped_total);
+    bool skipped = run_halt_loop(true, &address, &skipped_halt, &skipped_loop, &skipped_total);
+
+    check(stepped && skipped, test, "the test ROM did not load");
+    check(stepped_halt > (stepped_total * 9) / 10, test, "the HALT loop is not idle most of the time");
+    check(skipped_halt == stepped_halt, test, "HALT cycles differ with halt skip enabled");
+    check(skipped_loop == stepped_loop, test, "JR cycles differ with halt skip enabled");
+    check(skipped_total == stepped_total, test, "total cycles differ with halt skip enabled");
+
+    printf("%s: HALT %llu/%llu cycles stepped, %llu/%llu skipped\n", test,
+           (unsigned long long)stepped_halt, (unsigned long long)stepped_total,
+           (unsigned long long)skipped_halt, (unsigned long long)skipped_total);
+}
+
+int main(int argc, char* argv[])
+{
+    UNUSED(argc);
+    UNUSED(argv);
+
+    // The core logs to stdout, keep it quiet so the results stay readable
+    Log_set_quiet(true);
+
+    test_code_profiler_halt_skip();
+    test_32bit_pixel_formats();
+    test_video_write_generations();
+
+    if (s_failures > 0)
+    {
+        printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include <algorithm>
+#include "input_script.h"
+
+struct InputScriptKeyName
+{
+    const char* name;
+    Gameboy_Keys key;
+};
+
+static const InputScriptKeyName k_input_script_keys[] = {
+    { "up", Up_Key },
+    { "down", Down_Key },
+    { "left", Left_Key },
+    { "right", Right_Key },
+    { "a", A_Key },
+    { "b", B_Key },
+    { "start", Start_Key },
+    { "select", Select_Key },
+};
+
+static bool parse_key(const char* name, Gameboy_Keys& key)
+{
+    for (size_t i = 0; i < sizeof(k_input_script_keys) / sizeof(k_input_script_keys[0]); i++)
+    {
+        if (strcmp(name, k_input_script_keys[i].name) == 0)
+        {
+            key = k_input_script_keys[i].key;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool compare_events(const InputScriptEvent& a, const InputScriptEvent& b)
+{
+    return a.frame < b.frame;
+}
+
+// Script format, one event per line:
+//   <frame> <press|release> <up|down|left|right|a|b|start|select>
+// Empty lines and lines starting with '#' are ignored.
+bool input_script_load(const char* path, InputScript& script, std::string& error)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        error = std::string("Unable to open input script: ") + path;
+        return false;
+    }
+
+    script.events.clear();
+
+    char line[256];
+    int line_number = 0;
+    bool success = true;
+
+    while (fgets(line, sizeof(line), file))
+    {
+        line_number++;
+
+        char* p = line;
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0')
+            continue;
+
+        int frame = 0;
+        char action[16];
+        char key_name[16];
+        InputScriptEvent event = {};
+
+        if (sscanf(p, "%d %15s %15s", &frame, action, key_name) != 3 || frame < 0)
+            success = false;
+        else if (strcmp(action, "press") == 0)
+            event.pressed = true;
+        else if (strcmp(action, "release") == 0)
+            event.pressed = false;
+        else
+            success = false;
+
+        if (success && !parse_key(key_name, event.key))
+            success = false;
+
+        if (!success)
+        {
+            char message[64];
+            snprintf(message, sizeof(message), "Invalid input script line %d: ", line_number);
+            error = std::string(message) + path;
+            break;
+        }
+
+        event.frame = frame;
+        script.events.push_back(event);
+    }
+
+    fclose(file);
+
+    std::stable_sort(script.events.begin(), script.events.end(), compare_events);
+    return success;
+}
@@ -0,0 +1,41 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include <string>
+#include <vector>
+#include "gearboy.h"
+
+struct InputScriptEvent
+{
+    int frame;
+    bool pressed;
+    Gameboy_Keys key;
+};
+
+struct InputScript
+{
+    std::vector<InputScriptEvent> events;
+};
+
+bool input_script_load(const char* path, InputScript& script, std::string& error);
+
+#endif /* INPUT_SCRIPT_H */
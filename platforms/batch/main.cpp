@@ -0,0 +1,252 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include <chrono>
+#include "gearboy.h"
+#include "batch_runner.h"
+#include "input_script.h"
+#include "thread_pool.h"
+
+static void print_usage(const char* name)
+{
+    printf("Usage: %s [options] [rom_file ...]\n", name);
+    printf("Runs every ROM headless at unlimited speed and prints a JSON report.\n\n");
+    printf("Options:\n");
+    printf("  -f, --frames <n>        Frames to run per ROM (default: 600)\n");
+    printf("  -l, --list <file>       Read ROM paths from a file, one per line\n");
+    printf("  -i, --input <file>      Input script: '<frame> <press|release> <key>' per line\n");
+    printf("  -m, --model <model>     auto, dmg, sgb or gba (default: auto)\n");
+    printf("  -e, --hash-every <n>    Also report the frame hash every n frames\n");
+    printf("  -j, --jobs <n>          Run up to n ROMs in parallel, 0 uses all threads (default: 1)\n");
+    printf("  -s, --scaling <n>       Benchmark n parallel instances against the thread count\n");
+    printf("  -o, --output <file>     Write the report to a file instead of stdout\n");
+    printf("  -v, --version           Display version information\n");
+    printf("  -h, --help              Display this help\n");
+}
+
+static bool read_rom_list(const char* path, std::vector<std::string>& roms)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return false;
+
+    char line[4096];
+    while (fgets(line, sizeof(line), file))
+    {
+        size_t length = strlen(line);
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r' || line[length - 1] == ' ' || line[length - 1] == '\t'))
+            line[--length] = '\0';
+
+        const char* p = line;
+        while (*p == ' ' || *p == '\t')
+            p++;
+
+        if (*p == '\0' || *p == '#')
+            continue;
+
+        roms.push_back(p);
+    }
+
+    fclose(file);
+    return true;
+}
+
+static bool parse_int(const char* text, int min, int* value)
+{
+    char* end = NULL;
+    long parsed = strtol(text, &end, 10);
+    if (!end || *end != '\0' || parsed < min || parsed > 0x7FFFFFFF)
+        return false;
+    *value = (int)parsed;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    // The core logs to stdout, keep it quiet so the JSON report stays clean
+    Log_set_quiet(true);
+
+    BatchOptions options;
+    batch_options_default(options);
+
+    std::vector<std::string> roms;
+    InputScript input;
+    const char* output_path = NULL;
+    int jobs = 1;
+    int scaling_instances = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        bool has_value = (i + 1) < argc;
+
+        if ((strcmp(arg, "-h") == 0) || (strcmp(arg, "--help") == 0))
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        else if ((strcmp(arg, "-v") == 0) || (strcmp(arg, "--version") == 0))
+        {
+            printf("%s Batch Runner\n", GEARBOY_TITLE);
+            printf("Build: %s\n", GEARBOY_VERSION);
+            printf("Author: Ignacio Sanchez (drhelius)\n");
+            return 0;
+        }
+        else if ((strcmp(arg, "-f") == 0) || (strcmp(arg, "--frames") == 0))
+        {
+            if (!has_value || !parse_int(argv[++i], 1, &options.frames))
+            {
+                fprintf(stderr, "Invalid value for %s\n", arg);
+                return 2;
+            }
+        }
+        else if ((strcmp(arg, "-e") == 0) || (strcmp(arg, "--hash-every") == 0))
+        {
+            if (!has_value || !parse_int(argv[++i], 0, &options.hash_interval))
+            {
+                fprintf(stderr, "Invalid value for %s\n", arg);
+                return 2;
+            }
+        }
+        else if ((strcmp(arg, "-j") == 0) || (strcmp(arg, "--jobs") == 0))
+        {
+            if (!has_value || !parse_int(argv[++i], 0, &jobs))
+            {
+                fprintf(stderr, "Invalid value for %s\n", arg);
+                return 2;
+            }
+        }
+        else if ((strcmp(arg, "-s") == 0) || (strcmp(arg, "--scaling") == 0))
+        {
+            if (!has_value || !parse_int(argv[++i], 1, &scaling_instances))
+            {
+                fprintf(stderr, "Invalid value for %s\n", arg);
+                return 2;
+            }
+        }
+        else if ((strcmp(arg, "-l") == 0) || (strcmp(arg, "--list") == 0))
+        {
+            if (!has_value || !read_rom_list(argv[++i], roms))
+            {
+                fprintf(stderr, "Unable to read ROM list for %s\n", arg);
+                return 2;
+            }
+        }
+        else if ((strcmp(arg, "-i") == 0) || (strcmp(arg, "--input") == 0))
+        {
+            std::string error;
+            if (!has_value)
+            {
+                fprintf(stderr, "Missing value for %s\n", arg);
+                return 2;
+            }
+            if (!input_script_load(argv[++i], input, error))
+            {
+                fprintf(stderr, "%s\n", error.c_str());
+                return 2;
+            }
+            options.input = &input;
+        }
+        else if ((strcmp(arg, "-m") == 0) || (strcmp(arg, "--model") == 0))
+        {
+            const char* model = has_value ? argv[++i] : "";
+            if (strcmp(model, "auto") == 0)
+                options.model = Batch_Model_Auto;
+            else if (strcmp(model, "dmg") == 0)
+                options.model = Batch_Model_DMG;
+            else if (strcmp(model, "sgb") == 0)
+                options.model = Batch_Model_SGB;
+            else if (strcmp(model, "gba") == 0)
+                options.model = Batch_Model_GBA;
+            else
+            {
+                fprintf(stderr, "Invalid value for %s\n", arg);
+                return 2;
+            }
+        }
+        else if ((strcmp(arg, "-o") == 0) || (strcmp(arg, "--output") == 0))
+        {
+            if (!has_value)
+            {
+                fprintf(stderr, "Missing value for %s\n", arg);
+                return 2;
+            }
+            output_path = argv[++i];
+        }
+        else if (arg[0] == '-')
+        {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            print_usage(argv[0]);
+            return 2;
+        }
+        else
+            roms.push_back(arg);
+    }
+
+    if (roms.empty())
+    {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    FILE* file = stdout;
+    if (IsValidPointer(output_path))
+    {
+        file = fopen(output_path, "w");
+        if (!file)
+        {
+            fprintf(stderr, "Unable to create output file: %s\n", output_path);
+            return 2;
+        }
+    }
+
+    if (scaling_instances > 0)
+    {
+        bool success = batch_run_scaling(file, roms, options, scaling_instances);
+        if (file != stdout)
+            fclose(file);
+        return success ? 0 : 1;
+    }
+
+    if (jobs == 0)
+        jobs = ThreadPool::GetHardwareThreads();
+
+    std::vector<BatchResult> results(roms.size());
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    ThreadPool pool(MIN(jobs, (int)roms.size()));
+    pool.ParallelFor((int)roms.size(), [&](int index) {
+        batch_run_rom(roms[index].c_str(), options, results[index]);
+    });
+
+    std::chrono::duration<double, std::milli> total = std::chrono::steady_clock::now() - start;
+
+    batch_write_json(file, options, results, total.count());
+
+    if (file != stdout)
+        fclose(file);
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (!results[i].success)
+            return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include "thread_pool.h"
+
+// The calling thread acts as worker 0, so only threads - 1 are spawned
+ThreadPool::ThreadPool(int threads)
+{
+    m_thread_count = threads < 1 ? 1 : threads;
+    m_workers = new Worker[m_thread_count];
+    m_task = NULL;
+    m_pending = 0;
+    m_generation = 0;
+    m_exit = false;
+
+    for (int i = 1; i < m_thread_count; i++)
+        m_threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exit = true;
+    }
+    m_wake.notify_all();
+
+    for (size_t i = 0; i < m_threads.size(); i++)
+        m_threads[i].join();
+
+    delete[] m_workers;
+}
+
+int ThreadPool::GetThreadCount() const
+{
+    return m_thread_count;
+}
+
+int ThreadPool::GetHardwareThreads()
+{
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads > 0 ? (int)threads : 1;
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& task)
+{
+    if (count <= 0)
+        return;
+
+    if (m_thread_count == 1)
+    {
+        for (int i = 0; i < count; i++)
+            task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Publish the task before any index becomes visible to a running worker
+        m_task = &task;
+        m_pending = count;
+
+        for (int i = 0; i < count; i++)
+        {
+            Worker& worker = m_workers[i % m_thread_count];
+            std::lock_guard<std::mutex> worker_lock(worker.mutex);
+            worker.queue.push_back(i);
+        }
+
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    while (RunNext(0)) { }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending.load() == 0; });
+    m_task = NULL;
+}
+
+void ThreadPool::WorkerLoop(int id)
+{
+    unsigned int generation = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, generation] { return m_exit || m_generation != generation; });
+            if (m_exit)
+                return;
+            generation = m_generation;
+        }
+
+        while (RunNext(id)) { }
+    }
+}
+
+bool ThreadPool::RunNext(int id)
+{
+    int index;
+    if (!PopLocal(id, index) && !Steal(id, index))
+        return false;
+
+    (*m_task)(index);
+
+    if (m_pending.fetch_sub(1) == 1)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done.notify_all();
+    }
+    return true;
+}
+
+// Owners take work from the back of their queue, thieves from the front
+bool ThreadPool::PopLocal(int id, int& index)
+{
+    Worker& worker = m_workers[id];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.queue.empty())
+        return false;
+    index = worker.queue.back();
+    worker.queue.pop_back();
+    return true;
+}
+
+bool ThreadPool::Steal(int id, int& index)
+{
+    for (int i = 1; i < m_thread_count; i++)
+    {
+        Worker& victim = m_workers[(id + i) % m_thread_count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.queue.empty())
+            continue;
+        index = victim.queue.front();
+        victim.queue.pop_front();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,65 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    ThreadPool(int threads);
+    ~ThreadPool();
+    int GetThreadCount() const;
+    void ParallelFor(int count, const std::function<void(int)>& task);
+    static int GetHardwareThreads();
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<int> queue;
+    };
+
+    void WorkerLoop(int id);
+    bool RunNext(int id);
+    bool PopLocal(int id, int& index);
+    bool Steal(int id, int& index);
+
+private:
+    int m_thread_count;
+    Worker* m_workers;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(int)>* m_task;
+    std::atomic<int> m_pending;
+    unsigned int m_generation;
+    bool m_exit;
+};
+
+#endif /* THREAD_POOL_H */
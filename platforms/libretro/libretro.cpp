@@ -45,7 +45,22 @@ static const char slash = '\\';
 static const char slash = '/';
 #endif
 
-static u16* gearboy_frame_buf;
+// The core writes XRGB8888 straight into the frontend buffer, PS2 keeps its
+// native BGR555 output
+#ifdef PS2
+typedef u16 gearboy_pixel_t;
+#define GEARBOY_PIXEL_FORMAT GB_PIXEL_BGR555
+#define GEARBOY_RETRO_PIXEL_FORMAT RETRO_PIXEL_FORMAT_RGB565
+#else
+typedef u32 gearboy_pixel_t;
+#define GEARBOY_PIXEL_FORMAT GB_PIXEL_XRGB8888
+#define GEARBOY_RETRO_PIXEL_FORMAT RETRO_PIXEL_FORMAT_XRGB8888
+#endif
+
+static gearboy_pixel_t* gearboy_frame_buf;
+static gearboy_pixel_t* gearboy_last_frame_buf;
+static int last_frame_width = 0;
+static int last_frame_height = 0;
 
 static struct retro_log_callback logging;
 retro_log_printf_t log_cb;
@@ -66,6 +81,7 @@ static bool bootrom_dmg = false;
 static bool bootrom_gbc = false;
 static bool color_correction = true;
 static bool libretro_supports_bitmasks = false;
+static bool libretro_supports_dupe = false;
 static bool categories_supported = false;
 static unsigned input_device = RETRO_DEVICE_GAMEBOY;
 static float libretro_tilt_x = 0.0f;
@@ -145,28 +161,32 @@ void retro_init(void)
 
     core = new GearboyCore();
 
-#ifdef PS2
-    core->Init(GB_PIXEL_BGR555);
-#else
-    core->Init(GB_PIXEL_RGB565);
-#endif
+    core->Init(GEARBOY_PIXEL_FORMAT);
 
-    gearboy_frame_buf = new u16[VIDEO_WIDTH * VIDEO_HEIGHT];
+    gearboy_frame_buf = new gearboy_pixel_t[VIDEO_WIDTH * VIDEO_HEIGHT];
+    gearboy_last_frame_buf = new gearboy_pixel_t[VIDEO_WIDTH * VIDEO_HEIGHT];
+    last_frame_width = 0;
+    last_frame_height = 0;
 
     audio_sample_count = 0;
     libretro_supports_bitmasks = environ_cb(RETRO_ENVIRONMENT_GET_INPUT_BITMASKS, NULL);
 
+    bool can_dupe = false;
+    libretro_supports_dupe = environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &can_dupe) && can_dupe;
+
     apply_controller_device(0, input_device, false);
 }
 
 void retro_deinit(void)
 {
     SafeDeleteArray(gearboy_frame_buf);
+    SafeDeleteArray(gearboy_last_frame_buf);
     SafeDelete(core);
     vfs_interface = NULL;
 
     audio_sample_count = 0;
     libretro_supports_bitmasks = false;
+    libretro_supports_dupe = false;
     libretro_tilt_x = 0.0f;
     libretro_tilt_y = 0.0f;
 
@@ -873,6 +893,39 @@ static void check_variables(void)
     }
 }
 
+static void present_frame(bool video_enabled)
+{
+    GB_RuntimeInfo rt_info;
+    core->GetRuntimeInfo(rt_info);
+    int width = rt_info.screen_width;
+    int height = rt_info.screen_height;
+    size_t pitch = width * sizeof(gearboy_pixel_t);
+
+    if (!libretro_supports_dupe)
+    {
+        video_cb((uint8_t*)gearboy_frame_buf, width, height, pitch);
+        return;
+    }
+
+    // Static screens, paused games and skipped frames are passed as dupes,
+    // so the frontend doesn't upload the same texture again
+    bool dupe = !video_enabled ||
+        ((width == last_frame_width) && (height == last_frame_height) &&
+        (memcmp(gearboy_frame_buf, gearboy_last_frame_buf, pitch * height) == 0));
+
+    if (dupe)
+    {
+        video_cb(NULL, width, height, pitch);
+        return;
+    }
+
+    memcpy(gearboy_last_frame_buf, gearboy_frame_buf, pitch * height);
+    last_frame_width = width;
+    last_frame_height = height;
+
+    video_cb((uint8_t*)gearboy_frame_buf, width, height, pitch);
+}
+
 void retro_run(void)
 {
     bool updated = false;
@@ -885,13 +938,20 @@ void retro_run(void)
 
     update_input();
 
-    core->RunToVBlank(gearboy_frame_buf, audio_buf, &audio_sample_count, false, NULL);
+    // Run-ahead and preemptive frames discard the output of most frames,
+    // so the PPU skips pixel work and the APU skips synthesis for them
+    int av_enable = RETRO_AV_ENABLE_VIDEO | RETRO_AV_ENABLE_AUDIO;
+    if (!environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av_enable))
+        av_enable = RETRO_AV_ENABLE_VIDEO | RETRO_AV_ENABLE_AUDIO;
 
-    GB_RuntimeInfo rt_info;
-    core->GetRuntimeInfo(rt_info);
-    video_cb((uint8_t*)gearboy_frame_buf, rt_info.screen_width, rt_info.screen_height, rt_info.screen_width * sizeof(u16));
+    bool video_enabled = (av_enable & RETRO_AV_ENABLE_VIDEO) != 0;
+    bool audio_enabled = (av_enable & RETRO_AV_ENABLE_AUDIO) != 0;
+
+    core->RunToVBlank(gearboy_frame_buf, audio_enabled ? audio_buf : NULL, &audio_sample_count, false, NULL, video_enabled);
+
+    present_frame(video_enabled);
 
-    if (audio_sample_count > 0)
+    if (audio_enabled && (audio_sample_count > 0))
         audio_batch_cb(audio_buf, audio_sample_count / 2);
 
     audio_sample_count = 0;
@@ -914,6 +974,8 @@ void retro_reset(void)
 bool retro_load_game(const struct retro_game_info *info)
 {
     core->GetCartridge()->Reset();
+    last_frame_width = 0;
+    last_frame_height = 0;
     environ_cb(RETRO_ENVIRONMENT_GET_SENSOR_INTERFACE, &sensor_interface);
     check_variables();
     load_bootroms();
@@ -942,11 +1004,11 @@ bool retro_load_game(const struct retro_game_info *info)
 
     environ_cb(RETRO_ENVIRONMENT_SET_INPUT_DESCRIPTORS, desc);
 
-    enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_RGB565;
+    enum retro_pixel_format fmt = GEARBOY_RETRO_PIXEL_FORMAT;
     
     if (!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
     {
-        log_cb(RETRO_LOG_INFO, "RETRO_PIXEL_FORMAT_RGB565 is not supported.\n");
+        log_cb(RETRO_LOG_INFO, "The frontend does not support the required pixel format.\n");
         return false;
     }
 
@@ -161,6 +161,7 @@ int application_init(const ApplicationParams& params)
 
 void application_destroy(void)
 {
+    emu_stop_thread();
     save_window_size();
     ogl_renderer_destroy();
     ImGui_ImplSDL3_Shutdown();
@@ -178,12 +179,14 @@ void application_mainloop(void)
     while (running)
     {
         display_begin_frame();
+        emu_lock_core();
         sdl_events();
         handle_mouse_cursor();
         handle_menu();
         handle_single_instance();
         run_emulator();
         display_render();
+        emu_unlock_core();
         display_frame_throttle();
     }
 }
@@ -30,6 +30,7 @@
 #include "ini.h"
 
 #include "utils.h"
+#include "rewind.h"
 
 static mINI::INIFile* config_ini_file = NULL;
 static mINI::INIStructure config_ini_data;
@@ -68,6 +68,7 @@ struct config_Emulator
     bool ffwd;
     int ffwd_speed;
     int runahead;
+    bool emulation_thread;
     bool show_info;
     int mbc;
     std::string recent_roms[config_max_recent_roms];
@@ -135,6 +136,7 @@ struct config_Rewind
     int buffer_seconds;
     int frames_per_snapshot;
     float speed;
+    int memory_budget_mb;
 };
 
 struct config_Input
@@ -226,6 +228,7 @@ struct config_Debug
     bool show_psg;
     bool show_trace_logger;
     bool show_rewind;
+    bool show_profiler;
     bool show_sgb_state;
     bool show_sgb_video;
     bool show_sgb_palettes;
@@ -256,6 +259,7 @@ struct config_Debug
     int trace_capacity;
     int trace_disk_dir_option;
     int trace_disk_size;
+    int trace_disk_format;
     std::string trace_disk_path;
     bool dis_show_mem;
     bool dis_show_symbols;
@@ -263,6 +267,8 @@ struct config_Debug
     bool dis_show_bank;
     bool dis_show_auto_symbols;
     bool dis_dim_auto_symbols;
+    bool dis_show_heat;
+    bool dis_code_profiler;
     bool dis_replace_symbols;
     bool dis_replace_labels;
     int dis_syntax;
@@ -45,6 +45,7 @@ static inline void process(config_Operation operation)
     CONFIG_BOOL("Debug", "PSG", config_debug.show_psg, false);
     CONFIG_BOOL("Debug", "TraceLogger", config_debug.show_trace_logger, false);
     CONFIG_BOOL("Debug", "Rewind", config_debug.show_rewind, false);
+    CONFIG_BOOL("Debug", "Profiler", config_debug.show_profiler, false);
     CONFIG_BOOL("Debug", "SGBState", config_debug.show_sgb_state, false);
     CONFIG_BOOL("Debug", "SGBVideo", config_debug.show_sgb_video, false);
     CONFIG_BOOL("Debug", "SGBPalettes", config_debug.show_sgb_palettes, false);
@@ -74,9 +75,10 @@ static inline void process(config_Operation operation)
     CONFIG_INT_RANGE("Debug", "TraceSerialEvents", config_debug.trace_serial_events, TRACE_SERIAL_FILTER_ALL, 0, TRACE_SERIAL_FILTER_ALL);
     CONFIG_INT_RANGE("Debug", "TraceMapperEvents", config_debug.trace_mapper_events, TRACE_MAPPER_FILTER_ALL, 0, TRACE_MAPPER_FILTER_ALL);
     CONFIG_INT_RANGE("Debug", "TraceOutput", config_debug.trace_output, 0, 0, 1);
-    CONFIG_INT_RANGE("Debug", "TraceCapacity", config_debug.trace_capacity, 0, 0, 4);
+    CONFIG_INT_RANGE("Debug", "TraceCapacity", config_debug.trace_capacity, 0, 0, 6);
     CONFIG_INT_RANGE("Debug", "TraceDiskDirOption", config_debug.trace_disk_dir_option, 0, 0, 2);
     CONFIG_INT_RANGE("Debug", "TraceDiskSize", config_debug.trace_disk_size, 2, 0, 6);
+    CONFIG_INT_RANGE("Debug", "TraceDiskFormat", config_debug.trace_disk_format, 0, 0, 1);
     CONFIG_STRING_NOT_EMPTY("Debug", "TraceDiskPath", config_debug.trace_disk_path, config_root_path);
 
     // Disassembler
@@ -86,6 +88,8 @@ static inline void process(config_Operation operation)
     CONFIG_BOOL("Debug", "DisBank", config_debug.dis_show_bank, true);
     CONFIG_BOOL("Debug", "DisAutoSymbols", config_debug.dis_show_auto_symbols, true);
     CONFIG_BOOL("Debug", "DisDimAutoSymbols", config_debug.dis_dim_auto_symbols, false);
+    CONFIG_BOOL("Debug", "DisHeat", config_debug.dis_show_heat, false);
+    CONFIG_BOOL("Debug", "DisCodeProfiler", config_debug.dis_code_profiler, false);
     CONFIG_BOOL("Debug", "DisReplaceSymbols", config_debug.dis_replace_symbols, true);
     CONFIG_BOOL("Debug", "DisReplaceLabels", config_debug.dis_replace_labels, true);
     CONFIG_INT_RANGE("Debug", "DisSyntax", config_debug.dis_syntax, GB_Disassembler_Syntax_Gearboy, GB_Disassembler_Syntax_Gearboy, GB_Disassembler_Syntax_Count - 1);
@@ -128,6 +132,7 @@ static inline void process(config_Operation operation)
     // Emulation
     CONFIG_INT("Emulator", "FFWD", config_emulator.ffwd_speed, 1);
     CONFIG_INT_RANGE("Emulator", "RunAhead", config_emulator.runahead, 0, 0, 3);
+    CONFIG_BOOL("Emulator", "EmulationThread", config_emulator.emulation_thread, false);
     CONFIG_INT_RANGE("Emulator", "SaveSlot", config_emulator.save_slot, 0, 0, 4);
     CONFIG_BOOL("Emulator", "StartPaused", config_emulator.start_paused, false);
     CONFIG_BOOL("Emulator", "PauseWhenInactive", config_emulator.pause_when_inactive, true);
@@ -257,9 +262,10 @@ static inline void process(config_Operation operation)
     //**************************************
 
     CONFIG_BOOL("Rewind", "Enabled", config_rewind.enabled, true);
-    CONFIG_INT("Rewind", "BufferSeconds", config_rewind.buffer_seconds, 10);
+    CONFIG_INT("Rewind", "BufferSeconds", config_rewind.buffer_seconds, 60);
     CONFIG_INT("Rewind", "FramesPerSnapshot", config_rewind.frames_per_snapshot, 1);
     CONFIG_FLOAT("Rewind", "Speed", config_rewind.speed, 2.0f);
+    CONFIG_INT_RANGE("Rewind", "MemoryBudgetMB", config_rewind.memory_budget_mb, 64, REWIND_MIN_BUDGET_MB, REWIND_MAX_BUDGET_MB);
 
     //**************************************
     // Input
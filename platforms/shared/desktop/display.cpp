@@ -62,42 +62,52 @@ void display_frame_throttle(void)
 {
     frame_time_end = SDL_GetPerformanceCounter();
 
-    if (emu_is_empty() || emu_is_paused() || emu_is_debug_idle() || !emu_is_audio_open() || config_emulator.ffwd)
+    // The emulation thread paces itself, the main loop only has to keep
+    // up with the display
+    bool threaded = emu_is_threaded();
+
+    emu_lock_core();
+    bool throttle = threaded || emu_is_empty() || emu_is_paused() || emu_is_debug_idle() || !emu_is_audio_open() || config_emulator.ffwd;
+    emu_unlock_core();
+
+    if (throttle)
     {
         Uint64 count_per_sec = SDL_GetPerformanceFrequency();
         float elapsed = (float)(frame_time_end - frame_time_start) / (float)count_per_sec;
         elapsed *= 1000.0f;
 
-        float min = 16.666f;
-
-        if (config_emulator.ffwd)
-        {
-            switch (config_emulator.ffwd_speed)
-            {
-                case 0:
-                    min = 16.666f / 1.5f;
-                    break;
-                case 1: 
-                    min = 16.666f / 2.0f;
-                    break;
-                case 2:
-                    min = 16.666f / 2.5f;
-                    break;
-                case 3:
-                    min = 16.666f / 3.0f;
-                    break;
-                default:
-                    min = 0.0f;
-            }
-        }
+        float min = threaded ? 16.666f : display_get_frame_time();
 
         if (elapsed < min)
             SDL_Delay((Uint32)(min - elapsed));
     }
 }
 
+float display_get_frame_time(void)
+{
+    if (!config_emulator.ffwd)
+        return 16.666f;
+
+    switch (config_emulator.ffwd_speed)
+    {
+        case 0:
+            return 16.666f / 1.5f;
+        case 1:
+            return 16.666f / 2.0f;
+        case 2:
+            return 16.666f / 2.5f;
+        case 3:
+            return 16.666f / 3.0f;
+        default:
+            return 0.0f;
+    }
+}
+
 bool display_should_run_emu_frame(void)
 {
+    if (emu_is_threaded())
+        return true;
+
     if (config_video.sync_mode != config_VideoSync_Disabled && !emu_is_empty() && !emu_is_paused()
         && !emu_is_debug_idle() && emu_is_audio_open() && !config_emulator.ffwd)
     {
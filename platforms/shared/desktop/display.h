@@ -34,6 +34,7 @@ EXTERN void display_begin_frame(void);
 EXTERN void display_render(void);
 EXTERN void display_frame_throttle(void);
 EXTERN bool display_should_run_emu_frame(void);
+EXTERN float display_get_frame_time(void);
 EXTERN void display_use_vsync_if_enabled(void);
 EXTERN void display_disable_vsync(void);
 EXTERN void display_update_frame_pacing(void);
@@ -22,12 +22,14 @@
 #include <string.h>
 #include <thread>
 #include <atomic>
+#include <mutex>
 #include "gearboy.h"
 #include "sound_queue.h"
 #include "config.h"
 #include "rewind.h"
 #include "runahead.h"
 #include "events.h"
+#include "display.h"
 #include "gui_debug_trace_logger.h"
 #include "mcp/mcp_manager.h"
 
@@ -45,7 +47,6 @@ static GB_Color soft_palette[4] = {{0xE0,0xE0,0xAA},{0xB0,0xB8,0x7C},{0x72,0x82,
 static GB_Color slime_palette[4] = {{0xD4,0xEB,0xA5},{0x62,0xB8,0x7C},{0x27,0x76,0x5D},{0x1D,0x39,0x39}};
 
 static GearboyCore* gearboy;
-static u16* frame_buffer_565;
 static s16* audio_buffer;
 static bool audio_enabled;
 static McpManager* mcp_manager;
@@ -73,33 +74,112 @@ static bool loading_force_dmg;
 static Cartridge::CartridgeTypes loading_mbc;
 static bool loading_force_gba;
 static int dmg_palette_override = -1;
+static u8 color_5_to_8[32];
+static u8 color_6_to_8[64];
+
+// Everything the VRAM viewers are built from. VRAM, palettes and LCDC come
+// in through the core write generation. OAM only affects the sprite view
+// and is tracked on its own
+struct debug_video_state
+{
+    u32 video_data_generation;
+    u16 dmg_internal_palette[4];
+    int background_tile_address;
+    int background_map_address;
+    int tile_dmg_palette;
+    int tile_color_palette;
+    bool background_is_window;
+    bool cgb;
+};
+
+static debug_video_state debug_video_current;
+static debug_video_state debug_video_last;
+static u32 debug_oam_generation_last;
+static bool debug_background_dirty = true;
+static bool debug_tiles_dirty = true;
+static bool debug_oam_dirty = true;
+
+// The emulation thread runs frames at its own pace. The main loop only
+// holds the core while it handles events and builds the GUI, and picks up
+// the newest finished frame from a triple buffer without waiting for it
+static std::thread emu_thread;
+static std::mutex core_mutex;
+static std::atomic<int> core_lock_requests(0);
+static std::atomic<bool> emu_thread_quit(false);
+static bool emu_thread_active = false;
+static bool core_locked = false;
+static s16* emu_thread_audio_buffer;
+static u32* frame_slots[3];
+static int frame_slot_sizes[3];
+static int frame_slot_back = 0;
+static int frame_slot_front = 2;
+
+// Slot shared by both threads, FRAME_SLOT_FRESH is set while it holds a
+// frame the main loop has not picked up yet
+#define FRAME_SLOT_FRESH 4
+static std::atomic<int> frame_slot_shared(1);
+
+// Key changes made while the emulation thread runs, applied before its next
+// frame. Always drained with the core lock held
+#define KEY_QUEUE_SIZE 64
+#define KEY_QUEUE_PRESSED 0x100
+static u16 key_queue[KEY_QUEUE_SIZE];
+static std::atomic<u32> key_queue_read(0);
+static std::atomic<u32> key_queue_write(0);
+
+// Both threads write to the sound queue, which takes a single producer
+static std::mutex audio_mutex;
 
 static void save_ram(void);
 static void load_ram(void);
 static void reset_buffers(void);
+static void init_24bit_lut(void);
 static void generate_24bit_buffer(GB_Color* dest, u16* src, int size);
 static void apply_dmg_palette_override(void);
 static const char* get_mbc(Cartridge::CartridgeTypes type);
 static void init_debug(void);
 static void update_debug(void);
+static void update_debug_dirty_flags(void);
 static void debug_step_instruction(void);
 static void update_debug_background_buffer(void);
 static void update_debug_tile_buffers(void);
 static void update_debug_oam_buffers(void);
 static void reset_rewind_timing(void);
 static int get_rewind_pop_budget(void);
+static int run_frame(u32* frame_buffer, s16* samples);
+static bool run_debug_frame(u32* frame_buffer, s16* samples, int* sample_count, bool* frame_completed);
+static void end_frame(bool frame_completed);
+static void write_audio(s16* samples, int count, bool sync);
+static void update_emu_thread(void);
+static void emu_thread_func(void);
+static bool emu_thread_can_run(void);
+static void emu_thread_pace(Uint64* next_frame, float frame_time);
+static void publish_frame(int size);
+static void collect_frame(void);
+static void queue_key(Gameboy_Keys key, bool pressed);
+static void apply_key_queue(void);
 
 bool emu_init(void)
 {
-    frame_buffer_565 = new u16[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
-    emu_frame_buffer = new GB_Color[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+    emu_frame_buffer = new u32[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+    init_24bit_lut();
     init_debug();
     gearboy = new GearboyCore();
-    gearboy->Init();
+    gearboy->Init(GB_PIXEL_RGBA8888);
     sound_queue_init();
     audio_buffer = new s16[AUDIO_BUFFER_SIZE];
+    emu_thread_audio_buffer = new s16[AUDIO_BUFFER_SIZE];
     for (int i = 0; i < AUDIO_BUFFER_SIZE; i++)
+    {
         audio_buffer[i] = 0;
+        emu_thread_audio_buffer[i] = 0;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        frame_slots[i] = new u32[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+        memset(frame_slots[i], 0, SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * sizeof(u32));
+        frame_slot_sizes[i] = 0;
+    }
     audio_enabled = true;
     emu_audio_sync = true;
     emu_debug_disable_breakpoints = false;
@@ -134,6 +214,8 @@ bool emu_init(void)
 
 void emu_destroy(void)
 {
+    emu_stop_thread();
+
     if (loading_thread_active)
     {
         loading_thread.join();
@@ -149,9 +231,11 @@ void emu_destroy(void)
         SafeDeleteArray(emu_savestates_screenshots[i].data);
 
     SafeDeleteArray(audio_buffer);
+    SafeDeleteArray(emu_thread_audio_buffer);
+    for (int i = 0; i < 3; i++)
+        SafeDeleteArray(frame_slots[i]);
     sound_queue_destroy();
     SafeDelete(gearboy);
-    SafeDeleteArray(frame_buffer_565);
     SafeDeleteArray(emu_frame_buffer);
     SafeDeleteArray(debug_background_buffer_565);
     SafeDeleteArray(emu_debug_background_buffer);
@@ -247,16 +331,21 @@ void emu_render_current_frame(void)
 
     apply_dmg_palette_override();
 
-    gearboy->RenderFrameBuffer(frame_buffer_565);
-
-    GB_RuntimeInfo rt_info;
-    gearboy->GetRuntimeInfo(rt_info);
-    generate_24bit_buffer(emu_frame_buffer, frame_buffer_565, rt_info.screen_width * rt_info.screen_height);
+    gearboy->RenderFrameBuffer(emu_frame_buffer);
 
     if (config_debug.debug)
         update_debug();
 }
 
+// Opaque black, the textures sample the alpha channel
+void emu_clear_frame_buffer(void)
+{
+    u32 black = PackColor32(0, 0, 0, GB_PIXEL_RGBA8888);
+
+    for (int i = 0; i < SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT; i++)
+        emu_frame_buffer[i] = black;
+}
+
 void emu_reset_rewind_timing(void)
 {
     reset_rewind_timing();
@@ -269,6 +358,8 @@ void emu_update(void)
 
     emu_mcp_pump_commands();
 
+    update_emu_thread();
+
     if (emu_is_empty())
         return;
 
@@ -292,98 +383,50 @@ void emu_update(void)
 
         int silence_count = GB_AUDIO_QUEUE_SIZE;
         memset(audio_buffer, 0, silence_count * sizeof(s16));
-        sound_queue_write(audio_buffer, silence_count, false);
+        write_audio(audio_buffer, silence_count, false);
+
+        // Whatever the emulation thread finished before the rewind started
+        // is older than the frames being popped
+        frame_slot_shared.fetch_and(~FRAME_SLOT_FRESH);
         return;
     }
 
     reset_rewind_timing();
 
-    if (config_debug.debug)
+    if (emu_thread_active)
     {
-        bool breakpoint_hit = false;
-        GearboyCore::GB_Debug_Run debug_run;
-        debug_run.step_debugger = (emu_debug_command == Debug_Command_Step);
-        debug_run.stop_on_breakpoint = !emu_debug_disable_breakpoints;
-        debug_run.stop_on_run_to_breakpoint = true;
-        debug_run.stop_on_irq = emu_debug_irq_breakpoints;
-
-        bool executed = (emu_debug_command != Debug_Command_None);
-
-        if (executed)
-        {
-            Debug_Command debug_command = emu_debug_command;
-            rewind_commit_seek();
-            breakpoint_hit = gearboy->RunToVBlank(frame_buffer_565, audio_buffer, &sampleCount, false, &debug_run);
-            frame_executed = true;
-
-            if (!breakpoint_hit && (debug_command == Debug_Command_StepFrame || debug_command == Debug_Command_Continue))
-                frame_completed = true;
-        }
-
-        if (breakpoint_hit || emu_debug_command == Debug_Command_StepFrame || emu_debug_command == Debug_Command_Step)
-        {
-            emu_debug_pc_changed = true;
-
-            if (config_debug.dis_look_ahead_count > 0)
-                gearboy->GetProcessor()->DisassembleAhead(config_debug.dis_look_ahead_count);
-        }
-
-        if (breakpoint_hit)
-            emu_debug_command = Debug_Command_None;
-
-        if (emu_debug_command == Debug_Command_StepFrame && emu_debug_step_frames_pending > 0)
-        {
-            emu_debug_step_frames_pending--;
-            if (emu_debug_step_frames_pending > 0)
-                emu_debug_command = Debug_Command_StepFrame;
-            else
-                emu_debug_command = Debug_Command_None;
-        }
-        else if (emu_debug_command != Debug_Command_Continue)
-            emu_debug_command = Debug_Command_None;
+        collect_frame();
 
+        if (config_debug.debug)
+            update_debug();
+    }
+    else if (config_debug.debug)
+    {
+        frame_executed = run_debug_frame(emu_frame_buffer, audio_buffer, &sampleCount, &frame_completed);
         update_debug();
     }
     else
     {
         if (!gearboy->IsPaused())
         {
-            rewind_commit_seek();
-
-            int runahead = runahead_get_frames();
-            if (runahead > 0)
-                runahead_run(runahead, frame_buffer_565, audio_buffer, &sampleCount);
-            else
-                gearboy->RunToVBlank(frame_buffer_565, audio_buffer, &sampleCount, false, NULL);
-
+            sampleCount = run_frame(emu_frame_buffer, audio_buffer);
             frame_executed = true;
             frame_completed = true;
         }
     }
 
     if (frame_executed)
-    {
-        if (frame_completed)
-            emu_frame_counter++;
-        rewind_push();
-    }
-
-    if (frame_executed)
-    {
-        GB_RuntimeInfo rt_info;
-        gearboy->GetRuntimeInfo(rt_info);
-        generate_24bit_buffer(emu_frame_buffer, frame_buffer_565, rt_info.screen_width * rt_info.screen_height);
-    }
+        end_frame(frame_completed);
 
     if ((sampleCount > 0) && !gearboy->IsPaused())
     {
-        sound_queue_write(audio_buffer, sampleCount, emu_audio_sync);
+        write_audio(audio_buffer, sampleCount, emu_audio_sync);
     }
     else if (gearboy->IsPaused())
     {
         int silence_count = GB_AUDIO_QUEUE_SIZE;
         memset(audio_buffer, 0, silence_count * sizeof(s16));
-        sound_queue_write(audio_buffer, silence_count, false);
+        write_audio(audio_buffer, silence_count, false);
     }
     // Mouse tilt decay: gradually return to center each frame
     if (config_emulator.tilt_source == 1)
@@ -399,6 +442,292 @@ void emu_update(void)
     }
 }
 
+void emu_lock_core(void)
+{
+    if (core_locked)
+        return;
+
+    // Asks the emulation thread to step aside once its current frame ends
+    core_lock_requests.fetch_add(1);
+    core_mutex.lock();
+    core_lock_requests.fetch_sub(1);
+    core_locked = true;
+}
+
+void emu_unlock_core(void)
+{
+    if (!core_locked)
+        return;
+
+    core_locked = false;
+    core_mutex.unlock();
+}
+
+bool emu_is_threaded(void)
+{
+    return emu_thread_active;
+}
+
+void emu_stop_thread(void)
+{
+    if (!emu_thread_active)
+        return;
+
+    emu_thread_quit.store(true);
+
+    // The thread only checks the request with the core lock held
+    bool relock = core_locked;
+    emu_unlock_core();
+    emu_thread.join();
+    emu_thread_active = false;
+
+    if (relock)
+        emu_lock_core();
+}
+
+static int run_frame(u32* frame_buffer, s16* samples)
+{
+    int sample_count = 0;
+
+    rewind_commit_seek();
+
+    int runahead = runahead_get_frames();
+    if (runahead > 0)
+        runahead_run(runahead, frame_buffer, samples, &sample_count);
+    else
+        gearboy->RunToVBlank(frame_buffer, samples, &sample_count, false, NULL);
+
+    return sample_count;
+}
+
+static bool run_debug_frame(u32* frame_buffer, s16* samples, int* sample_count, bool* frame_completed)
+{
+    bool breakpoint_hit = false;
+    GearboyCore::GB_Debug_Run debug_run;
+    debug_run.step_debugger = (emu_debug_command == Debug_Command_Step);
+    debug_run.stop_on_breakpoint = !emu_debug_disable_breakpoints;
+    debug_run.stop_on_run_to_breakpoint = true;
+    debug_run.stop_on_irq = emu_debug_irq_breakpoints;
+
+    bool executed = (emu_debug_command != Debug_Command_None);
+
+    if (executed)
+    {
+        Debug_Command debug_command = emu_debug_command;
+        rewind_commit_seek();
+        breakpoint_hit = gearboy->RunToVBlank(frame_buffer, samples, sample_count, false, &debug_run);
+
+        if (!breakpoint_hit && (debug_command == Debug_Command_StepFrame || debug_command == Debug_Command_Continue))
+            *frame_completed = true;
+    }
+
+    if (breakpoint_hit || emu_debug_command == Debug_Command_StepFrame || emu_debug_command == Debug_Command_Step)
+    {
+        emu_debug_pc_changed = true;
+
+        if (config_debug.dis_look_ahead_count > 0)
+            gearboy->GetProcessor()->DisassembleAhead(config_debug.dis_look_ahead_count);
+    }
+
+    if (breakpoint_hit)
+        emu_debug_command = Debug_Command_None;
+
+    if (emu_debug_command == Debug_Command_StepFrame && emu_debug_step_frames_pending > 0)
+    {
+        emu_debug_step_frames_pending--;
+        if (emu_debug_step_frames_pending > 0)
+            emu_debug_command = Debug_Command_StepFrame;
+        else
+            emu_debug_command = Debug_Command_None;
+    }
+    else if (emu_debug_command != Debug_Command_Continue)
+        emu_debug_command = Debug_Command_None;
+
+    return executed;
+}
+
+static void end_frame(bool frame_completed)
+{
+    if (frame_completed)
+        emu_frame_counter++;
+    rewind_push();
+}
+
+static void write_audio(s16* samples, int count, bool sync)
+{
+    std::lock_guard<std::mutex> lock(audio_mutex);
+    sound_queue_write(samples, count, sync);
+}
+
+// Called from emu_update() with the core lock held
+static void update_emu_thread(void)
+{
+    if (config_emulator.emulation_thread == emu_thread_active)
+        return;
+
+    if (emu_thread_active)
+    {
+        emu_stop_thread();
+        return;
+    }
+
+    frame_slot_back = 0;
+    frame_slot_front = 2;
+    frame_slot_shared.store(1);
+    emu_thread_quit.store(false);
+    emu_thread = std::thread(emu_thread_func);
+    emu_thread_active = true;
+}
+
+static void emu_thread_func(void)
+{
+    Uint64 next_frame = SDL_GetPerformanceCounter();
+
+    while (true)
+    {
+        // The main loop goes first, it only holds the core for a few
+        // milliseconds per display frame
+        while (core_lock_requests.load() > 0)
+            std::this_thread::yield();
+
+        std::unique_lock<std::mutex> lock(core_mutex);
+
+        if (emu_thread_quit.load())
+        {
+            apply_key_queue();
+            break;
+        }
+
+        if (!emu_thread_can_run())
+        {
+            lock.unlock();
+            SDL_Delay(1);
+            next_frame = SDL_GetPerformanceCounter();
+            continue;
+        }
+
+        apply_key_queue();
+
+        u32* frame_buffer = frame_slots[frame_slot_back];
+        int sample_count = 0;
+        bool frame_completed = true;
+
+        if (config_debug.debug)
+        {
+            frame_completed = false;
+            run_debug_frame(frame_buffer, emu_thread_audio_buffer, &sample_count, &frame_completed);
+        }
+        else
+            sample_count = run_frame(frame_buffer, emu_thread_audio_buffer);
+
+        end_frame(frame_completed);
+
+        GB_RuntimeInfo rt_info;
+        gearboy->GetRuntimeInfo(rt_info);
+        bool sync = emu_audio_sync && sound_queue_is_open();
+        float frame_time = display_get_frame_time();
+
+        lock.unlock();
+
+        publish_frame(rt_info.screen_width * rt_info.screen_height);
+
+        // A synced sound queue blocks until there is room, which paces
+        // emulation to the audio clock. Otherwise use the frame time
+        if (sample_count > 0)
+            write_audio(emu_thread_audio_buffer, sample_count, sync);
+
+        if (sync)
+            next_frame = SDL_GetPerformanceCounter();
+        else
+            emu_thread_pace(&next_frame, frame_time);
+    }
+}
+
+static bool emu_thread_can_run(void)
+{
+    if (emu_is_empty() || gearboy->IsPaused() || rewind_is_active())
+        return false;
+
+    return !emu_is_debug_idle();
+}
+
+static void emu_thread_pace(Uint64* next_frame, float frame_time)
+{
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 period = (Uint64)((double)frame_time * (double)frequency / 1000.0);
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    *next_frame += period;
+
+    // Too far behind to catch up, start counting again from now
+    if ((now > *next_frame) && ((now - *next_frame) > (period * 2)))
+    {
+        *next_frame = now;
+        return;
+    }
+
+    if (*next_frame > now)
+    {
+        Uint32 wait_ms = (Uint32)(((*next_frame - now) * 1000) / frequency);
+        if (wait_ms > 0)
+            SDL_Delay(wait_ms);
+    }
+}
+
+// Emulation thread: hands the frame it just finished over to the main loop
+// and takes the shared slot as its next back buffer
+static void publish_frame(int size)
+{
+    frame_slot_sizes[frame_slot_back] = size;
+    int previous = frame_slot_shared.exchange(frame_slot_back | FRAME_SLOT_FRESH);
+    frame_slot_back = previous & ~FRAME_SLOT_FRESH;
+}
+
+// Main loop: takes the newest finished frame, if any
+static void collect_frame(void)
+{
+    if (!(frame_slot_shared.load() & FRAME_SLOT_FRESH))
+        return;
+
+    int previous = frame_slot_shared.exchange(frame_slot_front);
+    frame_slot_front = previous & ~FRAME_SLOT_FRESH;
+
+    memcpy(emu_frame_buffer, frame_slots[frame_slot_front], frame_slot_sizes[frame_slot_front] * sizeof(u32));
+}
+
+// Main loop, with the core lock held
+static void queue_key(Gameboy_Keys key, bool pressed)
+{
+    u32 write = key_queue_write.load(std::memory_order_relaxed);
+
+    if ((write - key_queue_read.load(std::memory_order_acquire)) >= KEY_QUEUE_SIZE)
+        apply_key_queue();
+
+    key_queue[write & (KEY_QUEUE_SIZE - 1)] = (u16)key | (pressed ? KEY_QUEUE_PRESSED : 0);
+    key_queue_write.store(write + 1, std::memory_order_release);
+}
+
+static void apply_key_queue(void)
+{
+    u32 read = key_queue_read.load(std::memory_order_relaxed);
+    u32 write = key_queue_write.load(std::memory_order_acquire);
+
+    while (read != write)
+    {
+        u16 entry = key_queue[read & (KEY_QUEUE_SIZE - 1)];
+        Gameboy_Keys key = (Gameboy_Keys)(entry & ~KEY_QUEUE_PRESSED);
+
+        if (entry & KEY_QUEUE_PRESSED)
+            gearboy->KeyPressed(key);
+        else
+            gearboy->KeyReleased(key);
+
+        read++;
+    }
+
+    key_queue_read.store(read, std::memory_order_release);
+}
+
 static void reset_rewind_timing(void)
 {
     rewind_last_counter = 0;
@@ -439,12 +768,18 @@ static int get_rewind_pop_budget(void)
 
 void emu_key_pressed(Gameboy_Keys key)
 {
-    gearboy->KeyPressed(key);
+    if (emu_thread_active)
+        queue_key(key, true);
+    else
+        gearboy->KeyPressed(key);
 }
 
 void emu_key_released(Gameboy_Keys key)
 {
-    gearboy->KeyReleased(key);
+    if (emu_thread_active)
+        queue_key(key, false);
+    else
+        gearboy->KeyReleased(key);
 }
 
 void emu_pause(void)
@@ -509,6 +844,7 @@ void emu_audio_set_master_volume(float volume)
 
 void emu_audio_reset(void)
 {
+    std::lock_guard<std::mutex> lock(audio_mutex);
     sound_queue_stop();
     sound_queue_start(GB_AUDIO_SAMPLE_RATE, 2, GB_AUDIO_QUEUE_SIZE, config_audio.buffer_count);
 }
@@ -838,7 +1174,7 @@ void emu_save_screenshot(const char* file_path)
     GB_RuntimeInfo rt_info;
     gearboy->GetRuntimeInfo(rt_info);
     Log("Saving screenshot to %s", file_path);
-    stbi_write_png(file_path, rt_info.screen_width, rt_info.screen_height, 3, emu_frame_buffer, rt_info.screen_width * 3);
+    stbi_write_png(file_path, rt_info.screen_width, rt_info.screen_height, 4, emu_frame_buffer, rt_info.screen_width * 4);
 }
 
 void emu_save_sprite(const char* file_path, int index)
@@ -1084,12 +1420,12 @@ int emu_get_screenshot_png(unsigned char** out_buffer)
 
     GB_RuntimeInfo rt_info;
     gearboy->GetRuntimeInfo(rt_info);
-    int stride = rt_info.screen_width * 3;
+    int stride = rt_info.screen_width * 4;
     int len = 0;
 
     *out_buffer = stbi_write_png_to_mem((const unsigned char*)emu_frame_buffer, stride,
                                          rt_info.screen_width, rt_info.screen_height,
-                                         3, &len);
+                                         4, &len);
 
     return len;
 }
@@ -1166,13 +1502,7 @@ void emu_mcp_pump_commands(void)
 
 static void reset_buffers(void)
 {
-    for (int i = 0; i < SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT; i++)
-    {
-        emu_frame_buffer[i].red = 0;
-        emu_frame_buffer[i].green = 0;
-        emu_frame_buffer[i].blue = 0;
-        frame_buffer_565[i] = 0;
-    }
+    emu_clear_frame_buffer();
     for (int i = 0; i < AUDIO_BUFFER_SIZE; i++)
         audio_buffer[i] = 0;
 }
@@ -1195,13 +1525,23 @@ static void load_ram(void)
         gearboy->LoadRam();
 }
 
+static void init_24bit_lut(void)
+{
+    for (int i = 0; i < 32; i++)
+        color_5_to_8[i] = (u8)((i * 255 + 15) / 31);
+
+    for (int i = 0; i < 64; i++)
+        color_6_to_8[i] = (u8)((i * 255 + 31) / 63);
+}
+
 static void generate_24bit_buffer(GB_Color* dest, u16* src, int size)
 {
     for (int i = 0; i < size; i++)
     {
-        dest[i].red = (((src[i] >> 11) & 0x1F) * 255 + 15) / 31;
-        dest[i].green = (((src[i] >> 5) & 0x3F) * 255 + 31) / 63;
-        dest[i].blue = ((src[i] & 0x1F) * 255 + 15) / 31;
+        u16 color = src[i];
+        dest[i].red = color_5_to_8[color >> 11];
+        dest[i].green = color_6_to_8[(color >> 5) & 0x3F];
+        dest[i].blue = color_5_to_8[color & 0x1F];
     }
 }
 
@@ -1281,32 +1621,82 @@ static void init_debug(void)
         memset(emu_debug_oam_buffers[s], 0, 8 * 16 * sizeof(GB_Color));
     }
 
-    memset(frame_buffer_565, 0, SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * sizeof(u16));
-    memset(emu_frame_buffer, 0, SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * sizeof(GB_Color));
+    emu_clear_frame_buffer();
     memset(debug_background_buffer_565, 0, 256 * 256 * sizeof(u16));
     memset(emu_debug_background_buffer, 0, 256 * 256 * sizeof(GB_Color));
+
+    memset(&debug_video_last, 0, sizeof(debug_video_last));
+    debug_oam_generation_last = 0;
+    debug_background_dirty = true;
+    debug_tiles_dirty = true;
+    debug_oam_dirty = true;
+    emu_debug_background_generation = 0;
+    emu_debug_tiles_generation = 0;
+    emu_debug_oam_generation = 0;
 }
 
 static void update_debug(void)
 {
-    if (config_debug.show_video_nametable)
+    update_debug_dirty_flags();
+
+    if (config_debug.show_video_nametable && debug_background_dirty)
     {
         update_debug_background_buffer();
         generate_24bit_buffer(emu_debug_background_buffer, debug_background_buffer_565, 256 * 256);
+        debug_background_dirty = false;
+        emu_debug_background_generation++;
     }
 
-    if (config_debug.show_video_tiles)
+    if (config_debug.show_video_tiles && debug_tiles_dirty)
     {
         update_debug_tile_buffers();
         for (int b = 0; b < 2; b++)
             generate_24bit_buffer(emu_debug_tile_buffers[b], debug_tile_buffers_565[b], 16 * 24 * 64);
+        debug_tiles_dirty = false;
+        emu_debug_tiles_generation++;
     }
 
-    if (config_debug.show_video_sprites)
+    if (config_debug.show_video_sprites && debug_oam_dirty)
     {
         update_debug_oam_buffers();
         for (int s = 0; s < 40; s++)
             generate_24bit_buffer(emu_debug_oam_buffers[s], debug_oam_buffers_565[s], 8 * 16);
+        debug_oam_dirty = false;
+        emu_debug_oam_generation++;
+    }
+}
+
+// The views stay untouched while the debugger is paused or the game is
+// not writing to VRAM, so only rebuild them when an input changed
+static void update_debug_dirty_flags(void)
+{
+    Video* video = gearboy->GetVideo();
+    debug_video_state* state = &debug_video_current;
+
+    memset(state, 0, sizeof(debug_video_state));
+    state->video_data_generation = video->GetVideoDataGeneration();
+    memcpy(state->dmg_internal_palette, gearboy->GetDMGInternalPalette(), sizeof(state->dmg_internal_palette));
+    state->background_tile_address = emu_debug_background_tile_address;
+    state->background_map_address = emu_debug_background_map_address;
+    state->tile_dmg_palette = emu_debug_tile_dmg_palette;
+    state->tile_color_palette = emu_debug_tile_color_palette;
+    state->background_is_window = emu_debug_background_is_window;
+    state->cgb = gearboy->IsCGB();
+
+    if (memcmp(state, &debug_video_last, sizeof(debug_video_state)) != 0)
+    {
+        memcpy(&debug_video_last, state, sizeof(debug_video_state));
+        debug_background_dirty = true;
+        debug_tiles_dirty = true;
+        debug_oam_dirty = true;
+    }
+
+    u32 oam_generation = video->GetOAMGeneration();
+
+    if (oam_generation != debug_oam_generation_last)
+    {
+        debug_oam_generation_last = oam_generation;
+        debug_oam_dirty = true;
     }
 }
 
@@ -43,7 +43,7 @@ enum Directory_Location
     Directory_Location_Custom = 2
 };
 
-EXTERN GB_Color* emu_frame_buffer;
+EXTERN u32* emu_frame_buffer;
 EXTERN GB_Color* emu_debug_background_buffer;
 EXTERN GB_Color* emu_debug_tile_buffers[2];
 EXTERN GB_Color* emu_debug_oam_buffers[40];
@@ -56,6 +56,9 @@ EXTERN int emu_debug_background_map_address;
 EXTERN int emu_debug_tile_dmg_palette;
 EXTERN int emu_debug_tile_color_palette;
 EXTERN bool emu_debug_background_is_window;
+EXTERN u32 emu_debug_background_generation;
+EXTERN u32 emu_debug_tiles_generation;
+EXTERN u32 emu_debug_oam_generation;
 EXTERN bool emu_audio_sync;
 EXTERN bool emu_debug_disable_breakpoints;
 EXTERN bool emu_debug_irq_breakpoints;
@@ -63,11 +66,16 @@ EXTERN bool emu_debug_irq_breakpoints;
 EXTERN bool emu_init(void);
 EXTERN void emu_destroy(void);
 EXTERN void emu_update(void);
+EXTERN void emu_lock_core(void);
+EXTERN void emu_unlock_core(void);
+EXTERN bool emu_is_threaded(void);
+EXTERN void emu_stop_thread(void);
 EXTERN void emu_load_rom(const char* file_path, bool force_dmg, Cartridge::CartridgeTypes mbc, bool force_gba);
 EXTERN void emu_load_rom_async(const char* file_path, bool force_dmg, Cartridge::CartridgeTypes mbc, bool force_gba);
 EXTERN bool emu_is_rom_loading(void);
 EXTERN bool emu_finish_rom_loading(void);
 EXTERN void emu_render_current_frame(void);
+EXTERN void emu_clear_frame_buffer(void);
 EXTERN void emu_reset_rewind_timing(void);
 EXTERN void emu_key_pressed(Gameboy_Keys key);
 EXTERN void emu_key_released(Gameboy_Keys key);
@@ -708,12 +708,7 @@ static bool finish_loading_rom(void)
     {
         emu_pause();
 
-        for (int i = 0; i < (SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT); i++)
-        {
-            emu_frame_buffer[i].red = 0;
-            emu_frame_buffer[i].green = 0;
-            emu_frame_buffer[i].blue = 0;
-        }
+        emu_clear_frame_buffer();
     }
 
     if (!emu_is_empty())
@@ -43,10 +43,7 @@ void gui_action_reset(void)
     {
         emu_pause();
 
-        for (int i=0; i < (GAMEBOY_WIDTH * GAMEBOY_HEIGHT); i++)
-        {
-            { emu_frame_buffer[i].red = 0; emu_frame_buffer[i].green = 0; emu_frame_buffer[i].blue = 0; }
-        }
+        emu_clear_frame_buffer();
     }
 }
 
@@ -26,6 +26,7 @@
 #include "gui_debug_disassembler.h"
 #include "gui_debug_memory.h"
 #include "gui_debug_processor.h"
+#include "gui_debug_profiler.h"
 #include "gui_debug_rewind.h"
 #include "gui_debug_video.h"
 #include "gui_debug_io.h"
@@ -78,6 +79,8 @@ void gui_debug_windows(void)
     gui_debug_update();
 
     emu_get_core()->GetAudio()->EnablePSGDebug(config_debug.debug && config_debug.show_psg);
+    emu_get_core()->GetProfiler()->Enable(config_debug.debug && config_debug.show_profiler);
+    emu_get_core()->GetCodeProfiler()->Enable(config_debug.debug && config_debug.dis_code_profiler);
 
     if (config_debug.debug)
     {
@@ -111,6 +114,8 @@ void gui_debug_windows(void)
             gui_debug_window_trace_logger();
         if (config_debug.show_rewind)
             gui_debug_window_rewind();
+        if (config_debug.show_profiler)
+            gui_debug_window_profiler();
         if (emu_get_core()->IsSGB())
         {
             if (config_debug.show_sgb_state)
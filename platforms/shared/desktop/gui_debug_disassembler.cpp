@@ -112,6 +112,7 @@ static void add_bookmark_popup(void);
 static void add_symbol_popup(void);
 static void save_full_disassembler(FILE* file);
 static void save_current_disassembler(FILE* file);
+static void get_frame_name(u16 address, u16 bank, char* text, size_t text_size);
 static bool disassembler_uses_assembler_syntax(void);
 static bool symbol_sort_address_asc(const SymbolEntry& a, const SymbolEntry& b);
 static bool symbol_sort_address_desc(const SymbolEntry& a, const SymbolEntry& b);
@@ -313,6 +314,41 @@ void gui_debug_save_disassembler(const char* file_path, bool full)
     }
 }
 
+void gui_debug_save_collapsed_stacks(const char* file_path)
+{
+    FILE* file = fopen_utf8(file_path, "w");
+
+    if (!IsValidPointer(file))
+        return;
+
+    const std::vector<GB_Code_Profiler_Node>* nodes = emu_get_core()->GetCodeProfiler()->GetNodes();
+    std::vector<u32> path;
+    char name[64];
+
+    for (size_t i = 0; i < nodes->size(); i++)
+    {
+        if ((*nodes)[i].cycles == 0)
+            continue;
+
+        path.clear();
+        for (u32 n = (u32)i; n != 0; n = (*nodes)[n].parent)
+            path.push_back(n);
+
+        fprintf(file, "main");
+
+        for (int p = (int)path.size() - 1; p >= 0; p--)
+        {
+            const GB_Code_Profiler_Node& node = (*nodes)[path[p]];
+            get_frame_name(node.address, node.bank, name, sizeof(name));
+            fprintf(file, ";%s", name);
+        }
+
+        fprintf(file, " %llu\n", (unsigned long long)(*nodes)[i].cycles);
+    }
+
+    fclose(file);
+}
+
 static void draw_controls(void)
 {
     ImGui::PushFont(gui_material_icons_font);
@@ -696,6 +732,8 @@ static void draw_disassembly(void)
         Processor* processor = emu_get_core()->GetProcessor();
         Processor::ProcessorState* proc_state = processor->GetState();
         u16 pc = proc_state->PC->GetValue();
+        CodeProfiler* code_profiler = emu_get_core()->GetCodeProfiler();
+        u64 total_cycles = code_profiler->GetTotalCycles();
 
         prepare_drawable_lines();
 
@@ -796,6 +834,32 @@ static void draw_disassembly(void)
                 ImVec4 color_addr = line.is_breakpoint ? red : cyan;
                 ImVec4 color_mem = line.is_breakpoint ? red : (config_emulator.theme == config_Theme_Light ? gray : mid_gray);
 
+                if (config_debug.dis_show_heat)
+                {
+                    const GB_Code_Profiler_Counter* counter = code_profiler->GetCounter(line.address, line.record->bank);
+                    u64 cycles = IsValidPointer(counter) ? counter->cycles : 0;
+
+                    ImGui::SameLine();
+                    if ((cycles == 0) || (total_cycles == 0))
+                    {
+                        ImGui::TextColored(color_mem, "     -");
+                    }
+                    else
+                    {
+                        // Anything above 5% of the profiled cycles is drawn fully red
+                        float share = (float)((double)cycles / (double)total_cycles);
+                        ImVec4 color_heat = gui_debug_lerp_color(yellow, red, MIN(share * 20.0f, 1.0f));
+                        ImGui::TextColored(color_heat, "%5.1f%%", share * 100.0f);
+                    }
+
+                    if (ImGui::IsItemHovered() && (cycles > 0))
+                    {
+                        ImGui::BeginTooltip();
+                        ImGui::Text("%llu cycles, %llu executions", (unsigned long long)cycles, (unsigned long long)counter->instructions);
+                        ImGui::EndTooltip();
+                    }
+                }
+
                 if (config_debug.dis_show_segment)
                 {
                     ImGui::SameLine();
@@ -1558,6 +1622,7 @@ static void disassembler_menu(void)
         ImGui::MenuItem("Symbols", NULL, &config_debug.dis_show_symbols);
         ImGui::MenuItem("Segment", NULL, &config_debug.dis_show_segment);
         ImGui::MenuItem("Bank", NULL, &config_debug.dis_show_bank);
+        ImGui::MenuItem("Heat", NULL, &config_debug.dis_show_heat);
 
         ImGui::Separator();
 
@@ -1797,6 +1862,26 @@ static void disassembler_menu(void)
         ImGui::EndMenu();
     }
 
+    if (ImGui::BeginMenu("Profiler"))
+    {
+        ImGui::MenuItem("Enable Code Profiler", NULL, &config_debug.dis_code_profiler);
+        ImGui::MenuItem("Show Heat Column", NULL, &config_debug.dis_show_heat);
+
+        ImGui::Separator();
+
+        if (ImGui::MenuItem("Reset Profile"))
+        {
+            emu_get_core()->GetCodeProfiler()->Reset();
+        }
+
+        if (ImGui::MenuItem("Save Collapsed Stacks As..."))
+        {
+            gui_file_dialog_save_collapsed_stacks();
+        }
+
+        ImGui::EndMenu();
+    }
+
     if (open_symbols)
         gui_file_dialog_load_symbols();
 
@@ -2345,12 +2430,13 @@ void gui_debug_find_symbols(const char* name, std::vector<DebugSymbol*>& symbols
 static void save_full_disassembler(FILE* file)
 {
     Memory* memory = emu_get_core()->GetMemory();
-    GS_Disassembler_Record** records = memory->GetAllDisassemblerRecords();
+    memory->DisassembleExecuted();
+    int size = (int)memory->GetROMDisassemblerSize();
     bool assembler_syntax = disassembler_uses_assembler_syntax();
 
-    for (int i = 0; i < 0x200000; i++)
+    for (int i = 0; i < size; i++)
     {
-        GS_Disassembler_Record* record = records[i];
+        GS_Disassembler_Record* record = memory->GetROMDisassemblerRecord(i);
 
         if (IsValidPointer(record) && (record->name[0] != 0))
         {
@@ -2504,6 +2590,33 @@ static bool symbol_sort_address_asc(const SymbolEntry& a, const SymbolEntry& b)
     return a.symbol->address < b.symbol->address;
 }
 
+static void get_frame_name(u16 address, u16 bank, char* text, size_t text_size)
+{
+    if (bank < 0x100)
+    {
+        DebugSymbol* symbol = fixed_symbols[bank][address];
+
+        if (!IsValidPointer(symbol))
+            symbol = dynamic_symbols[bank][address];
+
+        if (IsValidPointer(symbol))
+        {
+            snprintf(text, text_size, "%s", symbol->text);
+            return;
+        }
+
+        GS_Disassembler_Record* record = emu_get_core()->GetMemory()->GetDisassemblerRecord(address, bank);
+
+        if (IsValidPointer(record) && (record->auto_symbol[0] != 0))
+        {
+            snprintf(text, text_size, "%s", record->auto_symbol);
+            return;
+        }
+    }
+
+    snprintf(text, text_size, "%02X:%04X", bank, address);
+}
+
 static bool symbol_sort_address_desc(const SymbolEntry& a, const SymbolEntry& b)
 {
     if (a.bank != b.bank)
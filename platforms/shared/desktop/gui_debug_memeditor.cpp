@@ -66,6 +66,7 @@ MemEditor::MemEditor()
     m_find_bytes_buffer[0] = 0;
     m_find_bytes_last_address = -1;
     m_find_bytes_pattern_len = 0;
+    m_modified = false;
 }
 
 MemEditor::~MemEditor()
@@ -282,6 +283,7 @@ void MemEditor::Draw(bool ascii, bool preview, bool options, bool cursors)
                                         uint16_t* mem_data_16 = (uint16_t*)m_mem_data;
                                         mem_data_16[byte_address] = value;
                                     }
+                                    m_modified = true;
 
                                     if (byte_address < (m_mem_size - 1))
                                     {
@@ -1030,6 +1032,14 @@ void MemEditor::StepFrame()
         SearchCapture();
 }
 
+// Returns whether the data was written since the last call
+bool MemEditor::ConsumeModified()
+{
+    bool modified = m_modified;
+    m_modified = false;
+    return modified;
+}
+
 int MemEditor::GetWordBytes()
 {
     return m_mem_word;
@@ -1720,6 +1730,7 @@ void MemEditor::Paste()
         {
             m_mem_data[i] = data[i - start];
         }
+        m_modified = true;
 
         delete[] data;
     }
@@ -1807,6 +1818,8 @@ void MemEditor::SetValueToSelection(int value)
         for (int i = selection_start; i <= selection_end; i++)
             mem_data_16[i] = (uint16_t)value;
     }
+
+    m_modified = true;
 }
 
 void MemEditor::SaveToTextFile(const char* file_path)
@@ -1877,11 +1890,8 @@ void MemEditor::LoadFromBinaryFile(const char* file_path)
     if (file)
     {
         size_t bytes = (size_t)size;
-        if (fread(m_mem_data, 1, bytes, file) != bytes)
-        {
-            fclose(file);
-            return;
-        }
+        size_t bytes_read = fread(m_mem_data, 1, bytes, file);
+        m_modified = m_modified || (bytes_read > 0);
         fclose(file);
     }
 }
@@ -2253,6 +2263,8 @@ void MemEditor::WriteWatchValue(const Watch& watch, uint32_t value)
     {
         m_mem_data[byte_offset + i] = (uint8_t)((value >> (i * 8)) & 0xFF);
     }
+
+    m_modified = true;
 }
 
 int MemEditor::WatchSizeBytes(int size)
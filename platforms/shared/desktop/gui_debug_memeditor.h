@@ -97,6 +97,7 @@ public:
     Options GetOptions() const;
     void SetOptions(const Options& options);
     void StepFrame();
+    bool ConsumeModified();
     int GetWordBytes();
     char* GetTitle();
     void GetSelection(int* start, int* end);
@@ -157,6 +158,7 @@ private:
     char m_hex_addr_format[16];
     int m_hex_addr_digits;
     int m_mem_word;
+    bool m_modified;
     char m_goto_address[7];
     char m_find_next[5];
     bool m_add_bookmark;
@@ -31,6 +31,7 @@ static void draw_tabs(void);
 static void memory_editor_menu(void);
 static void reset_ram_editor(GearboyCore* core, Memory* memory, MemoryRule* rule);
 static void refresh_memory_banks(void);
+static void invalidate_edited_caches(void);
 static bool memory_settings_read_data(std::istream& stream, void* data, size_t size);
 static bool memory_settings_read_count(std::istream& stream, int& count, size_t record_size);
 static bool memory_settings_read_editor(std::istream& stream, std::vector<MemEditor::Bookmark>& bookmarks,
@@ -158,6 +159,8 @@ void gui_debug_window_memory(void)
         ImGui::EndTabBar();
     }
 
+    invalidate_edited_caches();
+
     ImGui::End();
     ImGui::PopStyleVar();
 }
@@ -259,6 +262,26 @@ static void refresh_memory_banks(void)
     }
 }
 
+// Edits bypass the memory rules, so once an editor writes, drop decoded
+// tiles and the composed SGB border in case VRAM or the border changed
+static void invalidate_edited_caches(void)
+{
+    bool modified = false;
+
+    for (int i = 0; i < MEMORY_EDITOR_MAX; i++)
+    {
+        if (mem_edit[i].ConsumeModified())
+            modified = true;
+    }
+
+    if (!modified)
+        return;
+
+    GearboyCore* core = emu_get_core();
+    core->GetVideo()->InvalidateTileCache();
+    core->GetSGB()->InvalidateBorderCache();
+}
+
 void gui_debug_memory_search_window(void)
 {
     for (int i = 0; i < MEMORY_EDITOR_MAX; i++)
@@ -287,6 +310,8 @@ void gui_debug_memory_watches_window(void)
         mem_edit[i].DrawWatchWindow();
         ImGui::PopFont();
     }
+
+    invalidate_edited_caches();
 }
 
 void gui_debug_memory_step_frame(void)
@@ -305,6 +330,7 @@ void gui_debug_memory_copy(void)
 void gui_debug_memory_paste(void)
 {
     mem_edit[current_mem_edit].Paste();
+    invalidate_edited_caches();
 }
 
 void gui_debug_memory_select_all(void)
@@ -329,6 +355,7 @@ void gui_debug_memory_save_dump(const char* file_path, bool binary)
 void gui_debug_memory_load_dump(const char* file_path)
 {
     mem_edit[current_mem_edit].LoadFromBinaryFile(file_path);
+    invalidate_edited_caches();
 }
 
 bool gui_debug_memory_select_range(int editor, int start_address, int end_address)
@@ -351,6 +378,7 @@ void gui_debug_memory_set_selection_value(int editor, u8 value)
         return;
 
     mem_edit[editor].SetValueToSelection(value);
+    invalidate_edited_caches();
 }
 
 void gui_debug_memory_add_bookmark(int editor, int address, const char* name)
@@ -0,0 +1,113 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#define GUI_DEBUG_PROFILER_IMPORT
+#include "gui_debug_profiler.h"
+
+#include "imgui.h"
+#include "gearboy.h"
+#include "gui_debug_constants.h"
+#include "gui.h"
+#include "config.h"
+#include "emu.h"
+
+static const ImVec4 depth_colors[] = { cyan, yellow, orange, violet };
+
+void gui_debug_window_profiler(void)
+{
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 8.0f);
+    ImGui::SetNextWindowPos(ImVec2(160, 140), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(420, 340), ImGuiCond_FirstUseEver);
+
+    ImGui::Begin("Profiler", &config_debug.show_profiler);
+
+    Profiler* profiler = emu_get_core()->GetProfiler();
+    const GB_Profiler_Frame* last = profiler->GetLastFrame();
+    const GB_Profiler_Frame* totals = profiler->GetTotals();
+    u64 frame_count = profiler->GetFrameCount();
+    double frame_ns = (double)last->sections[PROFILER_FRAME].time_ns;
+
+    if (ImGui::Button("Reset"))
+        profiler->Reset();
+
+    ImGui::SameLine();
+    ImGui::TextColored(gray, "Frames:");
+    ImGui::SameLine();
+    ImGui::Text("%llu", (unsigned long long)frame_count);
+
+    if (frame_count > 0)
+    {
+        double average_ms = (double)totals->sections[PROFILER_FRAME].time_ns / (double)frame_count / 1000000.0;
+        ImGui::SameLine();
+        ImGui::TextColored(gray, "  Avg:");
+        ImGui::SameLine();
+        ImGui::Text("%.3f ms (%.0f fps)", average_ms, average_ms > 0.0 ? 1000.0 / average_ms : 0.0);
+    }
+
+    ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable;
+
+    if (ImGui::BeginTable("profiler", 5, flags))
+    {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Section", ImGuiTableColumnFlags_WidthStretch, 2.0f);
+        ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthStretch, 0.8f);
+        ImGui::TableSetupColumn("%", ImGuiTableColumnFlags_WidthStretch, 0.7f);
+        ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthStretch, 0.8f);
+        ImGui::TableSetupColumn("Avg ms", ImGuiTableColumnFlags_WidthStretch, 0.8f);
+        ImGui::TableHeadersRow();
+
+        ImGui::PushFont(gui_default_font);
+
+        for (int i = 0; i < PROFILER_SECTION_COUNT; i++)
+        {
+            GB_Profiler_Section section = (GB_Profiler_Section)i;
+            const GB_Profiler_Counter& counter = last->sections[i];
+            int depth = Profiler::GetSectionDepth(section);
+            double ms = (double)counter.time_ns / 1000000.0;
+            double percent = frame_ns > 0.0 ? ((double)counter.time_ns * 100.0) / frame_ns : 0.0;
+            double average = frame_count > 0 ? (double)totals->sections[i].time_ns / (double)frame_count / 1000000.0 : 0.0;
+
+            ImGui::TableNextRow();
+
+            ImGui::TableNextColumn();
+            ImGui::Indent(depth * 12.0f + 1.0f);
+            ImGui::TextColored(depth_colors[depth % 4], "%s", Profiler::GetSectionName(section));
+            ImGui::Unindent(depth * 12.0f + 1.0f);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", ms);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%5.1f", percent);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)counter.calls);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", average);
+        }
+
+        ImGui::PopFont();
+
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+    ImGui::PopStyleVar();
+}
@@ -55,9 +55,10 @@ static bool trace_logger_disk_limit_reached = false;
 static bool trace_logger_disk_overflow = false;
 static Uint64 trace_logger_disk_last_flush = 0;
 
-static const u32 k_trace_logger_capacities[] = {100000, 500000, 1000000, 2000000, 5000000};
-static const char* const k_trace_logger_capacity_names[] = {"100K", "500K", "1M", "2M", "5M"};
-static const char* const k_trace_logger_capacity_labels[] = {"100K (10 MB)", "500K (50 MB)", "1M (100 MB)", "2M (200 MB)", "5M (500 MB)"};
+static const u32 k_trace_logger_capacities[] = {100000, 500000, 1000000, 2000000, 5000000, 10000000, 20000000};
+static const char* const k_trace_logger_capacity_names[] = {"100K", "500K", "1M", "2M", "5M", "10M", "20M"};
+static const char* const k_trace_logger_capacity_labels[] = {"100K (3 MB)", "500K (15 MB)", "1M (31 MB)", "2M (61 MB)", "5M (153 MB)", "10M (305 MB)", "20M (610 MB)"};
+static const char* const k_trace_logger_disk_format_names[] = {"text", "binary"};
 static const char* const k_trace_logger_disk_size_names[] = {
     "10MB", "50MB", "100MB", "250MB", "500MB", "1GB", "unbounded"
 };
@@ -85,6 +86,7 @@ static bool trace_logger_stop(bool show_status);
 static bool trace_logger_stop_disk(bool show_status, bool flush_entries);
 static bool trace_logger_flush_disk_buffer(bool flush_file);
 static bool trace_logger_flush_disk_entries(void);
+static bool trace_logger_write_disk(const void* data, size_t size);
 static void format_entry_text(const GB_Trace_Entry& entry, bool cycles,
     bool previous_cycle_valid, u64 previous_cycle, char* buf, int buf_size);
 static void render_entry_colored(const GB_Trace_Entry& entry, u64 index,
@@ -147,6 +149,11 @@ void gui_debug_window_trace_logger(void)
     else
     {
         ImGui::Combo("##trace_disk_size", &config_debug.trace_disk_size, "10 MB\0" "50 MB\0" "100 MB\0" "250 MB\0" "500 MB\0" "1 GB\0" "Unbounded\0\0");
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(80.0f);
+        ImGui::Combo("##trace_disk_format", &config_debug.trace_disk_format, "Text\0Binary\0\0");
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Binary writes %u byte little-endian records, use File > Convert Binary Trace to get text.", (u32)GB_TRACE_BINARY_RECORD_SIZE);
     }
     ImGui::EndDisabled();
     if (config_debug.trace_output == gui_TraceOutput_Memory && ImGui::IsItemHovered())
@@ -370,7 +377,27 @@ const char* gui_debug_trace_logger_disk_size_name(int index)
     return k_trace_logger_disk_size_names[index];
 }
 
-bool gui_debug_trace_logger_configure(int output, int memory_size, int disk_size, const char* output_path)
+int gui_debug_trace_logger_disk_format_index(const char* format)
+{
+    if (format)
+    {
+        for (int i = 0; i < IM_ARRAYSIZE(k_trace_logger_disk_format_names); i++)
+        {
+            if (strcmp(format, k_trace_logger_disk_format_names[i]) == 0)
+                return i;
+        }
+    }
+    return -1;
+}
+
+const char* gui_debug_trace_logger_disk_format_name(int index)
+{
+    if (index < 0 || index >= IM_ARRAYSIZE(k_trace_logger_disk_format_names))
+        return k_trace_logger_disk_format_names[0];
+    return k_trace_logger_disk_format_names[index];
+}
+
+bool gui_debug_trace_logger_configure(int output, int memory_size, int disk_size, int disk_format, const char* output_path)
 {
     if (trace_logger_enabled)
         return false;
@@ -380,16 +407,20 @@ bool gui_debug_trace_logger_configure(int output, int memory_size, int disk_size
         return false;
     if (disk_size < 0 || disk_size >= IM_ARRAYSIZE(k_trace_logger_disk_sizes))
         return false;
+    if (disk_format < 0 || disk_format >= IM_ARRAYSIZE(k_trace_logger_disk_format_names))
+        return false;
 
     int previous_output = config_debug.trace_output;
     int previous_memory_size = config_debug.trace_capacity;
     int previous_disk_size = config_debug.trace_disk_size;
+    int previous_disk_format = config_debug.trace_disk_format;
     int previous_dir_option = config_debug.trace_disk_dir_option;
     std::string previous_path = config_debug.trace_disk_path;
 
     config_debug.trace_output = output;
     config_debug.trace_capacity = memory_size;
     config_debug.trace_disk_size = disk_size;
+    config_debug.trace_disk_format = disk_format;
     if (output == gui_TraceOutput_Disk && output_path && output_path[0] != '\0')
     {
         config_debug.trace_disk_dir_option = Directory_Location_Custom;
@@ -401,6 +432,7 @@ bool gui_debug_trace_logger_configure(int output, int memory_size, int disk_size
         config_debug.trace_output = previous_output;
         config_debug.trace_capacity = previous_memory_size;
         config_debug.trace_disk_size = previous_disk_size;
+        config_debug.trace_disk_format = previous_disk_format;
         config_debug.trace_disk_dir_option = previous_dir_option;
         config_debug.trace_disk_path = previous_path;
         strncpy_fit(trace_logger_disk_directory, previous_path.c_str(), sizeof(trace_logger_disk_directory));
@@ -502,6 +534,69 @@ void gui_debug_save_log(const char* file_path)
     }
 }
 
+void gui_debug_convert_binary_log(const char* file_path)
+{
+    FILE* input = fopen_utf8(file_path, "rb");
+    if (!input)
+    {
+        gui_set_error_message("Unable to open the binary trace.");
+        return;
+    }
+
+    u8 header[GB_TRACE_BINARY_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), input) != sizeof(header) || !trace_logger_binary_read_header(header))
+    {
+        fclose(input);
+        gui_set_error_message("Not a binary trace, or written by an unsupported version.");
+        return;
+    }
+
+    // The text goes next to the binary trace, with a .txt extension
+    char directory[4096];
+    char name[1024];
+    char text_name[1100];
+    char text_path[4096];
+    get_directory(file_path, directory, sizeof(directory));
+    get_filename_without_extension(file_path, name, sizeof(name));
+    snprintf(text_name, sizeof(text_name), "%s.txt", name);
+
+    FILE* output = NULL;
+    if (join_path(directory, text_name, text_path, sizeof(text_path)))
+        output = fopen_utf8(text_path, "w");
+
+    if (!output)
+    {
+        fclose(input);
+        gui_set_error_message("Unable to create the text trace file.");
+        return;
+    }
+
+    u8 record[GB_TRACE_BINARY_RECORD_SIZE];
+    GB_Trace_Entry entry;
+    u64 index = 0;
+    u64 previous_cycle = 0;
+    char buf[GB_TRACE_FORMAT_BUFFER_SIZE];
+
+    while (fread(record, 1, sizeof(record), input) == sizeof(record))
+    {
+        trace_logger_binary_decode(record, entry);
+        format_entry_text(entry, config_debug.trace_cycles, index > 0, previous_cycle, buf, sizeof(buf));
+        if (config_debug.trace_counter)
+            fprintf(output, "%06llu %s\n", (unsigned long long)index, buf);
+        else
+            fprintf(output, "%s\n", buf);
+        previous_cycle = entry.cycle;
+        index++;
+    }
+
+    fclose(input);
+
+    if (fclose(output) != 0)
+        gui_set_error_message("Unable to write the text trace file.");
+    else
+        gui_set_status_message("Binary trace converted to text", 3000);
+}
+
 static void trace_logger_menu(void)
 {
     ImGui::BeginMenuBar();
@@ -513,6 +608,11 @@ static void trace_logger_menu(void)
             gui_file_dialog_save_log();
         }
 
+        if (ImGui::MenuItem("Convert Binary Trace..."))
+        {
+            gui_file_dialog_convert_binary_log();
+        }
+
         ImGui::EndMenu();
     }
 
@@ -699,14 +799,17 @@ static bool trace_logger_start_disk(void)
     if (!emu_is_empty())
         rom_name = emu_get_core()->GetCartridge()->GetFileName();
 
+    bool binary = config_debug.trace_disk_format == gui_TraceDiskFormat_Binary;
+    const char* extension = binary ? "gbtrace" : "txt";
+
     bool path_available = false;
     for (int index = 0; index < 1000; index++)
     {
         char filename[1024];
         if (index == 0)
-            snprintf(filename, sizeof(filename), "%s - Trace - %s.txt", rom_name, date_time);
+            snprintf(filename, sizeof(filename), "%s - Trace - %s.%s", rom_name, date_time, extension);
         else
-            snprintf(filename, sizeof(filename), "%s - Trace - %s (%d).txt", rom_name, date_time, index + 1);
+            snprintf(filename, sizeof(filename), "%s - Trace - %s (%d).%s", rom_name, date_time, index + 1, extension);
 
         if (!join_path(directory, filename, trace_logger_disk_path, sizeof(trace_logger_disk_path)))
         {
@@ -743,6 +846,14 @@ static bool trace_logger_start_disk(void)
     trace_logger_disk_limit_reached = false;
     trace_logger_disk_overflow = false;
     trace_logger_disk_last_flush = SDL_GetTicks();
+
+    if (binary)
+    {
+        u8 header[GB_TRACE_BINARY_HEADER_SIZE];
+        trace_logger_binary_write_header(header);
+        trace_logger_write_disk(header, sizeof(header));
+    }
+
     emu_get_core()->GetTraceLogger()->Reset();
     gui_set_status_message("Trace recording started", 3000);
     return true;
@@ -818,36 +929,45 @@ static bool trace_logger_flush_disk_entries(void)
         return false;
     }
     u32 first = (u32)(trace_logger_disk_flushed_total - oldest);
+    bool binary = config_debug.trace_disk_format == gui_TraceDiskFormat_Binary;
+    u64 max_size = k_trace_logger_disk_sizes[config_debug.trace_disk_size];
     char entry_text[GB_TRACE_FORMAT_BUFFER_SIZE];
     char line[GB_TRACE_FORMAT_BUFFER_SIZE + 64];
+    u8 record[GB_TRACE_BINARY_RECORD_SIZE];
 
     for (u32 i = first; i < count; i++)
     {
         const GB_Trace_Entry& entry = tl->GetEntry(i);
-        format_entry_text(entry, config_debug.trace_cycles,
-                          trace_logger_disk_previous_cycle_valid,
-                          trace_logger_disk_previous_cycle, entry_text, sizeof(entry_text));
-        int length;
-        if (config_debug.trace_counter)
-            length = snprintf(line, sizeof(line), "%06llu %s\n", (unsigned long long)trace_logger_disk_entries, entry_text);
+        const void* data = record;
+        size_t data_size = sizeof(record);
+
+        if (binary)
+            trace_logger_binary_encode(entry, record);
         else
-            length = snprintf(line, sizeof(line), "%s\n", entry_text);
-        if (length < 0)
-            return false;
+        {
+            format_entry_text(entry, config_debug.trace_cycles,
+                              trace_logger_disk_previous_cycle_valid,
+                              trace_logger_disk_previous_cycle, entry_text, sizeof(entry_text));
+            int length;
+            if (config_debug.trace_counter)
+                length = snprintf(line, sizeof(line), "%06llu %s\n", (unsigned long long)trace_logger_disk_entries, entry_text);
+            else
+                length = snprintf(line, sizeof(line), "%s\n", entry_text);
+            if (length < 0)
+                return false;
 
-        size_t line_size = MIN((size_t)length, sizeof(line) - 1);
-        u64 max_size = k_trace_logger_disk_sizes[config_debug.trace_disk_size];
-        if (max_size > 0 && trace_logger_disk_bytes + (u64)line_size > max_size)
+            data = line;
+            data_size = MIN((size_t)length, sizeof(line) - 1);
+        }
+
+        if (max_size > 0 && trace_logger_disk_bytes + (u64)data_size > max_size)
         {
             trace_logger_disk_limit_reached = true;
             break;
         }
-        if (trace_logger_disk_buffer_used + line_size > sizeof(trace_logger_disk_buffer) && !trace_logger_flush_disk_buffer(false))
+        if (!trace_logger_write_disk(data, data_size))
             return false;
-        memcpy(trace_logger_disk_buffer + trace_logger_disk_buffer_used, line, line_size);
-        trace_logger_disk_buffer_used += line_size;
         trace_logger_disk_entries++;
-        trace_logger_disk_bytes += (u64)line_size;
         trace_logger_disk_previous_cycle = entry.cycle;
         trace_logger_disk_previous_cycle_valid = true;
     }
@@ -856,6 +976,16 @@ static bool trace_logger_flush_disk_entries(void)
     return true;
 }
 
+static bool trace_logger_write_disk(const void* data, size_t size)
+{
+    if (trace_logger_disk_buffer_used + size > sizeof(trace_logger_disk_buffer) && !trace_logger_flush_disk_buffer(false))
+        return false;
+    memcpy(trace_logger_disk_buffer + trace_logger_disk_buffer_used, data, size);
+    trace_logger_disk_buffer_used += size;
+    trace_logger_disk_bytes += (u64)size;
+    return true;
+}
+
 static void trace_logger_sync_flags(void)
 {
     TraceLogger* tl = emu_get_core()->GetTraceLogger();
@@ -1001,9 +1131,12 @@ static void render_cpu_entry_colored(const GB_Trace_Entry& entry, int prefix_len
                  (f & FLAG_CARRY) ? 'C' : 'c');
     }
 
-    if (entry.cpu.name[0] != 0)
+    char name[64];
+    trace_logger_format_cpu_name(entry, name, sizeof(name));
+
+    if (name[0] != 0)
     {
-        std::string instr = entry.cpu.name;
+        std::string instr = name;
         size_t pos;
         pos = instr.find("{n}");
         if (pos != std::string::npos)
@@ -61,7 +61,9 @@ enum FileDialogID
     FileDialog_LoadMemoryDumpBinary,
     FileDialog_SaveDisassemblerFull,
     FileDialog_SaveDisassemblerVisible,
+    FileDialog_SaveCollapsedStacks,
     FileDialog_SaveLog,
+    FileDialog_ConvertBinaryLog,
     FileDialog_SaveDebugSettings,
     FileDialog_LoadDebugSettings,
     FileDialog_LoadDmgBootrom,
@@ -287,6 +289,15 @@ void gui_file_dialog_save_disassembler(bool full)
     SDL_ShowSaveFileDialog(file_dialog_callback, (void*)(intptr_t)id, application_sdl_window, filters, 1, NULL);
 }
 
+void gui_file_dialog_save_collapsed_stacks(void)
+{
+    if (!begin_dialog())
+        return;
+
+    SDL_DialogFileFilter filters[] = { { "Collapsed Stack Files", "folded" } };
+    SDL_ShowSaveFileDialog(file_dialog_callback, (void*)(intptr_t)FileDialog_SaveCollapsedStacks, application_sdl_window, filters, 1, NULL);
+}
+
 void gui_file_dialog_save_log(void)
 {
     if (!begin_dialog())
@@ -296,6 +307,15 @@ void gui_file_dialog_save_log(void)
     SDL_ShowSaveFileDialog(file_dialog_callback, (void*)(intptr_t)FileDialog_SaveLog, application_sdl_window, filters, 1, NULL);
 }
 
+void gui_file_dialog_convert_binary_log(void)
+{
+    if (!begin_dialog())
+        return;
+
+    SDL_DialogFileFilter filters[] = { { "Binary Trace Files", "gbtrace" } };
+    SDL_ShowOpenFileDialog(file_dialog_callback, (void*)(intptr_t)FileDialog_ConvertBinaryLog, application_sdl_window, filters, 1, NULL, false);
+}
+
 void gui_file_dialog_save_debug_settings(void)
 {
     if (!begin_dialog())
@@ -521,11 +541,21 @@ static void process_dialog_result(FileDialogID id, const char* path)
             gui_debug_save_disassembler(path, false);
             break;
         }
+        case FileDialog_SaveCollapsedStacks:
+        {
+            gui_debug_save_collapsed_stacks(path);
+            break;
+        }
         case FileDialog_SaveLog:
         {
             gui_debug_save_log(path);
             break;
         }
+        case FileDialog_ConvertBinaryLog:
+        {
+            gui_debug_convert_binary_log(path);
+            break;
+        }
         case FileDialog_SaveDebugSettings:
         {
             gui_debug_save_settings(path);
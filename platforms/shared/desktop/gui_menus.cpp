@@ -224,6 +224,9 @@ static void menu_gearboy(void)
 
             ImGui::PushItemWidth(140.0f);
             ImGui::SliderFloat("Speed", &config_rewind.speed, 1.0f, 8.0f, "%.0fx");
+            ImGui::SliderInt("Memory", &config_rewind.memory_budget_mb, REWIND_MIN_BUDGET_MB, REWIND_MAX_BUDGET_MB, "%d MB");
+            if (ImGui::IsItemDeactivatedAfterEdit())
+                rewind_reset();
             ImGui::PopItemWidth();
 
             ImGui::EndMenu();
@@ -247,6 +250,16 @@ static void menu_gearboy(void)
             ImGui::EndMenu();
         }
 
+        ImGui::MenuItem("Emulation Thread", "", &config_emulator.emulation_thread);
+
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::BeginTooltip();
+            ImGui::Text("Runs the emulator on its own thread, paced by audio or by the frame time.");
+            ImGui::Text("The screen shows the newest finished frame, input is applied before the next one.");
+            ImGui::EndTooltip();
+        }
+
         ImGui::Separator();
 
         bool has_ram = media_actions_enabled && emu_get_core()->GetCartridge()->HasRam();
@@ -1441,6 +1454,7 @@ static void menu_debug(void)
         ImGui::Separator();
 
         ImGui::MenuItem("Show Rewind", "", &config_debug.show_rewind, config_debug.debug);
+        ImGui::MenuItem("Show Profiler", "", &config_debug.show_profiler, config_debug.debug);
 
 #if defined(__APPLE__) || defined(_WIN32)
         ImGui::Separator();
@@ -68,6 +68,7 @@ int main(int argc, char* argv[])
             else if (strcmp(argv[i], "--mcp-stdio") == 0)
             {
                 g_mcp_stdio_mode = true;
+                Log_set_quiet(true);
                 mcp_stdio_set = true;
                 app_params.mcp_mode = 0;
             }
@@ -373,6 +373,9 @@ void DebugAdapter::WriteMemoryArea(int area, u32 offset, const std::vector<u8>&
     {
         info.data[offset + i] = data[i];
     }
+
+    m_core->GetVideo()->InvalidateTileCache();
+    m_core->GetSGB()->InvalidateBorderCache();
 }
 
 std::vector<DisasmLine> DebugAdapter::GetDisassembly(u16 start_address, u16 end_address, int bank, bool resolve_symbols)
@@ -1590,6 +1593,8 @@ json DebugAdapter::GetRewindStatus()
     result["capacity"] = rewind_get_capacity();
     result["frames_per_snapshot"] = rewind_get_frames_per_snapshot();
     result["buffer_seconds"] = config_rewind.buffer_seconds;
+    result["memory_usage"] = rewind_get_memory_usage();
+    result["memory_budget"] = rewind_get_memory_budget();
 
     int fps = rewind_get_frames_per_snapshot();
     if (fps < 1)
@@ -2717,7 +2722,8 @@ json DebugAdapter::GetTraceLog(s64 start, int count)
 
 json DebugAdapter::SetTraceLog(bool enabled, u32 flags, const std::string& output,
     const std::string& memory_size, const std::string& disk_size,
-    const std::string& output_path, const u32* event_filters)
+    const std::string& disk_format, const std::string& output_path,
+    const u32* event_filters)
 {
     json result;
 
@@ -2766,12 +2772,24 @@ json DebugAdapter::SetTraceLog(bool enabled, u32 flags, const std::string& outpu
             }
         }
 
+        int disk_format_value = config_debug.trace_disk_format;
+        if (!disk_format.empty())
+        {
+            disk_format_value = gui_debug_trace_logger_disk_format_index(disk_format.c_str());
+            if (disk_format_value < 0)
+            {
+                result["error"] = "Invalid trace disk format";
+                return result;
+            }
+        }
+
         bool configuration_changed = output_value != config_debug.trace_output;
         if (output_value == gui_TraceOutput_Memory)
             configuration_changed = configuration_changed || memory_size_value != config_debug.trace_capacity;
         else
         {
             configuration_changed = configuration_changed || disk_size_value != config_debug.trace_disk_size;
+            configuration_changed = configuration_changed || disk_format_value != config_debug.trace_disk_format;
             if (!output_path.empty())
             {
                 configuration_changed = configuration_changed ||
@@ -2788,7 +2806,7 @@ json DebugAdapter::SetTraceLog(bool enabled, u32 flags, const std::string& outpu
 
         if (!gui_debug_trace_logger_is_enabled())
         {
-            if (!gui_debug_trace_logger_configure(output_value, memory_size_value, disk_size_value, output_path.c_str()))
+            if (!gui_debug_trace_logger_configure(output_value, memory_size_value, disk_size_value, disk_format_value, output_path.c_str()))
             {
                 result["error"] = "Unable to configure trace logger";
                 return result;
@@ -2807,6 +2825,7 @@ json DebugAdapter::SetTraceLog(bool enabled, u32 flags, const std::string& outpu
         result["output"] = config_debug.trace_output == gui_TraceOutput_Disk ? "disk" : "memory";
         result["memory_size"] = gui_debug_trace_logger_memory_size_name(config_debug.trace_capacity);
         result["disk_size"] = gui_debug_trace_logger_disk_size_name(config_debug.trace_disk_size);
+        result["disk_format"] = gui_debug_trace_logger_disk_format_name(config_debug.trace_disk_format);
         if (config_debug.trace_output == gui_TraceOutput_Disk)
             result["output_path"] = gui_debug_trace_logger_get_output_path();
 
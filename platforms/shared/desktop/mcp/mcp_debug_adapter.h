@@ -177,7 +177,8 @@ public:
     json GetTraceLog(s64 start, int count);
     json SetTraceLog(bool enabled, u32 flags, const std::string& output,
         const std::string& memory_size, const std::string& disk_size,
-        const std::string& output_path, const u32* event_filters);
+        const std::string& disk_format, const std::string& output_path,
+        const u32* event_filters);
 
     // Core access
     GearboyCore* GetCore() { return m_core; }
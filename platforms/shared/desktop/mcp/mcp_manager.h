@@ -135,12 +135,14 @@ public:
         if (m_transport_mode == MCP_TRANSPORT_TCP)
         {
             g_mcp_stdio_mode = false;
+            Log_set_quiet(false);
             Log("[MCP] Starting HTTP transport on %s:%d", m_tcp_address.c_str(), m_tcp_port);
             transport = new HttpTransport(m_tcp_address, m_tcp_port);
         }
         else
         {
             g_mcp_stdio_mode = true;
+            Log_set_quiet(true);
             transport = new StdioTransport();
         }
 
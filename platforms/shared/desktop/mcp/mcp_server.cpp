@@ -1601,13 +1601,18 @@ json McpServer::BuildToolList()
                 {"memory_size", {
                     {"type", "string"},
                     {"description", "Maximum entries retained in memory mode."},
-                    {"enum", json::array({"100K", "500K", "1M", "2M", "5M"})}
+                    {"enum", json::array({"100K", "500K", "1M", "2M", "5M", "10M", "20M"})}
                 }},
                 {"disk_size", {
                     {"type", "string"},
                     {"description", "Maximum disk trace file size."},
                     {"enum", json::array({"10MB", "50MB", "100MB", "250MB", "500MB", "1GB", "unbounded"})}
                 }},
+                {"disk_format", {
+                    {"type", "string"},
+                    {"description", "Disk trace file format. Binary writes packed raw entries with a GBTRACE header."},
+                    {"enum", json::array({"text", "binary"})}
+                }},
                 {"output_path", {
                     {"type", "string"},
                     {"description", "Directory for the automatically named disk trace file."}
@@ -2739,9 +2744,10 @@ json McpServer::ExecuteCommand(const std::string& toolName, const json& argument
         std::string output = arguments.value("output", "");
         std::string memory_size = arguments.value("memory_size", "");
         std::string disk_size = arguments.value("disk_size", "");
+        std::string disk_format = arguments.value("disk_format", "");
         std::string output_path = arguments.value("output_path", "");
         return m_debugAdapter.SetTraceLog(enabled, flags, output, memory_size,
-                                          disk_size, output_path, event_filters);
+                                          disk_size, disk_format, output_path, event_filters);
     }
     else if (normalizedTool == "get_sgb_status")
     {
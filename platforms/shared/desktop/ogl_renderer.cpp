@@ -37,6 +37,39 @@
 #include "ogl_shader_chain.h"
 #include "ogl_shader_program.h"
 
+#if !defined(GL_MAP_PERSISTENT_BIT)
+    #define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#if !defined(GL_MAP_COHERENT_BIT)
+    #define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+#define PBO_STREAM_BUFFERS 2
+#define PBO_STREAM_FENCE_TIMEOUT 1000000000
+
+// Texture uploads go through a pair of pixel buffer objects, the GPU copies
+// from one while the next frame is written into the other. With GL 4.4 or
+// ARB_buffer_storage both stay mapped, otherwise they are orphaned and
+// mapped again on every upload
+struct pbo_stream
+{
+    uint32_t buffers[PBO_STREAM_BUFFERS];
+    void* mapped[PBO_STREAM_BUFFERS];
+    GLsync fences[PBO_STREAM_BUFFERS];
+    int size;
+    int current;
+};
+
+#if !defined(__APPLE__)
+typedef void (GLAD_API_PTR *buffer_storage_proc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+static buffer_storage_proc gl_buffer_storage = NULL;
+#endif
+
+static bool pbo_persistent = false;
+static pbo_stream system_texture_stream;
+static pbo_stream debug_background_stream;
+static pbo_stream debug_tiles_streams[2];
+
 static uint32_t system_texture;
 static uint32_t frame_buffer_object;
 static ShaderPresetSourcePalette applied_shader_source_palette = ShaderPresetSourcePalette_Default;
@@ -44,6 +77,9 @@ static GB_RuntimeInfo current_runtime;
 static OglRendererScreenGeometry screen_geometry;
 static int savestates_texture_slot = -1;
 static u32 savestates_texture_generation = 0;
+static u32 debug_background_texture_generation = 0;
+static u32 debug_tiles_texture_generation = 0;
+static u32 debug_oam_texture_generation = 0;
 
 static uint32_t quad_shader_program = 0;
 static uint32_t quad_vao = 0;
@@ -80,6 +116,10 @@ static void configure_texture_2d(bool filter_linear);
 static void create_texture_2d(uint32_t* texture, int width, int height, int internal_format, uint32_t format, uint32_t type, const void* pixels, bool filter_linear);
 static void resize_texture_2d(uint32_t texture, int width, int height, int internal_format, uint32_t format, uint32_t type, const void* pixels, bool filter_linear);
 static bool check_framebuffer_complete(const char* name);
+static void init_pbo_persistent(void);
+static void create_pbo_stream(pbo_stream* stream, int size);
+static void destroy_pbo_stream(pbo_stream* stream);
+static void upload_texture_2d(pbo_stream* stream, uint32_t texture, int width, int height, uint32_t format, int bytes_per_pixel, const void* pixels);
 
 bool ogl_renderer_init(void)
 {
@@ -100,6 +140,8 @@ bool ogl_renderer_init(void)
 
     glDisable(GL_FRAMEBUFFER_SRGB);
 
+    init_pbo_persistent();
+
     if (!init_shaders())
         return false;
 
@@ -124,11 +166,15 @@ void ogl_renderer_destroy(void)
     glDeleteFramebuffers(1, &frame_buffer_object); 
     glDeleteTextures(1, &ogl_renderer_emu_texture);
     glDeleteTextures(1, &system_texture);
+    destroy_pbo_stream(&system_texture_stream);
     ogl_shader_chain_destroy();
 
     glDeleteTextures(1, &ogl_renderer_emu_debug_vram_background);
     glDeleteTextures(40, ogl_renderer_emu_debug_vram_sprites);
     glDeleteTextures(2, ogl_renderer_emu_debug_vram_tiles);
+    destroy_pbo_stream(&debug_background_stream);
+    for (int b = 0; b < 2; b++)
+        destroy_pbo_stream(&debug_tiles_streams[b]);
     glDeleteTextures(1, &ogl_renderer_emu_savestates);
 
     if (quad_shader_program)
@@ -162,6 +208,10 @@ void ogl_renderer_render(void)
 
     update_savestates_texture();
 
+    // Nothing below touches the core, the emulation thread can have it
+    // while this frame is drawn and swapped
+    emu_unlock_core();
+
     bool use_internal_shader_chain = should_use_internal_shader_chain();
 
     if (use_internal_shader_chain)
@@ -306,7 +356,8 @@ static bool init_ogl_emu(void)
 {
     glGenFramebuffers(1, &frame_buffer_object);
     create_texture_2d(&ogl_renderer_emu_texture, FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT, GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, NULL, false);
-    create_texture_2d(&system_texture, SYSTEM_TEXTURE_WIDTH, SYSTEM_TEXTURE_HEIGHT, GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, (GLvoid*) emu_frame_buffer, false);
+    create_texture_2d(&system_texture, SYSTEM_TEXTURE_WIDTH, SYSTEM_TEXTURE_HEIGHT, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*) emu_frame_buffer, false);
+    create_pbo_stream(&system_texture_stream, SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * 4);
 
     glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer_object);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ogl_renderer_emu_texture, 0);
@@ -329,6 +380,10 @@ static void init_ogl_debug(void)
 
     for (int b = 0; b < 2; b++)
         create_texture_2d(&ogl_renderer_emu_debug_vram_tiles[b], 128, 256, GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, NULL, false);
+
+    create_pbo_stream(&debug_background_stream, 256 * 256 * 3);
+    for (int b = 0; b < 2; b++)
+        create_pbo_stream(&debug_tiles_streams[b], 16 * 8 * 24 * 8 * 3);
 }
 
 static void init_ogl_savestates(void)
@@ -482,22 +537,22 @@ static void render_emu_normal(void)
 
 static void update_system_texture(void)
 {
-    glBindTexture(GL_TEXTURE_2D, system_texture);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, current_runtime.screen_width, current_runtime.screen_height,
-            GL_RGB, GL_UNSIGNED_BYTE, (GLvoid*) emu_frame_buffer);
+    upload_texture_2d(&system_texture_stream, system_texture, current_runtime.screen_width, current_runtime.screen_height,
+            GL_RGBA, 4, emu_frame_buffer);
 }
 
 static void update_debug_textures(void)
 {
-    if (config_debug.show_video_nametable)
+    if (config_debug.show_video_nametable && (debug_background_texture_generation != emu_debug_background_generation))
     {
-        glBindTexture(GL_TEXTURE_2D, ogl_renderer_emu_debug_vram_background);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 256,
-            GL_RGB, GL_UNSIGNED_BYTE, (GLvoid*) emu_debug_background_buffer);
+        debug_background_texture_generation = emu_debug_background_generation;
+        upload_texture_2d(&debug_background_stream, ogl_renderer_emu_debug_vram_background, 256, 256,
+            GL_RGB, 3, emu_debug_background_buffer);
     }
 
-    if (config_debug.show_video_sprites)
+    if (config_debug.show_video_sprites && (debug_oam_texture_generation != emu_debug_oam_generation))
     {
+        debug_oam_texture_generation = emu_debug_oam_generation;
         for (int s = 0; s < 40; s++)
         {
             glBindTexture(GL_TEXTURE_2D, ogl_renderer_emu_debug_vram_sprites[s]);
@@ -506,13 +561,13 @@ static void update_debug_textures(void)
         }
     }
 
-    if (config_debug.show_video_tiles)
+    if (config_debug.show_video_tiles && (debug_tiles_texture_generation != emu_debug_tiles_generation))
     {
+        debug_tiles_texture_generation = emu_debug_tiles_generation;
         for (int b = 0; b < 2; b++)
         {
-            glBindTexture(GL_TEXTURE_2D, ogl_renderer_emu_debug_vram_tiles[b]);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 16 * 8, 24 * 8,
-                    GL_RGB, GL_UNSIGNED_BYTE, (GLvoid*) emu_debug_tile_buffers[b]);
+            upload_texture_2d(&debug_tiles_streams[b], ogl_renderer_emu_debug_vram_tiles[b], 16 * 8, 24 * 8,
+                    GL_RGB, 3, emu_debug_tile_buffers[b]);
         }
     }
 }
@@ -756,6 +811,140 @@ static void resize_texture_2d(uint32_t texture, int width, int height, int inter
     configure_texture_2d(filter_linear);
 }
 
+static void init_pbo_persistent(void)
+{
+    pbo_persistent = false;
+
+#if !defined(__APPLE__)
+    int major = 0;
+    int minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    bool supported = (major > 4) || ((major == 4) && (minor >= 4));
+
+    if (!supported)
+    {
+        int count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+        for (int i = 0; (i < count) && !supported; i++)
+        {
+            const char* name = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            supported = IsValidPointer(name) && (strcmp(name, "GL_ARB_buffer_storage") == 0);
+        }
+    }
+
+    if (supported)
+        gl_buffer_storage = (buffer_storage_proc) SDL_GL_GetProcAddress("glBufferStorage");
+
+    pbo_persistent = IsValidPointer(gl_buffer_storage);
+#endif
+
+    Log("Texture streaming: %s pixel buffers", pbo_persistent ? "persistent" : "orphaned");
+}
+
+static void create_pbo_stream(pbo_stream* stream, int size)
+{
+    stream->size = size;
+    stream->current = 0;
+    glGenBuffers(PBO_STREAM_BUFFERS, stream->buffers);
+
+    for (int i = 0; i < PBO_STREAM_BUFFERS; i++)
+    {
+        stream->mapped[i] = NULL;
+        stream->fences[i] = NULL;
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[i]);
+
+#if !defined(__APPLE__)
+        if (pbo_persistent)
+        {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            gl_buffer_storage(GL_PIXEL_UNPACK_BUFFER, size, NULL, flags);
+            stream->mapped[i] = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+            continue;
+        }
+#endif
+
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+static void destroy_pbo_stream(pbo_stream* stream)
+{
+    for (int i = 0; i < PBO_STREAM_BUFFERS; i++)
+    {
+        if (IsValidPointer(stream->fences[i]))
+            glDeleteSync(stream->fences[i]);
+
+        if (IsValidPointer(stream->mapped[i]))
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[i]);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+
+        stream->fences[i] = NULL;
+        stream->mapped[i] = NULL;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(PBO_STREAM_BUFFERS, stream->buffers);
+}
+
+static void upload_texture_2d(pbo_stream* stream, uint32_t texture, int width, int height, uint32_t format, int bytes_per_pixel, const void* pixels)
+{
+    int size = width * height * bytes_per_pixel;
+    int index = stream->current;
+    void* dest = NULL;
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    if (size <= stream->size)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stream->buffers[index]);
+
+        if (pbo_persistent)
+        {
+            // Still being read by the upload issued two frames ago
+            if (IsValidPointer(stream->fences[index]))
+            {
+                glClientWaitSync(stream->fences[index], GL_SYNC_FLUSH_COMMANDS_BIT, PBO_STREAM_FENCE_TIMEOUT);
+                glDeleteSync(stream->fences[index]);
+                stream->fences[index] = NULL;
+            }
+
+            dest = stream->mapped[index];
+        }
+        else
+            dest = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    }
+
+    if (!IsValidPointer(dest))
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, pixels);
+        return;
+    }
+
+    memcpy(dest, pixels, size);
+
+    if (!pbo_persistent)
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, NULL);
+
+    if (pbo_persistent)
+        stream->fences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    // Left bound, the PBO would turn the pixel pointers of every later
+    // upload, including ImGui's, into buffer offsets
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    stream->current = (index + 1) % PBO_STREAM_BUFFERS;
+}
+
 static bool check_framebuffer_complete(const char* name)
 {
     uint32_t status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
@@ -18,6 +18,7 @@
  */
 
 #include <string.h>
+#include <vector>
 #include "emu.h"
 #include "config.h"
 #include "gearboy.h"
@@ -26,25 +27,59 @@
 #define REWIND_IMPORT
 #include "rewind.h"
 
-static u8* buffer = NULL;
-static size_t sizes[REWIND_MAX_SNAPSHOTS] = { 0 };
+// Snapshots are stored as XOR deltas against the previous snapshot,
+// run-length encoded so that unchanged bytes cost nothing. At least every
+// REWIND_KEYFRAME_INTERVAL snapshots a keyframe (a delta against an
+// all-zero state) is stored so any snapshot can be rebuilt without
+// walking the whole history. Records live in a circular byte arena
+// bounded by the configured memory budget; when it fills up, the
+// oldest keyframe group is evicted as a whole.
+
+struct rewind_entry
+{
+    size_t offset;
+    u32 encoded_size;
+    u32 raw_size;
+    bool keyframe;
+};
+
+static u8* arena = NULL;
+static size_t arena_size = 0;
+static size_t arena_write = 0;
+static size_t arena_used = 0;
+static std::vector<rewind_entry> entries;
 static int head = 0;
 static int count = 0;
 static int capacity = 0;
+static u64 newest_seq = 0;
+static u8* cursor = NULL;
+static u8* scratch = NULL;
+static u8* encoded = NULL;
+static size_t state_size = 0;
+static size_t encoded_capacity = 0;
+static s64 cursor_seq = -1;
+static int since_keyframe = 0;
 static int frame_accum = 0;
 static bool active = false;
-static bool storage_dirty = true;
 static int seek_age = -1;
-static size_t slot_size = 0;
-static size_t allocated_size = 0;
 
 static int slot_at(int age);
 static int get_target_capacity(void);
-static size_t get_target_slot_size(void);
+static int get_keyframe_interval(void);
+static size_t get_target_arena_size(void);
 static bool ensure_storage(void);
+static bool ensure_state_buffers(size_t size);
 static void release_storage(void);
+static void clear_entries(void);
 static void truncate_to_seek_position(void);
-static void restore_screenshot(const u8* slot, size_t size);
+static void drop_oldest(void);
+static void drop_newest(void);
+static void evict_oldest_group(void);
+static bool reserve(size_t size, size_t* offset);
+static size_t encode_delta(const u8* current, const u8* previous, size_t size, u8* out);
+static bool apply_delta(const rewind_entry& entry, u8* state);
+static bool load_into_cursor(int age);
+static void restore_screenshot(const u8* state, size_t size);
 
 bool rewind_init(void)
 {
@@ -55,24 +90,16 @@ bool rewind_init(void)
 void rewind_destroy(void)
 {
     release_storage();
-    count = 0;
-    head = 0;
+    clear_entries();
     frame_accum = 0;
     active = false;
-    storage_dirty = true;
-    seek_age = -1;
 }
 
 void rewind_reset(void)
 {
-    head = 0;
-    count = 0;
+    clear_entries();
     frame_accum = 0;
     active = false;
-    storage_dirty = true;
-    seek_age = -1;
-    for (int i = 0; i < REWIND_MAX_SNAPSHOTS; i++)
-        sizes[i] = 0;
 
     if (!config_rewind.enabled || emu_is_empty())
     {
@@ -80,7 +107,6 @@ void rewind_reset(void)
         return;
     }
 
-    capacity = get_target_capacity();
     ensure_storage();
 }
 
@@ -88,7 +114,7 @@ void rewind_push(void)
 {
     if (!config_rewind.enabled)
         return;
-    if (!IsValidPointer(buffer))
+    if (!IsValidPointer(arena))
         return;
     if (emu_is_empty() || emu_is_paused())
         return;
@@ -103,51 +129,93 @@ void rewind_push(void)
     if (!ensure_storage())
         return;
 
-    u8* slot = buffer + ((size_t)head * slot_size);
-    size_t size = slot_size;
+    size_t size = 0;
+    if (!emu_get_core()->SaveState(NULL, size, true))
+        return;
+    if (!ensure_state_buffers(size))
+        return;
+    if (!emu_get_core()->SaveState(scratch, size, true))
+    {
+        Log("Rewind: failed to save snapshot (%zu bytes)", size);
+        return;
+    }
+
+    bool keyframe = (count == 0) || (since_keyframe >= get_keyframe_interval() - 1);
 
-    if (!emu_get_core()->SaveState(slot, size, true))
+    if (!keyframe)
     {
-        storage_dirty = true;
-        if (!ensure_storage())
-            return;
+        const rewind_entry& newest = entries[slot_at(0)];
+        keyframe = (newest.raw_size != size) || !load_into_cursor(0);
+    }
+
+    if (count == capacity)
+        evict_oldest_group();
+    if (count == 0)
+        keyframe = true;
 
-        slot = buffer + ((size_t)head * slot_size);
-        size = slot_size;
-        if (!emu_get_core()->SaveState(slot, size, true))
+    size_t encoded_size = encode_delta(scratch, keyframe ? NULL : cursor, size, encoded);
+    size_t offset = 0;
+
+    if (!reserve(encoded_size, &offset))
+    {
+        Log("Rewind: %zu-byte snapshot does not fit in a %zu-byte budget", encoded_size, arena_size);
+        return;
+    }
+
+    // Making room may have evicted the snapshot this delta was built against
+    if (!keyframe && (count == 0))
+    {
+        keyframe = true;
+        encoded_size = encode_delta(scratch, NULL, size, encoded);
+
+        if (!reserve(encoded_size, &offset))
         {
-            Log("Rewind: failed to save snapshot into %zu-byte slot", slot_size);
+            Log("Rewind: %zu-byte snapshot does not fit in a %zu-byte budget", encoded_size, arena_size);
             return;
         }
     }
 
-    sizes[head] = size;
+    memcpy(arena + offset, encoded, encoded_size);
+    arena_write = offset + encoded_size;
+    arena_used += encoded_size;
+
+    rewind_entry& entry = entries[head];
+    entry.offset = offset;
+    entry.encoded_size = (u32)encoded_size;
+    entry.raw_size = (u32)size;
+    entry.keyframe = keyframe;
+
     head = (head + 1) % capacity;
-    if (count < capacity)
-        count++;
+    count++;
+    newest_seq++;
+    since_keyframe = keyframe ? 0 : since_keyframe + 1;
+
+    memcpy(cursor, scratch, size);
+    cursor_seq = (s64)newest_seq;
 }
 
 bool rewind_pop(void)
 {
     if (count == 0)
         return false;
-    if (!IsValidPointer(buffer))
+    if (!IsValidPointer(arena))
         return false;
 
-    int idx = slot_at(0);
-    const u8* slot = buffer + ((size_t)idx * slot_size);
-    size_t size = sizes[idx];
-
-    bool ok = emu_get_core()->LoadState(slot, size);
+    size_t size = entries[slot_at(0)].raw_size;
+    bool ok = load_into_cursor(0);
 
     if (ok)
     {
-        restore_screenshot(slot, size);
-        events_sync_input();
+        ok = emu_get_core()->LoadState(cursor, size);
+
+        if (ok)
+        {
+            restore_screenshot(cursor, size);
+            events_sync_input();
+        }
     }
 
-    head = idx;
-    count--;
+    drop_newest();
     seek_age = -1;
     return ok;
 }
@@ -176,25 +244,30 @@ int rewind_get_snapshot_count(void)
 
 size_t rewind_get_memory_usage(void)
 {
-    return allocated_size;
+    return arena_used + (state_size * 2) + encoded_capacity;
+}
+
+size_t rewind_get_memory_budget(void)
+{
+    return arena_size;
 }
 
 bool rewind_seek(int age)
 {
     if (age < 0 || age >= count)
         return false;
-    if (!IsValidPointer(buffer))
+    if (!IsValidPointer(arena))
         return false;
 
-    int idx = slot_at(age);
-    const u8* slot = buffer + ((size_t)idx * slot_size);
-    size_t size = sizes[idx];
+    if (!load_into_cursor(age))
+        return false;
 
-    bool ok = emu_get_core()->LoadState(slot, size);
+    size_t size = entries[slot_at(age)].raw_size;
+    bool ok = emu_get_core()->LoadState(cursor, size);
 
     if (ok)
     {
-        restore_screenshot(slot, size);
+        restore_screenshot(cursor, size);
         events_sync_input();
         seek_age = age;
     }
@@ -235,16 +308,17 @@ static int get_target_capacity(void)
     return target;
 }
 
-static size_t get_target_slot_size(void)
+static int get_keyframe_interval(void)
 {
-    if (emu_is_empty())
-        return 0;
-
-    size_t target_slot_size = 0;
-    if (!emu_get_core()->SaveState(NULL, target_slot_size, true))
-        return 0;
+    // Short histories get denser keyframes so evicting the oldest
+    // group never throws away more than a small part of the buffer
+    return CLAMP(capacity / 8, 1, REWIND_KEYFRAME_INTERVAL);
+}
 
-    return target_slot_size;
+static size_t get_target_arena_size(void)
+{
+    int mb = CLAMP(config_rewind.memory_budget_mb, REWIND_MIN_BUDGET_MB, REWIND_MAX_BUDGET_MB);
+    return (size_t)mb * 1024 * 1024;
 }
 
 static bool ensure_storage(void)
@@ -256,55 +330,91 @@ static bool ensure_storage(void)
     }
 
     int target_capacity = get_target_capacity();
-    if (!storage_dirty && IsValidPointer(buffer) && (capacity == target_capacity))
+    size_t target_arena_size = get_target_arena_size();
+
+    if (IsValidPointer(arena) && (capacity == target_capacity) && (arena_size == target_arena_size))
         return true;
 
-    size_t target_slot_size = get_target_slot_size();
-    if (target_slot_size == 0)
+    u8* new_arena = new (std::nothrow) u8[target_arena_size];
+    if (!IsValidPointer(new_arena))
+    {
+        Log("Rewind: failed to allocate %zu bytes", target_arena_size);
         return false;
+    }
 
-    if (storage_dirty && IsValidPointer(buffer) && (capacity == target_capacity) && (slot_size >= target_slot_size))
-    {
-        storage_dirty = false;
+    SafeDeleteArray(arena);
+    arena = new_arena;
+    arena_size = target_arena_size;
+    capacity = target_capacity;
+    entries.assign(capacity, rewind_entry());
+    clear_entries();
+
+    Log("Rewind: allocated %.1f MB delta buffer (up to %d snapshots)",
+        (double)target_arena_size / (1024.0 * 1024.0), target_capacity);
+
+    return true;
+}
+
+static bool ensure_state_buffers(size_t size)
+{
+    if (size <= state_size)
         return true;
-    }
 
-    size_t target_size = (size_t)target_capacity * target_slot_size;
-    u8* new_buffer = new (std::nothrow) u8[target_size];
-    if (!IsValidPointer(new_buffer))
+    // Worst case is one literal run covering the whole state plus two
+    // 5-byte varint run headers.
+    size_t new_encoded_capacity = size + 16;
+
+    u8* new_cursor = new (std::nothrow) u8[size];
+    u8* new_scratch = new (std::nothrow) u8[size];
+    u8* new_encoded = new (std::nothrow) u8[new_encoded_capacity];
+
+    if (!IsValidPointer(new_cursor) || !IsValidPointer(new_scratch) || !IsValidPointer(new_encoded))
     {
-        Log("Rewind: failed to allocate %zu bytes", target_size);
+        SafeDeleteArray(new_cursor);
+        SafeDeleteArray(new_scratch);
+        SafeDeleteArray(new_encoded);
+        Log("Rewind: failed to allocate %zu-byte state buffers", size);
         return false;
     }
 
-    SafeDeleteArray(buffer);
-    buffer = new_buffer;
-    allocated_size = target_size;
-    slot_size = target_slot_size;
-    capacity = target_capacity;
-    head = 0;
-    count = 0;
-    frame_accum = 0;
-    active = false;
-    storage_dirty = false;
-    seek_age = -1;
-    for (int i = 0; i < REWIND_MAX_SNAPSHOTS; i++)
-        sizes[i] = 0;
-
-    Log("Rewind: allocated %.1f MB ring buffer (%d snapshots, %zu-byte slots)",
-        (double)target_size / (1024.0 * 1024.0), target_capacity, target_slot_size);
+    SafeDeleteArray(cursor);
+    SafeDeleteArray(scratch);
+    SafeDeleteArray(encoded);
+    cursor = new_cursor;
+    scratch = new_scratch;
+    encoded = new_encoded;
+    state_size = size;
+    encoded_capacity = new_encoded_capacity;
+    cursor_seq = -1;
 
     return true;
 }
 
 static void release_storage(void)
 {
-    SafeDeleteArray(buffer);
-    allocated_size = 0;
-    slot_size = 0;
+    SafeDeleteArray(arena);
+    SafeDeleteArray(cursor);
+    SafeDeleteArray(scratch);
+    SafeDeleteArray(encoded);
+    entries.clear();
+    arena_size = 0;
+    state_size = 0;
+    encoded_capacity = 0;
     capacity = 0;
 }
 
+static void clear_entries(void)
+{
+    head = 0;
+    count = 0;
+    newest_seq = 0;
+    arena_write = 0;
+    arena_used = 0;
+    cursor_seq = -1;
+    since_keyframe = 0;
+    seek_age = -1;
+}
+
 static void truncate_to_seek_position(void)
 {
     if (seek_age <= 0)
@@ -313,26 +423,300 @@ static void truncate_to_seek_position(void)
         return;
     }
 
-    int idx = slot_at(seek_age);
-    head = (idx + 1) % capacity;
-    count -= seek_age;
+    for (int i = 0; i < seek_age; i++)
+        drop_newest();
+
     seek_age = -1;
 }
 
-static void restore_screenshot(const u8* slot, size_t size)
+static void drop_oldest(void)
+{
+    if (count == 0)
+        return;
+
+    const rewind_entry& entry = entries[slot_at(count - 1)];
+    arena_used -= entry.encoded_size;
+    count--;
+
+    if (count == 0)
+        clear_entries();
+}
+
+static void drop_newest(void)
+{
+    if (count == 0)
+        return;
+
+    const rewind_entry& entry = entries[slot_at(0)];
+    arena_used -= entry.encoded_size;
+    arena_write = entry.offset;
+
+    // The cursor can follow a delta backwards for free, so the next push
+    // or pop does not have to rebuild from the keyframe.
+    if ((cursor_seq == (s64)newest_seq) && !entry.keyframe && apply_delta(entry, cursor))
+        cursor_seq--;
+    else if (cursor_seq >= (s64)newest_seq)
+        cursor_seq = -1;
+
+    head = slot_at(0);
+    count--;
+    newest_seq--;
+
+    if (count == 0)
+    {
+        clear_entries();
+        return;
+    }
+
+    // Recompute how far the new newest snapshot is from its keyframe
+    since_keyframe = 0;
+    while ((since_keyframe < count - 1) && !entries[slot_at(since_keyframe)].keyframe)
+        since_keyframe++;
+}
+
+static void evict_oldest_group(void)
+{
+    // Deltas are useless without the keyframe that anchors them, so evict
+    // up to (but not including) the next keyframe.
+    drop_oldest();
+
+    while ((count > 0) && !entries[slot_at(count - 1)].keyframe)
+        drop_oldest();
+}
+
+static bool reserve(size_t size, size_t* offset)
+{
+    if (size >= arena_size)
+        return false;
+
+    for (;;)
+    {
+        if (count == 0)
+        {
+            arena_write = 0;
+            *offset = 0;
+            return true;
+        }
+
+        size_t tail = entries[slot_at(count - 1)].offset;
+
+        if (arena_write > tail)
+        {
+            if (arena_write + size <= arena_size)
+            {
+                *offset = arena_write;
+                return true;
+            }
+            if (size < tail)
+            {
+                *offset = 0;
+                return true;
+            }
+        }
+        else if (arena_write + size < tail)
+        {
+            *offset = arena_write;
+            return true;
+        }
+
+        evict_oldest_group();
+    }
+}
+
+static void write_varint(u8*& out, size_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (u8)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (u8)value;
+}
+
+static size_t read_varint(const u8*& in, const u8* end)
+{
+    size_t value = 0;
+    int shift = 0;
+
+    while (in < end)
+    {
+        u8 b = *in++;
+        value |= (size_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            break;
+        shift += 7;
+    }
+
+    return value;
+}
+
+// Encodes (current ^ previous) as a list of [zero run][literal run][literal bytes].
+// Short zero runs are folded into literals since their header would cost more.
+static size_t encode_delta(const u8* current, const u8* previous, size_t size, u8* out)
+{
+    const int min_zero_run = 4;
+    u8* start = out;
+    size_t i = 0;
+
+    while (i < size)
+    {
+        size_t zeros = 0;
+        while ((i + zeros < size) && ((current[i + zeros] ^ (previous ? previous[i + zeros] : 0)) == 0))
+            zeros++;
+
+        i += zeros;
+        size_t literal_start = i;
+        int zero_streak = 0;
+
+        while (i < size)
+        {
+            u8 x = current[i] ^ (previous ? previous[i] : 0);
+
+            if (x == 0)
+            {
+                zero_streak++;
+                if (zero_streak >= min_zero_run)
+                {
+                    i -= (min_zero_run - 1);
+                    break;
+                }
+            }
+            else
+                zero_streak = 0;
+
+            i++;
+        }
+
+        size_t literals = i - literal_start;
+        if ((i == size) && (zero_streak > 0) && (zero_streak < min_zero_run))
+            literals -= zero_streak;
+
+        write_varint(out, zeros);
+        write_varint(out, literals);
+
+        for (size_t l = 0; l < literals; l++)
+        {
+            size_t p = literal_start + l;
+            *out++ = current[p] ^ (previous ? previous[p] : 0);
+        }
+    }
+
+    return (size_t)(out - start);
+}
+
+static bool apply_delta(const rewind_entry& entry, u8* state)
+{
+    const u8* in = arena + entry.offset;
+    const u8* end = in + entry.encoded_size;
+    size_t size = entry.raw_size;
+    size_t pos = 0;
+
+    if (entry.keyframe)
+        memset(state, 0, size);
+
+    while (in < end)
+    {
+        pos += read_varint(in, end);
+        size_t literals = read_varint(in, end);
+
+        if ((pos + literals > size) || (in + literals > end))
+            return false;
+
+        for (size_t l = 0; l < literals; l++)
+            state[pos + l] ^= in[l];
+
+        in += literals;
+        pos += literals;
+    }
+
+    return true;
+}
+
+// Rebuilds the snapshot at the given age into the cursor buffer, walking
+// from wherever the cursor currently is when that is cheaper than
+// starting again from the keyframe.
+static bool load_into_cursor(int age)
+{
+    if (age < 0 || age >= count || !IsValidPointer(cursor))
+        return false;
+
+    s64 target_seq = (s64)newest_seq - age;
+    const rewind_entry& target = entries[slot_at(age)];
+
+    if (target.raw_size > state_size)
+        return false;
+
+    if (cursor_seq == target_seq)
+        return true;
+
+    int keyframe_age = age;
+    while ((keyframe_age < count - 1) && !entries[slot_at(keyframe_age)].keyframe)
+        keyframe_age++;
+
+    if (!entries[slot_at(keyframe_age)].keyframe)
+        return false;
+
+    s64 keyframe_seq = (s64)newest_seq - keyframe_age;
+
+    if ((cursor_seq > target_seq) && (cursor_seq <= (s64)newest_seq) && ((cursor_seq - target_seq) <= (target_seq - keyframe_seq)))
+    {
+        bool crosses_keyframe = false;
+        for (s64 seq = cursor_seq; seq > target_seq; seq--)
+        {
+            if (entries[slot_at((int)((s64)newest_seq - seq))].keyframe)
+            {
+                crosses_keyframe = true;
+                break;
+            }
+        }
+
+        if (!crosses_keyframe)
+        {
+            for (s64 seq = cursor_seq; seq > target_seq; seq--)
+            {
+                if (!apply_delta(entries[slot_at((int)((s64)newest_seq - seq))], cursor))
+                {
+                    cursor_seq = -1;
+                    return false;
+                }
+            }
+            cursor_seq = target_seq;
+            return true;
+        }
+    }
+
+    s64 from_seq = keyframe_seq;
+
+    if ((cursor_seq >= keyframe_seq) && (cursor_seq < target_seq))
+        from_seq = cursor_seq + 1;
+
+    for (s64 seq = from_seq; seq <= target_seq; seq++)
+    {
+        if (!apply_delta(entries[slot_at((int)((s64)newest_seq - seq))], cursor))
+        {
+            cursor_seq = -1;
+            return false;
+        }
+    }
+
+    cursor_seq = target_seq;
+    return true;
+}
+
+static void restore_screenshot(const u8* state, size_t size)
 {
     if (size <= sizeof(GB_SaveState_Header))
         return;
 
     GB_SaveState_Header header;
-    memcpy(&header, slot + size - sizeof(GB_SaveState_Header), sizeof(header));
+    memcpy(&header, state + size - sizeof(GB_SaveState_Header), sizeof(header));
 
     if (header.magic != GB_SAVESTATE_MAGIC)
         return;
     if (header.screenshot_size == 0)
         return;
 
-    size_t max_screenshot_size = (size_t)SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * sizeof(GB_Color);
+    size_t max_screenshot_size = (size_t)SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * 3;
     if (header.screenshot_size > max_screenshot_size)
         return;
 
@@ -340,7 +724,13 @@ static void restore_screenshot(const u8* slot, size_t size)
         return;
 
     size_t screenshot_offset = size - sizeof(GB_SaveState_Header) - header.screenshot_size;
-    const u8* screenshot_data = slot + screenshot_offset;
+    const u8* screenshot_data = state + screenshot_offset;
 
-    memcpy(emu_frame_buffer, screenshot_data, header.screenshot_size);
+    // Screenshots are stored as RGB24
+    int pixels = (int)(header.screenshot_size / 3);
+    for (int i = 0; i < pixels; i++)
+    {
+        const u8* rgb = &screenshot_data[i * 3];
+        emu_frame_buffer[i] = PackColor32(rgb[0], rgb[1], rgb[2], GB_PIXEL_RGBA8888);
+    }
 }
@@ -28,8 +28,10 @@
     #define EXTERN extern
 #endif
 
-#define REWIND_MAX_STATE_SIZE       (256 * 1024)
-#define REWIND_MAX_SNAPSHOTS        600
+#define REWIND_MAX_SNAPSHOTS        36000
+#define REWIND_KEYFRAME_INTERVAL    60
+#define REWIND_MIN_BUDGET_MB        8
+#define REWIND_MAX_BUDGET_MB        1024
 
 EXTERN bool rewind_init(void);
 EXTERN void rewind_destroy(void);
@@ -44,6 +46,7 @@ EXTERN int rewind_get_snapshot_count(void);
 EXTERN int rewind_get_capacity(void);
 EXTERN int rewind_get_frames_per_snapshot(void);
 EXTERN size_t rewind_get_memory_usage(void);
+EXTERN size_t rewind_get_memory_budget(void);
 
 #undef REWIND_IMPORT
 #undef EXTERN
@@ -25,21 +25,18 @@
 #include "runahead.h"
 
 static u8* runahead_buffer = NULL;
-static s16* runahead_audio = NULL;
 static size_t runahead_buffer_size = 0;
 
 static bool ensure_buffer(void);
 
 void runahead_init(void)
 {
-    runahead_audio = new s16[AUDIO_BUFFER_SIZE];
     runahead_buffer = NULL;
     runahead_buffer_size = 0;
 }
 
 void runahead_destroy(void)
 {
-    SafeDeleteArray(runahead_audio);
     SafeDeleteArray(runahead_buffer);
     runahead_buffer_size = 0;
 }
@@ -54,11 +51,12 @@ int runahead_get_frames(void)
     return frames;
 }
 
-void runahead_run(int frames, u16* frame_buffer, s16* sample_buffer, int* sample_count)
+void runahead_run(int frames, u32* frame_buffer, s16* sample_buffer, int* sample_count)
 {
     GearboyCore* core = emu_get_core();
 
     // Run the authoritative frame, keeping its audio while the real state advances.
+    // It is not rendered, so the fallbacks below show the last composed frame.
     core->RunToVBlank(frame_buffer, sample_buffer, sample_count, false, NULL, false);
 
     // Allocate the reusable snapshot buffer on first use.
@@ -78,13 +76,12 @@ void runahead_run(int frames, u16* frame_buffer, s16* sample_buffer, int* sample
         return;
     }
 
-    // Run the speculative frames with the same input, discarding their audio
-    // and keeping only the last rendered frame.
+    // Run the speculative frames with the same input, without synthesizing
+    // their audio and keeping only the last rendered frame.
     for (int i = 0; i < frames; i++)
     {
-        int discarded_samples = 0;
         bool render = (i == (frames - 1));
-        core->RunToVBlank(frame_buffer, runahead_audio, &discarded_samples, false, NULL, render);
+        core->RunToVBlank(frame_buffer, NULL, NULL, false, NULL, render);
     }
 
     // Roll back to the authoritative frame. If restoring ever fails, the
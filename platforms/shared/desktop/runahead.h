@@ -31,7 +31,7 @@
 EXTERN void runahead_init(void);
 EXTERN void runahead_destroy(void);
 EXTERN int runahead_get_frames(void);
-EXTERN void runahead_run(int frames, u16* frame_buffer, s16* sample_buffer, int* sample_count);
+EXTERN void runahead_run(int frames, u32* frame_buffer, s16* sample_buffer, int* sample_count);
 
 #undef RUNAHEAD_IMPORT
 #undef EXTERN
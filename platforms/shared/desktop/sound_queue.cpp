@@ -18,6 +18,8 @@
  */
 
 #include <string>
+#include <atomic>
+#include <math.h>
 #define SOUND_QUEUE_IMPORT
 #include "sound_queue.h"
 #include "utils.h"
@@ -25,18 +27,39 @@
 #define SOUND_QUEUE_DEBUG(...) { }
 //#define SOUND_QUEUE_DEBUG(x, ...) Debug(x, ## __VA_ARGS__)
 
+// Largest playback speed correction used to hold the queue at its target
+#define SOUND_QUEUE_MAX_RATIO_CORRECTION 0.005f
+#define SOUND_QUEUE_FILL_SMOOTHING 0.05f
+#define SOUND_QUEUE_DRIFT_GAIN 0.00002f
+
 static SDL_AudioStream* sound_queue_stream;
 static bool sound_queue_sound_open;
-static int sound_queue_max_queued_bytes;
+static int sound_queue_max_queued;
 static int sound_queue_buffer_size;
-static int sound_queue_bytes_per_second;
-
+static int sound_queue_channel_count;
+static int sound_queue_samples_per_second;
+static float sound_queue_fill_average;
+static float sound_queue_drift;
+static float sound_queue_ratio;
+
+// Samples go from the emulation thread to the device callback through a
+// single producer, single consumer ring, positions only ever increase
+static s16* sound_queue_ring;
+static u32 sound_queue_ring_size;
+static std::atomic<u32> sound_queue_ring_read;
+static std::atomic<u32> sound_queue_ring_write;
+
+static void SDLCALL sound_queue_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount);
+static int ring_fill(void);
+static void update_ratio(int queued, bool sync);
 static bool is_running_in_wsl(void);
 
 void sound_queue_init(void)
 {
     InitPointer(sound_queue_stream);
+    InitPointer(sound_queue_ring);
     sound_queue_sound_open = false;
+    sound_queue_ring_size = 0;
 
     int audio_drivers_count = SDL_GetNumAudioDrivers();
 
@@ -91,8 +114,21 @@ bool sound_queue_start(int sample_rate, int channel_count, int buffer_size, int
     Debug("Sound Queue: Starting with %d Hz, %d channels, %d buffer size, %d buffers ...", sample_rate, channel_count, buffer_size, buffer_count);
 
     sound_queue_buffer_size = buffer_size;
-    sound_queue_max_queued_bytes = buffer_size * buffer_count * (int)sizeof(s16);
-    sound_queue_bytes_per_second = sample_rate * channel_count * (int)sizeof(s16);
+    sound_queue_channel_count = channel_count;
+    sound_queue_max_queued = buffer_size * buffer_count;
+    sound_queue_samples_per_second = sample_rate * channel_count;
+    sound_queue_fill_average = sound_queue_max_queued * 0.5f;
+    sound_queue_drift = 0.0f;
+    sound_queue_ratio = 1.0f;
+
+    // Twice the queue limit, rounded up so positions wrap with a mask
+    sound_queue_ring_size = 1;
+    while (sound_queue_ring_size < (u32)(sound_queue_max_queued * 2))
+        sound_queue_ring_size <<= 1;
+
+    sound_queue_ring = new s16[sound_queue_ring_size];
+    sound_queue_ring_read.store(0);
+    sound_queue_ring_write.store(0);
 
     SDL_AudioSpec spec;
     spec.freq = sample_rate;
@@ -101,11 +137,12 @@ bool sound_queue_start(int sample_rate, int channel_count, int buffer_size, int
 
     Debug("Sound Queue: Spec - frequency: %d format: 0x%04X channels: %d", spec.freq, spec.format, spec.channels);
 
-    sound_queue_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, NULL, NULL);
+    sound_queue_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, sound_queue_callback, NULL);
 
     if (!sound_queue_stream)
     {
         SDL_ERROR("SDL_OpenAudioDeviceStream");
+        SafeDeleteArray(sound_queue_ring);
         return false;
     }
 
@@ -131,6 +168,8 @@ void sound_queue_stop(void)
             InitPointer(sound_queue_stream);
         }
 
+        SafeDeleteArray(sound_queue_ring);
+
         Debug("Sound Queue: Stopped");
     }
 }
@@ -139,7 +178,7 @@ int sound_queue_get_sample_count(void)
 {
     if (!sound_queue_stream)
         return 0;
-    return SDL_GetAudioStreamQueued(sound_queue_stream) / (int)sizeof(s16);
+    return ring_fill() + (SDL_GetAudioStreamQueued(sound_queue_stream) / (int)sizeof(s16));
 }
 
 bool sound_queue_is_open(void)
@@ -152,8 +191,7 @@ void sound_queue_write(s16* samples, int count, bool sync)
     if (!sound_queue_sound_open || !sound_queue_stream)
         return;
 
-    int bytes = count * (int)sizeof(s16);
-    int queued = SDL_GetAudioStreamQueued(sound_queue_stream);
+    int queued = ring_fill();
 
     if (count > sound_queue_buffer_size)
     {
@@ -167,26 +205,103 @@ void sound_queue_write(s16* samples, int count, bool sync)
 
     if (sync)
     {
-        int room = sound_queue_max_queued_bytes - queued;
-        if (room < bytes)
+        int room = sound_queue_max_queued - queued;
+        if (room < count)
         {
-            SOUND_QUEUE_DEBUG("Sound Queue: Sync wait, need %d bytes but only %d free (queued %d, max %d)", bytes, room, queued, sound_queue_max_queued_bytes);
-            int needed = bytes - room;
-            int wait_ms = (needed * 1000) / sound_queue_bytes_per_second;
+            SOUND_QUEUE_DEBUG("Sound Queue: Sync wait, need %d samples but only %d free (queued %d, max %d)", count, room, queued, sound_queue_max_queued);
+            int needed = count - room;
+            int wait_ms = (needed * 1000) / sound_queue_samples_per_second;
             if (wait_ms >= 1)
                 SDL_Delay(wait_ms);
         }
     }
     else
     {
-        if (queued >= sound_queue_max_queued_bytes)
+        if (queued >= sound_queue_max_queued)
         {
-            SOUND_QUEUE_DEBUG("Sound Queue: Async overrun, dropping frame (queued %d >= max %d)", queued, sound_queue_max_queued_bytes);
+            SOUND_QUEUE_DEBUG("Sound Queue: Async overrun, dropping frame (queued %d >= max %d)", queued, sound_queue_max_queued);
             return;
         }
     }
 
-    SDL_PutAudioStreamData(sound_queue_stream, samples, bytes);
+    update_ratio(queued, sync);
+
+    u32 write = sound_queue_ring_write.load(std::memory_order_relaxed);
+    int room = (int)sound_queue_ring_size - ring_fill();
+
+    if (count > room)
+    {
+        SOUND_QUEUE_DEBUG("Sound Queue: Ring full, dropping %d samples", count - room);
+        count = room - (room % sound_queue_channel_count);
+    }
+
+    u32 start = write & (sound_queue_ring_size - 1);
+    int first = MIN(count, (int)(sound_queue_ring_size - start));
+
+    memcpy(sound_queue_ring + start, samples, first * sizeof(s16));
+    memcpy(sound_queue_ring, samples + first, (count - first) * sizeof(s16));
+
+    sound_queue_ring_write.store(write + (u32)count, std::memory_order_release);
+}
+
+// Runs on the audio device thread whenever the stream needs more data
+static void SDLCALL sound_queue_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount)
+{
+    UNUSED(userdata);
+    UNUSED(total_amount);
+
+    u32 read = sound_queue_ring_read.load(std::memory_order_relaxed);
+    u32 write = sound_queue_ring_write.load(std::memory_order_acquire);
+    int count = MIN((int)(write - read), additional_amount / (int)sizeof(s16));
+    count -= count % sound_queue_channel_count;
+
+    if (count <= 0)
+    {
+        SOUND_QUEUE_DEBUG("Sound Queue: Underrun detected, ring was empty");
+        return;
+    }
+
+    u32 start = read & (sound_queue_ring_size - 1);
+    int first = MIN(count, (int)(sound_queue_ring_size - start));
+
+    SDL_PutAudioStreamData(stream, sound_queue_ring + start, first * (int)sizeof(s16));
+    if (count > first)
+        SDL_PutAudioStreamData(stream, sound_queue_ring, (count - first) * (int)sizeof(s16));
+
+    sound_queue_ring_read.store(read + (u32)count, std::memory_order_release);
+}
+
+static int ring_fill(void)
+{
+    u32 write = sound_queue_ring_write.load(std::memory_order_acquire);
+    u32 read = sound_queue_ring_read.load(std::memory_order_acquire);
+    return (int)(write - read);
+}
+
+// When video paces emulation the queue slowly drifts, so playback speed is
+// nudged within half a percent to hold it at half its limit. The drift term
+// learns the constant clock mismatch between the display and the device.
+// Audio paced emulation blocks on the queue instead and plays at the exact rate.
+static void update_ratio(int queued, bool sync)
+{
+    float ratio = 1.0f;
+
+    if (!sync)
+    {
+        const float max_correction = SOUND_QUEUE_MAX_RATIO_CORRECTION;
+        float target = sound_queue_max_queued * 0.5f;
+        sound_queue_fill_average += (queued - sound_queue_fill_average) * SOUND_QUEUE_FILL_SMOOTHING;
+        float error = CLAMP((sound_queue_fill_average - target) / target, -1.0f, 1.0f);
+        sound_queue_drift = CLAMP(sound_queue_drift + (error * SOUND_QUEUE_DRIFT_GAIN), -max_correction, max_correction);
+        float correction = (error * max_correction) + sound_queue_drift;
+        ratio = 1.0f + CLAMP(correction, -max_correction, max_correction);
+    }
+
+    if ((ratio == 1.0f) ? (sound_queue_ratio != 1.0f) : (fabsf(ratio - sound_queue_ratio) >= 0.0001f))
+    {
+        sound_queue_ratio = ratio;
+        SDL_SetAudioStreamFrequencyRatio(sound_queue_stream, ratio);
+    }
 }
 
 static bool is_running_in_wsl(void)
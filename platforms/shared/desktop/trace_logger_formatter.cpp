@@ -11,6 +11,7 @@
 #include "trace_logger_formatter.h"
 #include "Cartridge.h"
 #include "common.h"
+#include "emu.h"
 #include <cstdio>
 #include <cstring>
 
@@ -328,16 +329,29 @@ static void format_mapper_state(u8 flags, char* buffer, size_t buffer_size)
     if (first) append_list_item(buffer, buffer_size, "none", &first);
 }
 
+void trace_logger_format_cpu_name(const GB_Trace_Entry& entry, char* buffer, size_t buffer_size)
+{
+    if (entry.cpu.size == 0)
+    {
+        buffer[0] = '\0';
+        return;
+    }
+
+    emu_get_core()->GetProcessor()->FormatOPCodeName(entry.cpu.pc, entry.cpu.opcodes, buffer, buffer_size);
+}
+
 static void format_cpu_entry(const GB_Trace_Entry& entry,
     const GB_Trace_Format_Options& options, char* buf, int buf_size)
 {
     char instr[64] = "???";
     char bytes[16] = "";
+    char name[64];
+
+    trace_logger_format_cpu_name(entry, name, sizeof(name));
 
-    if (entry.cpu.name[0] != 0)
+    if (name[0] != 0)
     {
-        strncpy(instr, entry.cpu.name, sizeof(instr) - 1);
-        instr[sizeof(instr) - 1] = '\0';
+        strncpy_fit(instr, name, sizeof(instr));
 
         char* p = instr;
         while (*p)
@@ -692,3 +706,252 @@ void trace_logger_format_entry(const GB_Trace_Entry& entry,
             break;
     }
 }
+
+static u8* put_u8(u8* p, u8 value)
+{
+    p[0] = value;
+    return p + 1;
+}
+
+static u8* put_u16(u8* p, u16 value)
+{
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+    return p + 2;
+}
+
+static u8* put_u32(u8* p, u32 value)
+{
+    p = put_u16(p, value & 0xFFFF);
+    return put_u16(p, value >> 16);
+}
+
+static u8* put_u64(u8* p, u64 value)
+{
+    p = put_u32(p, (u32)(value & 0xFFFFFFFF));
+    return put_u32(p, (u32)(value >> 32));
+}
+
+static const u8* get_u8(const u8* p, u8& value)
+{
+    value = p[0];
+    return p + 1;
+}
+
+static const u8* get_u16(const u8* p, u16& value)
+{
+    value = (u16)(p[0] | (p[1] << 8));
+    return p + 2;
+}
+
+static const u8* get_u32(const u8* p, u32& value)
+{
+    u16 low, high;
+    p = get_u16(p, low);
+    p = get_u16(p, high);
+    value = (u32)low | ((u32)high << 16);
+    return p;
+}
+
+static const u8* get_u64(const u8* p, u64& value)
+{
+    u32 low, high;
+    p = get_u32(p, low);
+    p = get_u32(p, high);
+    value = (u64)low | ((u64)high << 32);
+    return p;
+}
+
+void trace_logger_binary_write_header(u8* buffer)
+{
+    memset(buffer, 0, GB_TRACE_BINARY_HEADER_SIZE);
+    memcpy(buffer, GB_TRACE_BINARY_MAGIC, sizeof(GB_TRACE_BINARY_MAGIC));
+    u8* p = put_u32(buffer + 8, GB_TRACE_BINARY_VERSION);
+    put_u32(p, GB_TRACE_BINARY_RECORD_SIZE);
+}
+
+bool trace_logger_binary_read_header(const u8* buffer)
+{
+    if (memcmp(buffer, GB_TRACE_BINARY_MAGIC, sizeof(GB_TRACE_BINARY_MAGIC)) != 0)
+        return false;
+
+    u32 version, record_size;
+    const u8* p = get_u32(buffer + 8, version);
+    get_u32(p, record_size);
+
+    return (version == GB_TRACE_BINARY_VERSION) && (record_size == GB_TRACE_BINARY_RECORD_SIZE);
+}
+
+void trace_logger_binary_encode(const GB_Trace_Entry& entry, u8* record)
+{
+    memset(record, 0, GB_TRACE_BINARY_RECORD_SIZE);
+    u8* p = put_u64(record, entry.cycle);
+    p = put_u8(p, entry.type);
+
+    switch (entry.type)
+    {
+        case TRACE_CPU:
+            p = put_u16(p, entry.cpu.pc);
+            p = put_u16(p, entry.cpu.bank);
+            p = put_u16(p, entry.cpu.af);
+            p = put_u16(p, entry.cpu.bc);
+            p = put_u16(p, entry.cpu.de);
+            p = put_u16(p, entry.cpu.hl);
+            p = put_u16(p, entry.cpu.sp);
+            p = put_u8(p, entry.cpu.size);
+            p = put_u8(p, entry.cpu.halt_bug);
+            for (int i = 0; i < 4; i++)
+                p = put_u8(p, entry.cpu.opcodes[i]);
+            break;
+        case TRACE_CPU_IRQ:
+            p = put_u16(p, entry.irq.pc);
+            p = put_u16(p, entry.irq.vector);
+            p = put_u8(p, entry.irq.type);
+            break;
+        case TRACE_LCD:
+            p = put_u16(p, entry.lcd.address);
+            p = put_u16(p, entry.lcd.value);
+            p = put_u16(p, entry.lcd.value2);
+            p = put_u16(p, entry.lcd.value3);
+            p = put_u16(p, entry.lcd.length);
+            p = put_u16(p, entry.lcd.line);
+            p = put_u8(p, entry.lcd.reg);
+            p = put_u8(p, entry.lcd.event);
+            p = put_u8(p, entry.lcd.raw);
+            p = put_u8(p, entry.lcd.mode);
+            break;
+        case TRACE_INPUT:
+            p = put_u8(p, entry.input.value);
+            p = put_u8(p, entry.input.result);
+            p = put_u8(p, entry.input.select);
+            p = put_u8(p, entry.input.player);
+            p = put_u8(p, entry.input.event);
+            p = put_u8(p, entry.input.sgb_state);
+            break;
+        case TRACE_TIMER:
+            p = put_u16(p, entry.timer.divider);
+            p = put_u8(p, entry.timer.counter);
+            p = put_u8(p, entry.timer.reload);
+            p = put_u8(p, entry.timer.control);
+            p = put_u8(p, entry.timer.value);
+            p = put_u8(p, entry.timer.event);
+            p = put_u8(p, entry.timer.enabled);
+            break;
+        case TRACE_APU:
+            p = put_u16(p, entry.apu.address);
+            p = put_u8(p, entry.apu.value);
+            p = put_u8(p, entry.apu.effective);
+            p = put_u8(p, entry.apu.event);
+            break;
+        case TRACE_SERIAL:
+            p = put_u8(p, entry.serial.data);
+            p = put_u8(p, entry.serial.control);
+            p = put_u8(p, entry.serial.value);
+            p = put_u8(p, entry.serial.event);
+            p = put_u8(p, entry.serial.internal_clock);
+            break;
+        case TRACE_MAPPER:
+            p = put_u16(p, entry.mapper.address);
+            p = put_u16(p, entry.mapper.rom_bank0);
+            p = put_u16(p, entry.mapper.rom_bank1);
+            p = put_u16(p, (u16)entry.mapper.ram_bank);
+            p = put_u8(p, entry.mapper.value);
+            p = put_u8(p, entry.mapper.mapper);
+            p = put_u8(p, entry.mapper.event);
+            p = put_u8(p, entry.mapper.flags);
+            p = put_u8(p, entry.mapper.flags_valid);
+            break;
+        default:
+            break;
+    }
+}
+
+void trace_logger_binary_decode(const u8* record, GB_Trace_Entry& entry)
+{
+    memset(&entry, 0, sizeof(entry));
+    u8 type;
+    const u8* p = get_u64(record, entry.cycle);
+    p = get_u8(p, type);
+    entry.type = (GB_Trace_Type)type;
+
+    switch (entry.type)
+    {
+        case TRACE_CPU:
+            p = get_u16(p, entry.cpu.pc);
+            p = get_u16(p, entry.cpu.bank);
+            p = get_u16(p, entry.cpu.af);
+            p = get_u16(p, entry.cpu.bc);
+            p = get_u16(p, entry.cpu.de);
+            p = get_u16(p, entry.cpu.hl);
+            p = get_u16(p, entry.cpu.sp);
+            p = get_u8(p, entry.cpu.size);
+            p = get_u8(p, entry.cpu.halt_bug);
+            for (int i = 0; i < 4; i++)
+                p = get_u8(p, entry.cpu.opcodes[i]);
+            break;
+        case TRACE_CPU_IRQ:
+            p = get_u16(p, entry.irq.pc);
+            p = get_u16(p, entry.irq.vector);
+            p = get_u8(p, entry.irq.type);
+            break;
+        case TRACE_LCD:
+            p = get_u16(p, entry.lcd.address);
+            p = get_u16(p, entry.lcd.value);
+            p = get_u16(p, entry.lcd.value2);
+            p = get_u16(p, entry.lcd.value3);
+            p = get_u16(p, entry.lcd.length);
+            p = get_u16(p, entry.lcd.line);
+            p = get_u8(p, entry.lcd.reg);
+            p = get_u8(p, entry.lcd.event);
+            p = get_u8(p, entry.lcd.raw);
+            p = get_u8(p, entry.lcd.mode);
+            break;
+        case TRACE_INPUT:
+            p = get_u8(p, entry.input.value);
+            p = get_u8(p, entry.input.result);
+            p = get_u8(p, entry.input.select);
+            p = get_u8(p, entry.input.player);
+            p = get_u8(p, entry.input.event);
+            p = get_u8(p, entry.input.sgb_state);
+            break;
+        case TRACE_TIMER:
+            p = get_u16(p, entry.timer.divider);
+            p = get_u8(p, entry.timer.counter);
+            p = get_u8(p, entry.timer.reload);
+            p = get_u8(p, entry.timer.control);
+            p = get_u8(p, entry.timer.value);
+            p = get_u8(p, entry.timer.event);
+            p = get_u8(p, entry.timer.enabled);
+            break;
+        case TRACE_APU:
+            p = get_u16(p, entry.apu.address);
+            p = get_u8(p, entry.apu.value);
+            p = get_u8(p, entry.apu.effective);
+            p = get_u8(p, entry.apu.event);
+            break;
+        case TRACE_SERIAL:
+            p = get_u8(p, entry.serial.data);
+            p = get_u8(p, entry.serial.control);
+            p = get_u8(p, entry.serial.value);
+            p = get_u8(p, entry.serial.event);
+            p = get_u8(p, entry.serial.internal_clock);
+            break;
+        case TRACE_MAPPER:
+        {
+            u16 ram_bank;
+            p = get_u16(p, entry.mapper.address);
+            p = get_u16(p, entry.mapper.rom_bank0);
+            p = get_u16(p, entry.mapper.rom_bank1);
+            p = get_u16(p, ram_bank);
+            entry.mapper.ram_bank = (s16)ram_bank;
+            p = get_u8(p, entry.mapper.value);
+            p = get_u8(p, entry.mapper.mapper);
+            p = get_u8(p, entry.mapper.event);
+            p = get_u8(p, entry.mapper.flags);
+            p = get_u8(p, entry.mapper.flags_valid);
+            break;
+        }
+        default:
+            break;
+    }
+}
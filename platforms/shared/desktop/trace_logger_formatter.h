@@ -28,7 +28,23 @@ struct GB_Trace_Format_Options
 
 void trace_log_format_cycle_prefix(const GB_Trace_Entry& entry, bool previous_cycle_valid,
     u64 previous_cycle, char* buffer, size_t buffer_size);
+void trace_logger_format_cpu_name(const GB_Trace_Entry& entry, char* buffer, size_t buffer_size);
 void trace_logger_format_entry(const GB_Trace_Entry& entry,
     const GB_Trace_Format_Options& options, char* buffer, size_t buffer_size);
 
+// Binary disk traces, all fields little-endian:
+//   header: "GBTRACE\0", u32 version, u32 record size
+//   record: u64 cycle, u8 type, then the fields of the GB_Trace_Entry
+//           union member for that type in declaration order, packed and
+//           zero padded to the record size
+#define GB_TRACE_BINARY_MAGIC "GBTRACE"
+#define GB_TRACE_BINARY_VERSION 2
+#define GB_TRACE_BINARY_HEADER_SIZE 16
+#define GB_TRACE_BINARY_RECORD_SIZE 32
+
+void trace_logger_binary_write_header(u8* buffer);
+bool trace_logger_binary_read_header(const u8* buffer);
+void trace_logger_binary_encode(const GB_Trace_Entry& entry, u8* record);
+void trace_logger_binary_decode(const u8* record, GB_Trace_Entry& entry);
+
 #endif /* TRACE_LOGGER_FORMATTER_H */
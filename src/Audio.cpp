@@ -29,6 +29,7 @@ Audio::Audio()
     InitPointer(m_pBuffer);
     InitPointer(m_pSampleBuffer);
     m_bMute = false;
+    m_bOutputEnabled = true;
     m_MasterVolume = 1.0f;
     m_bVgmRecordingEnabled = false;
     for (int i = 0; i < 4; i++)
@@ -113,6 +114,21 @@ void Audio::SetMasterVolume(float volume)
     ApplyVolume();
 }
 
+void Audio::SetOutputEnabled(bool enabled)
+{
+    if (enabled == m_bOutputEnabled)
+        return;
+
+    m_bOutputEnabled = enabled;
+
+    // Without outputs the oscillators still advance their phase, envelopes,
+    // lengths and sweep, so registers and PCM reads stay exact
+    if (enabled)
+        m_pApu->set_output(m_pBuffer->center(), m_pBuffer->left(), m_pBuffer->right());
+    else
+        m_pApu->set_output(NULL, NULL, NULL);
+}
+
 void Audio::ApplyVolume()
 {
     m_pApu->volume(m_bMute ? 0.0f : m_MasterVolume);
@@ -123,21 +139,20 @@ void Audio::EndFrame(s16* pSampleBuffer, int* pSampleCount)
     m_pApu->end_frame(m_ElapsedCycles);
     m_pBuffer->end_frame(m_ElapsedCycles);
 
-    int count = static_cast<int>(m_pBuffer->read_samples(m_pSampleBuffer, AUDIO_BUFFER_SIZE));
+    // Samples are mixed straight into the caller's buffer, the internal one
+    // only drains frames that nobody takes
+    blip_sample_t* out = IsValidPointer(pSampleBuffer) ? pSampleBuffer : m_pSampleBuffer;
+    int count = static_cast<int>(m_pBuffer->read_samples(out, AUDIO_BUFFER_SIZE));
 
     if (IsValidPointer(pSampleBuffer) && IsValidPointer(pSampleCount))
-    {
         *pSampleCount = count;
 
-        for (int i=0; i<count; i++)
-        {
-            pSampleBuffer[i] = m_pSampleBuffer[i];
-        }
+    if (m_pApu->is_debug_enabled())
+    {
+        for (int i = 0; i < 4; i++)
+            m_pApu->read_debug_samples(m_pDebugChannelBuffer[i], i, AUDIO_BUFFER_SIZE, &m_iDebugChannelSamples[i]);
     }
 
-    for (int i = 0; i < 4; i++)
-        m_pApu->read_debug_samples(m_pDebugChannelBuffer[i], i, AUDIO_BUFFER_SIZE, &m_iDebugChannelSamples[i]);
-
     m_ElapsedCycles = 0;
 }
 
@@ -36,6 +36,7 @@ public:
     void Mute(bool mute);
     void SetVolume(float volume);
     void SetMasterVolume(float volume);
+    void SetOutputEnabled(bool enabled);
     u8 ReadAudioRegister(u16 address);
     u8 ReadPCM12();
     u8 ReadPCM34();
@@ -60,6 +61,7 @@ private:
     int m_SampleRate;
     blip_sample_t* m_pSampleBuffer;
     bool m_bMute;
+    bool m_bOutputEnabled;
     float m_MasterVolume;
     bool m_bCGB;
     VgmRecorder m_VgmRecorder;
@@ -116,6 +118,8 @@ inline void Audio::EnablePSGDebug(bool enable)
     else if (!enable && m_pApu->is_debug_enabled())
     {
         m_pApu->disable_debug_buffers();
+        for (int i = 0; i < 4; i++)
+            m_iDebugChannelSamples[i] = 0;
     }
 }
 
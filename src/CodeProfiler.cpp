@@ -0,0 +1,169 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include "CodeProfiler.h"
+
+CodeProfiler::CodeProfiler()
+{
+    m_enabled = false;
+    m_pages = new GB_Code_Profiler_Counter*[CODE_PROFILER_PAGE_COUNT];
+    for (int i = 0; i < CODE_PROFILER_PAGE_COUNT; i++)
+        InitPointer(m_pages[i]);
+    InitPointer(m_current);
+    m_total_cycles = 0;
+    m_current_node = 0;
+    Reset();
+}
+
+CodeProfiler::~CodeProfiler()
+{
+    for (int i = 0; i < CODE_PROFILER_PAGE_COUNT; i++)
+        SafeDeleteArray(m_pages[i]);
+    SafeDeleteArray(m_pages);
+}
+
+void CodeProfiler::Enable(bool enable)
+{
+    if (enable && !m_enabled)
+    {
+        m_enabled = true;
+        RebuildFrames();
+    }
+
+    m_enabled = enable;
+}
+
+void CodeProfiler::Reset()
+{
+    for (int i = 0; i < CODE_PROFILER_PAGE_COUNT; i++)
+        SafeDeleteArray(m_pages[i]);
+
+    InitPointer(m_current);
+    m_total_cycles = 0;
+
+    m_nodes.clear();
+    m_children.clear();
+
+    GB_Code_Profiler_Node root;
+    root.parent = 0;
+    root.address = 0;
+    root.bank = 0;
+    root.cycles = 0;
+    m_nodes.push_back(root);
+
+    RebuildFrames();
+}
+
+// Frames are tracked even while disabled, so enabling or resetting the
+// profiler inside a call still attributes cycles to the right stack
+void CodeProfiler::PushFrame(u16 address, u16 bank)
+{
+    GB_Code_Profiler_Frame frame;
+    frame.address = address;
+    frame.bank = bank;
+    frame.node = m_enabled ? GetChildNode(m_current_node, address, bank) : 0;
+
+    m_frames.push_back(frame);
+    m_current_node = frame.node;
+}
+
+void CodeProfiler::PopFrame()
+{
+    if (m_frames.empty())
+        return;
+
+    m_frames.pop_back();
+    m_current_node = m_frames.empty() ? 0 : m_frames.back().node;
+}
+
+void CodeProfiler::ClearFrames()
+{
+    m_frames.clear();
+    m_current_node = 0;
+}
+
+const GB_Code_Profiler_Counter* CodeProfiler::GetCounter(u16 address, u16 bank) const
+{
+    u32 key = (address >= 0x8000) ? CODE_PROFILER_RAM_BASE + address : (u32)(0x4000 * bank) + (address & 0x3FFF);
+
+    if (key >= CODE_PROFILER_RAM_BASE + 0x10000)
+        return NULL;
+
+    GB_Code_Profiler_Counter* page = m_pages[key >> CODE_PROFILER_PAGE_SHIFT];
+
+    if (!IsValidPointer(page))
+        return NULL;
+
+    return &page[key & (CODE_PROFILER_PAGE_SIZE - 1)];
+}
+
+u64 CodeProfiler::GetTotalCycles() const
+{
+    return m_total_cycles;
+}
+
+const std::vector<GB_Code_Profiler_Node>* CodeProfiler::GetNodes() const
+{
+    return &m_nodes;
+}
+
+// Every distinct call path gets a node, so cycles per node are the self
+// time of that stack and can be written out as collapsed stacks
+u32 CodeProfiler::GetChildNode(u32 parent, u16 address, u16 bank)
+{
+    u64 child_key = ((u64)parent << 32) | ((u64)bank << 16) | address;
+    std::map<u64, u32>::iterator it = m_children.find(child_key);
+
+    if (it != m_children.end())
+        return it->second;
+
+    // Runaway stacks from games that never return stay in the last node
+    if (m_nodes.size() >= CODE_PROFILER_MAX_NODES)
+        return parent;
+
+    GB_Code_Profiler_Node node;
+    node.parent = parent;
+    node.address = address;
+    node.bank = bank;
+    node.cycles = 0;
+
+    u32 index = (u32)m_nodes.size();
+    m_nodes.push_back(node);
+    m_children[child_key] = index;
+    return index;
+}
+
+void CodeProfiler::RebuildFrames()
+{
+    m_current_node = 0;
+
+    for (size_t i = 0; i < m_frames.size(); i++)
+    {
+        m_frames[i].node = m_enabled ? GetChildNode(m_current_node, m_frames[i].address, m_frames[i].bank) : 0;
+        m_current_node = m_frames[i].node;
+    }
+}
+
+GB_Code_Profiler_Counter* CodeProfiler::GetPage(u32 key)
+{
+    GB_Code_Profiler_Counter* page = new GB_Code_Profiler_Counter[CODE_PROFILER_PAGE_SIZE];
+    memset(page, 0, sizeof(GB_Code_Profiler_Counter) * CODE_PROFILER_PAGE_SIZE);
+    m_pages[key >> CODE_PROFILER_PAGE_SHIFT] = page;
+    return page;
+}
@@ -0,0 +1,124 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#ifndef CODE_PROFILER_H
+#define CODE_PROFILER_H
+
+#include <vector>
+#include <map>
+#include "definitions.h"
+
+#define CODE_PROFILER_PAGE_SHIFT 8
+#define CODE_PROFILER_PAGE_SIZE (1 << CODE_PROFILER_PAGE_SHIFT)
+#define CODE_PROFILER_RAM_BASE MAX_ROM_SIZE
+#define CODE_PROFILER_PAGE_COUNT ((MAX_ROM_SIZE + 0x10000) >> CODE_PROFILER_PAGE_SHIFT)
+#define CODE_PROFILER_MAX_NODES 0x10000
+
+struct GB_Code_Profiler_Counter
+{
+    u64 cycles;
+    u64 instructions;
+};
+
+struct GB_Code_Profiler_Node
+{
+    u32 parent;
+    u16 address;
+    u16 bank;
+    u64 cycles;
+};
+
+struct GB_Code_Profiler_Frame
+{
+    u16 address;
+    u16 bank;
+    u32 node;
+};
+
+class CodeProfiler
+{
+public:
+    CodeProfiler();
+    ~CodeProfiler();
+    void Enable(bool enable);
+    INLINE bool IsEnabled() const;
+    void Reset();
+    INLINE void Enter(u16 address, u32 physical_address, bool instruction);
+    INLINE void AddCycles(unsigned int cycles);
+    void PushFrame(u16 address, u16 bank);
+    void PopFrame();
+    void ClearFrames();
+    const GB_Code_Profiler_Counter* GetCounter(u16 address, u16 bank) const;
+    u64 GetTotalCycles() const;
+    const std::vector<GB_Code_Profiler_Node>* GetNodes() const;
+
+private:
+    GB_Code_Profiler_Counter* GetPage(u32 key);
+    u32 GetChildNode(u32 parent, u16 address, u16 bank);
+    void RebuildFrames();
+
+private:
+    bool m_enabled;
+    GB_Code_Profiler_Counter** m_pages;
+    GB_Code_Profiler_Counter* m_current;
+    u64 m_total_cycles;
+    std::vector<GB_Code_Profiler_Node> m_nodes;
+    std::map<u64, u32> m_children;
+    std::vector<GB_Code_Profiler_Frame> m_frames;
+    u32 m_current_node;
+};
+
+INLINE bool CodeProfiler::IsEnabled() const
+{
+    return m_enabled;
+}
+
+// Physical ROM addresses and CPU addresses from 0x8000 up share one
+// key space, the same split the disassembler records use
+INLINE void CodeProfiler::Enter(u16 address, u32 physical_address, bool instruction)
+{
+    u32 key = (address >= 0x8000) ? CODE_PROFILER_RAM_BASE + address : physical_address;
+
+    if (key >= CODE_PROFILER_RAM_BASE + 0x10000)
+    {
+        m_current = NULL;
+        return;
+    }
+
+    GB_Code_Profiler_Counter* page = m_pages[key >> CODE_PROFILER_PAGE_SHIFT];
+
+    if (!IsValidPointer(page))
+        page = GetPage(key);
+
+    m_current = &page[key & (CODE_PROFILER_PAGE_SIZE - 1)];
+
+    if (instruction)
+        m_current->instructions++;
+}
+
+INLINE void CodeProfiler::AddCycles(unsigned int cycles)
+{
+    if (IsValidPointer(m_current))
+        m_current->cycles += cycles;
+
+    m_nodes[m_current_node].cycles += cycles;
+    m_total_cycles += cycles;
+}
+
+#endif /* CODE_PROFILER_H */
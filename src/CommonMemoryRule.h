@@ -83,10 +83,9 @@ inline void CommonMemoryRule::PerformWrite(u16 address, u8 value)
             if (m_pMemory->IsVRAMAccessBlocked())
                 break;
 
-            if (m_bCGB)
-                m_pMemory->WriteCGBLCDRAM(address, value);
-            else
-                m_pMemory->Load(address, value);
+            // Bank 1 is never selected on DMG, this also keeps the
+            // decoded tile cache in sync
+            m_pMemory->WriteCGBLCDRAM(address, value);
             break;
         }
         case 0xC000:
@@ -123,7 +122,7 @@ inline void CommonMemoryRule::PerformWrite(u16 address, u8 value)
             }
             else
             {
-                m_pMemory->Load(address, value);
+                m_pMemory->WriteOAM(address, value);
             }
             break;
         }
@@ -46,7 +46,10 @@
 #include "SachenMMC2MemoryRule.h"
 #include "FlashcartMemoryRule.h"
 #include "TraceLogger.h"
+#include "CodeProfiler.h"
 #include "SGB.h"
+#include "Scheduler.h"
+#include "Profiler.h"
 #include "common.h"
 #include "memory_stream.h"
 
@@ -59,6 +62,8 @@ GearboyCore::GearboyCore()
     InitPointer(m_pInput);
     InitPointer(m_pCartridge);
     InitPointer(m_pSGB);
+    InitPointer(m_pScheduler);
+    InitPointer(m_pProfiler);
     InitPointer(m_pCommonMemoryRule);
     InitPointer(m_pIORegistersMemoryRule);
     InitPointer(m_pRomOnlyMemoryRule);
@@ -80,6 +85,7 @@ GearboyCore::GearboyCore()
     InitPointer(m_pFlashcartMemoryRule);
     InitPointer(m_pRamChangedCallback);
     InitPointer(m_trace_logger);
+    InitPointer(m_pCodeProfiler);
     m_bCGB = false;
     m_bGBA = false;
     m_bSGB = false;
@@ -87,16 +93,19 @@ GearboyCore::GearboyCore()
     m_bForceDMG = false;
     m_bSGBEnabled = true;
     m_bSGBBorder = true;
-    InitPointer(m_pSGBFrameBuffer);
     m_iRTCUpdateCount = 0;
     m_pixelFormat = GB_PIXEL_RGB565;
     m_bColorCorrectionEnabled = false;
+    m_bHaltSkip = true;
     m_pSaveStateFrameBuffer = NULL;
+    m_iSaveStateSize[0] = 0;
+    m_iSaveStateSize[1] = 0;
     m_master_clock_cycles = 0;
 }
 
 GearboyCore::~GearboyCore()
 {
+    SafeDelete(m_pScheduler);
     SafeDelete(m_pMBC5MemoryRule);
     SafeDelete(m_pMBC3MemoryRule);
     SafeDelete(m_pMBC2MemoryRule);
@@ -118,13 +127,16 @@ GearboyCore::~GearboyCore()
     SafeDelete(m_pCommonMemoryRule);
     SafeDelete(m_pCartridge);
     SafeDelete(m_pSGB);
-    SafeDeleteArray(m_pSGBFrameBuffer);
     SafeDelete(m_pInput);
     SafeDelete(m_pAudio);
     SafeDelete(m_pVideo);
     SafeDelete(m_pProcessor);
     SafeDelete(m_pMemory);
     SafeDelete(m_trace_logger);
+#if !defined(GEARBOY_DISABLE_DISASSEMBLER)
+    SafeDelete(m_pCodeProfiler);
+#endif
+    SafeDelete(m_pProfiler);
 }
 
 void GearboyCore::Init(GB_Color_Format pixelFormat)
@@ -140,8 +152,7 @@ void GearboyCore::Init(GB_Color_Format pixelFormat)
     m_pInput = new Input(m_pMemory, m_pProcessor);
     m_pCartridge = new Cartridge();
     m_pSGB = new SGB(m_pMemory, m_pVideo);
-    m_pSGBFrameBuffer = new u16[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
-
+    m_pProfiler = new Profiler();
 
     m_pMemory->Init();
     m_pProcessor->Init();
@@ -151,20 +162,49 @@ void GearboyCore::Init(GB_Color_Format pixelFormat)
     m_pCartridge->Init();
     m_pSGB->Init();
 
+    m_pVideo->SetProfiler(m_pProfiler);
+    m_pMemory->SetProfiler(m_pProfiler);
+    m_pMemory->SetCartridge(m_pCartridge);
+
 #if !defined(GEARBOY_DISABLE_DISASSEMBLER)
     m_trace_logger = new TraceLogger(&m_master_clock_cycles);
     m_pProcessor->SetTraceLogger(m_trace_logger);
     m_pVideo->SetTraceLogger(m_trace_logger);
     m_pMemory->SetTraceLogger(m_trace_logger);
+    m_pCodeProfiler = new CodeProfiler();
+    m_pProcessor->SetCodeProfiler(m_pCodeProfiler);
 #endif
 
     InitMemoryRules();
     InitDMGPalette();
     BuildColorCorrectionLUT();
+    m_pVideo->SetPixelFormat(m_pixelFormat);
     m_pVideo->SetColorCorrection(m_ColorCorrectionLUT, m_bColorCorrectionEnabled);
 }
 
+INLINE unsigned int GearboyCore::HaltSkipCycles()
+{
+    if (!m_bHaltSkip || !m_pProcessor->Halted())
+        return 0;
+
+    unsigned int limit = MIN(m_pVideo->CyclesToNextEvent(), m_pScheduler->CyclesToNextEvent());
+
+    return m_pProcessor->HaltSkipCycles(limit);
+}
+
 bool GearboyCore::RunToVBlank(u16* pFrameBuffer, s16* pSampleBuffer, int* pSampleCount, bool bDMGbuffer, GB_Debug_Run* debug, bool render)
+{
+    return RunFrame(pFrameBuffer, pSampleBuffer, pSampleCount, bDMGbuffer, debug, render);
+}
+
+bool GearboyCore::RunToVBlank(u32* pFrameBuffer, s16* pSampleBuffer, int* pSampleCount, bool bDMGbuffer, GB_Debug_Run* debug, bool render)
+{
+    return RunFrame(pFrameBuffer, pSampleBuffer, pSampleCount, bDMGbuffer, debug, render);
+}
+
+// Frame buffer pixels are u32 for 32-bit formats and u16 otherwise,
+// DMG index frames included
+bool GearboyCore::RunFrame(void* pFrameBuffer, s16* pSampleBuffer, int* pSampleCount, bool bDMGbuffer, GB_Debug_Run* debug, bool render)
 {
     bool breakpoint_result = false;
 
@@ -179,25 +219,45 @@ bool GearboyCore::RunToVBlank(u16* pFrameBuffer, s16* pSampleBuffer, int* pSampl
 
     if (!m_bPaused && m_pCartridge->IsLoadedROM())
     {
+        // Reschedule in case timers, input or RTC changed since last frame
+        m_pScheduler->Sync();
+        m_pProfiler->BeginFrame();
+
+        // SGB packets transfer data through the screen, so those frames
+        // always render no matter what the caller asked for
+        render = render || m_bSGB;
+
+        // Without a frame buffer the PPU keeps its timing but skips all pixel work
+        void* pVideoFrameBuffer = render ? pFrameBuffer : NULL;
+
+        // Likewise the APU skips synthesis when nobody takes the samples
+        m_pAudio->SetOutputEnabled(IsValidPointer(pSampleBuffer));
+
 #if !defined(GEARBOY_DISABLE_DISASSEMBLER)
         bool vblank = false;
         int totalClocks = 0;
 
+        u64 profiler_start = m_pProfiler->Begin();
+
         do
         {
-            unsigned int clockCycles = m_pProcessor->RunFor(1);
+            unsigned int clockCycles = HaltSkipCycles();
+            if (clockCycles == 0)
+                clockCycles = m_pProcessor->RunFor(1);
             unsigned int cpuClockCycles = clockCycles;
 
             m_master_clock_cycles += cpuClockCycles;
 
-            m_pProcessor->UpdateTimers(clockCycles);
             m_pProcessor->UpdateSerial(clockCycles);
+            profiler_start = m_pProfiler->Lap(PROFILER_PROCESSOR, profiler_start);
 
-            vblank = m_pVideo->Tick(clockCycles, pFrameBuffer, m_pixelFormat);
+            vblank = m_pVideo->Tick(clockCycles, pVideoFrameBuffer);
             m_master_clock_cycles += clockCycles - cpuClockCycles;
+            profiler_start = m_pProfiler->Lap(PROFILER_VIDEO, profiler_start);
             m_pAudio->Tick(clockCycles);
-            m_pInput->Tick(clockCycles);
-            m_pMBC3MemoryRule->Tick(clockCycles);
+            profiler_start = m_pProfiler->Lap(PROFILER_AUDIO, profiler_start);
+            m_pScheduler->Tick(clockCycles);
+            profiler_start = m_pProfiler->Lap(PROFILER_SCHEDULER, profiler_start);
             totalClocks += clockCycles;
 
             if (debug_enable)
@@ -220,7 +280,11 @@ bool GearboyCore::RunToVBlank(u16* pFrameBuffer, s16* pSampleBuffer, int* pSampl
         }
         while (!vblank);
 
+        m_pScheduler->Sync();
+
+        profiler_start = m_pProfiler->Begin();
         m_pAudio->EndFrame(pSampleBuffer, pSampleCount);
+        m_pProfiler->End(PROFILER_AUDIO_END_FRAME, profiler_start);
 
         m_iRTCUpdateCount++;
         if (m_iRTCUpdateCount == 20)
@@ -231,37 +295,49 @@ bool GearboyCore::RunToVBlank(u16* pFrameBuffer, s16* pSampleBuffer, int* pSampl
 
         if (render)
         {
+            profiler_start = m_pProfiler->Begin();
             if (bDMGbuffer && !m_bCGB)
                 RenderDMGIndexFrame(pFrameBuffer);
             else
-                RenderFrameBuffer(pFrameBuffer);
+                RenderFrame(pFrameBuffer);
+            m_pProfiler->End(PROFILER_FRAME_OUTPUT, profiler_start);
         }
 
+        m_pProfiler->EndFrame();
+
         breakpoint_result = m_pProcessor->BreakpointHit() || m_pProcessor->RunToBreakpointHit();
 #else
         UNUSED(debug);
         bool vblank = false;
         int totalClocks = 0;
 
+        u64 profiler_start = m_pProfiler->Begin();
+
         do
         {
+            unsigned int clockCycles = HaltSkipCycles();
+            if (clockCycles == 0)
+            {
             #ifdef PERFORMANCE
-                unsigned int clockCycles = m_pProcessor->RunFor(75);
+                clockCycles = m_pProcessor->RunFor(75);
             #else
-                unsigned int clockCycles = m_pProcessor->RunFor(1);
+                clockCycles = m_pProcessor->RunFor(1);
             #endif
+            }
             unsigned int cpuClockCycles = clockCycles;
 
             m_master_clock_cycles += cpuClockCycles;
 
-            m_pProcessor->UpdateTimers(clockCycles);
             m_pProcessor->UpdateSerial(clockCycles);
+            profiler_start = m_pProfiler->Lap(PROFILER_PROCESSOR, profiler_start);
 
-            vblank = m_pVideo->Tick(clockCycles, pFrameBuffer, m_pixelFormat);
+            vblank = m_pVideo->Tick(clockCycles, pVideoFrameBuffer);
             m_master_clock_cycles += clockCycles - cpuClockCycles;
+            profiler_start = m_pProfiler->Lap(PROFILER_VIDEO, profiler_start);
             m_pAudio->Tick(clockCycles);
-            m_pInput->Tick(clockCycles);
-            m_pMBC3MemoryRule->Tick(clockCycles);
+            profiler_start = m_pProfiler->Lap(PROFILER_AUDIO, profiler_start);
+            m_pScheduler->Tick(clockCycles);
+            profiler_start = m_pProfiler->Lap(PROFILER_SCHEDULER, profiler_start);
             totalClocks += clockCycles;
 
             if (totalClocks > GAMEBOY_CLOCKS_SAFE_LIMIT)
@@ -269,7 +345,11 @@ bool GearboyCore::RunToVBlank(u16* pFrameBuffer, s16* pSampleBuffer, int* pSampl
         }
         while (!vblank);
 
+        m_pScheduler->Sync();
+
+        profiler_start = m_pProfiler->Begin();
         m_pAudio->EndFrame(pSampleBuffer, pSampleCount);
+        m_pProfiler->End(PROFILER_AUDIO_END_FRAME, profiler_start);
 
         m_iRTCUpdateCount++;
         if (m_iRTCUpdateCount == 20)
@@ -280,11 +360,15 @@ bool GearboyCore::RunToVBlank(u16* pFrameBuffer, s16* pSampleBuffer, int* pSampl
 
         if (render)
         {
+            profiler_start = m_pProfiler->Begin();
             if (bDMGbuffer && !m_bCGB)
                 RenderDMGIndexFrame(pFrameBuffer);
             else
-                RenderFrameBuffer(pFrameBuffer);
+                RenderFrame(pFrameBuffer);
+            m_pProfiler->End(PROFILER_FRAME_OUTPUT, profiler_start);
         }
+
+        m_pProfiler->EndFrame();
 #endif
     }
 
@@ -301,6 +385,7 @@ bool GearboyCore::LoadROM(const char* szFilePath, bool forceDMG, Cartridge::Cart
         m_pMemory->LoadBank0and1FromROM(m_pCartridge->GetTheROM());
         bool romTypeOK = AddMemoryRules(forceType);
 #ifndef GEARBOY_DISABLE_DISASSEMBLER
+        m_pCodeProfiler->Reset();
         m_pProcessor->DisassembleNextOPCode();
 #endif
 
@@ -326,6 +411,9 @@ bool GearboyCore::LoadROMFromBuffer(const u8* buffer, int size, bool forceDMG, C
         m_pMemory->ResetDisassemblerRecords();
         m_pMemory->LoadBank0and1FromROM(m_pCartridge->GetTheROM());
         bool romTypeOK = AddMemoryRules(forceType);
+#ifndef GEARBOY_DISABLE_DISASSEMBLER
+        m_pCodeProfiler->Reset();
+#endif
 
         if (!romTypeOK)
         {
@@ -373,6 +461,16 @@ TraceLogger* GearboyCore::GetTraceLogger()
     return m_trace_logger;
 }
 
+CodeProfiler* GearboyCore::GetCodeProfiler()
+{
+    return m_pCodeProfiler;
+}
+
+Profiler* GearboyCore::GetProfiler()
+{
+    return m_pProfiler;
+}
+
 u64 GearboyCore::GetMasterClockCycles()
 {
     return m_master_clock_cycles;
@@ -407,6 +505,16 @@ bool GearboyCore::GetRuntimeInfo(GB_RuntimeInfo& runtime_info)
 }
 
 void GearboyCore::RenderFrameBuffer(u16* pFrameBuffer)
+{
+    RenderFrame(pFrameBuffer);
+}
+
+void GearboyCore::RenderFrameBuffer(u32* pFrameBuffer)
+{
+    RenderFrame(pFrameBuffer);
+}
+
+void GearboyCore::RenderFrame(void* pFrameBuffer)
 {
     if (!IsValidPointer(pFrameBuffer) || !m_pCartridge->IsLoadedROM())
         return;
@@ -419,10 +527,11 @@ void GearboyCore::RenderFrameBuffer(u16* pFrameBuffer)
 
     if (m_bCGB)
     {
-        const u16* color_frame_buffer = m_pVideo->GetColorFrameBuffer();
+        const void* color_frame_buffer = m_pVideo->GetColorFrameBuffer();
+        size_t pixel_size = Is32BitPixelFormat(m_pixelFormat) ? sizeof(u32) : sizeof(u16);
 
         if (IsValidPointer(color_frame_buffer) && (color_frame_buffer != pFrameBuffer))
-            memcpy(pFrameBuffer, color_frame_buffer, GAMEBOY_WIDTH * GAMEBOY_HEIGHT * sizeof(u16));
+            memcpy(pFrameBuffer, color_frame_buffer, GAMEBOY_WIDTH * GAMEBOY_HEIGHT * pixel_size);
 
         return;
     }
@@ -513,8 +622,10 @@ u16* GearboyCore::GetDMGInternalPalette()
 void GearboyCore::SetDMGPalette(GB_Color& color1, GB_Color& color2, GB_Color& color3,
         GB_Color& color4)
 {
-    bool format_565 = (m_pixelFormat == GB_PIXEL_RGB565) || (m_pixelFormat == GB_PIXEL_BGR565);
-    bool order_RGB = (m_pixelFormat == GB_PIXEL_RGB565) || (m_pixelFormat == GB_PIXEL_RGB555);
+    // 32-bit formats keep an RGB565 copy for the debugger
+    bool is_32bit = Is32BitPixelFormat(m_pixelFormat);
+    bool format_565 = is_32bit || (m_pixelFormat == GB_PIXEL_RGB565) || (m_pixelFormat == GB_PIXEL_BGR565);
+    bool order_RGB = is_32bit || (m_pixelFormat == GB_PIXEL_RGB565) || (m_pixelFormat == GB_PIXEL_RGB555);
 
     int multiplier = format_565 ? 63 : 31;
     int shift = format_565 ? 11 : 10;
@@ -541,6 +652,19 @@ void GearboyCore::SetDMGPalette(GB_Color& color1, GB_Color& color2, GB_Color& co
         m_DMGPalette[2] |= 0x8000;
         m_DMGPalette[3] |= 0x8000;
     }
+
+    if (is_32bit)
+    {
+        m_DMGRenderPalette[0] = PackColor32(color1.red, color1.green, color1.blue, m_pixelFormat);
+        m_DMGRenderPalette[1] = PackColor32(color2.red, color2.green, color2.blue, m_pixelFormat);
+        m_DMGRenderPalette[2] = PackColor32(color3.red, color3.green, color3.blue, m_pixelFormat);
+        m_DMGRenderPalette[3] = PackColor32(color4.red, color4.green, color4.blue, m_pixelFormat);
+    }
+    else
+    {
+        for (int i = 0; i < 4; i++)
+            m_DMGRenderPalette[i] = m_DMGPalette[i];
+    }
 }
 
 void GearboyCore::SaveRam()
@@ -674,9 +798,12 @@ void GearboyCore::SaveState(const char* szPath, int index)
     SaveState(szPath, index, false);
 }
 
+// RGB24 buffer used for save state screenshots. With 32-bit pixel formats
+// pass the u32 frame buffer instead, it is converted when saving
 void GearboyCore::SetFrameBuffer(u8* frame_buffer)
 {
     m_pSaveStateFrameBuffer = frame_buffer;
+    m_iSaveStateSize[1] = 0;
 }
 
 std::string GearboyCore::GetSaveStatePath(const char* path, int index)
@@ -781,12 +908,22 @@ bool GearboyCore::SaveState(u8* buffer, size_t& size, bool screenshot)
 
     if (!IsValidPointer(buffer))
     {
-        stringstream stream;
-        if (!SaveState(stream, size, screenshot))
+        // Every field has a fixed size, so the state size only changes when
+        // a cartridge is loaded or reset. Measure it once and reuse it
+        size_t& cached_size = m_iSaveStateSize[screenshot ? 1 : 0];
+
+        if (cached_size == 0)
         {
-            Error("Failed to save state to stream to calculate size");
-            return false;
+            counting_stream stream;
+            if (!SaveState(stream, cached_size, screenshot))
+            {
+                cached_size = 0;
+                Error("Failed to save state to stream to calculate size");
+                return false;
+            }
         }
+
+        size = cached_size;
         return true;
     }
     else
@@ -866,7 +1003,27 @@ bool GearboyCore::SaveState(std::ostream& stream, size_t& size, bool screenshot)
             header.screenshot_width = GAMEBOY_WIDTH;
             header.screenshot_height = GAMEBOY_HEIGHT;
             header.screenshot_size = GAMEBOY_WIDTH * GAMEBOY_HEIGHT * 3;
-            stream.write(reinterpret_cast<const char*>(m_pSaveStateFrameBuffer), header.screenshot_size);
+
+            if (Is32BitPixelFormat(m_pixelFormat))
+            {
+                // Screenshots are always stored as RGB24
+                const u32* pixels = reinterpret_cast<const u32*>(m_pSaveStateFrameBuffer);
+                u8 line[GAMEBOY_WIDTH * 3];
+
+                for (int y = 0; y < GAMEBOY_HEIGHT; y++)
+                {
+                    for (int x = 0; x < GAMEBOY_WIDTH; x++)
+                    {
+                        GB_Color color = UnpackColor32(pixels[(y * GAMEBOY_WIDTH) + x], m_pixelFormat);
+                        line[(x * 3) + 0] = color.red;
+                        line[(x * 3) + 1] = color.green;
+                        line[(x * 3) + 2] = color.blue;
+                    }
+                    stream.write(reinterpret_cast<const char*>(line), sizeof(line));
+                }
+            }
+            else
+                stream.write(reinterpret_cast<const char*>(m_pSaveStateFrameBuffer), header.screenshot_size);
         }
         else
         {
@@ -1080,7 +1237,7 @@ bool GearboyCore::LoadState(std::istream& stream)
     m_pInput->LoadState(stream, header.version);
     m_pAudio->LoadState(stream, header.version);
     m_pMemory->GetCurrentRule()->LoadState(stream);
-    m_pMemory->RefreshDirectROMPages();
+    m_pMemory->RefreshReadPages();
 
     if (header.version >= 102 && m_bSGB)
         m_pSGB->LoadState(stream);
@@ -1129,7 +1286,7 @@ bool GearboyCore::LoadStateLegacy(std::istream& stream, size_t size)
     m_pInput->LoadState(stream, GB_SAVESTATE_LEGACY_VERSION);
     m_pAudio->LoadState(stream, GB_SAVESTATE_LEGACY_VERSION);
     m_pMemory->GetCurrentRule()->LoadState(stream);
-    m_pMemory->RefreshDirectROMPages();
+    m_pMemory->RefreshReadPages();
 
     return true;
 }
@@ -1360,6 +1517,11 @@ void GearboyCore::EnableColorCorrection(bool enabled)
         m_pVideo->SetColorCorrection(m_ColorCorrectionLUT, enabled);
 }
 
+void GearboyCore::EnableHaltSkip(bool enabled)
+{
+    m_bHaltSkip = enabled;
+}
+
 void GearboyCore::BuildColorCorrectionLUT()
 {
     const float kGamma = 0.6f;
@@ -1377,8 +1539,11 @@ void GearboyCore::BuildColorCorrectionLUT()
     const float kRScale = 255.0f / 31.0f;
     const float kBScale = 255.0f / 31.0f;
 
-    bool format_565 = (m_pixelFormat == GB_PIXEL_RGB565) || (m_pixelFormat == GB_PIXEL_BGR565);
-    bool order_RGB = (m_pixelFormat == GB_PIXEL_RGB565) || (m_pixelFormat == GB_PIXEL_RGB555);
+    // 32-bit formats index the table by the RGB565 palette colors and get
+    // the corrected channels at full precision
+    bool is_32bit = Is32BitPixelFormat(m_pixelFormat);
+    bool format_565 = is_32bit || (m_pixelFormat == GB_PIXEL_RGB565) || (m_pixelFormat == GB_PIXEL_BGR565);
+    bool order_RGB = is_32bit || (m_pixelFormat == GB_PIXEL_RGB565) || (m_pixelFormat == GB_PIXEL_RGB555);
 
     int r_shift = format_565 ? 11 : 10;
     int g_shift = 5;
@@ -1417,6 +1582,14 @@ void GearboyCore::BuildColorCorrectionLUT()
         g_out = to_gamma(g_out, kOutputGamma);
         b_out = to_gamma(b_out, kOutputGamma);
 
+        if (is_32bit)
+        {
+            m_ColorCorrectionLUT[i] = PackColor32((u8)(CLAMP(r_out, 0.0f, 255.0f) + 0.5f),
+                    (u8)(CLAMP(g_out, 0.0f, 255.0f) + 0.5f),
+                    (u8)(CLAMP(b_out, 0.0f, 255.0f) + 0.5f), m_pixelFormat);
+            continue;
+        }
+
         u16 r_final = (u16)((CLAMP(r_out, 0.0f, 255.0f) / 255.0f) * 31.0f + 0.5f);
         u16 g_final = (u16)((CLAMP(g_out, 0.0f, 255.0f) / 255.0f) * (float)g_max + 0.5f);
         u16 b_final = (u16)((CLAMP(b_out, 0.0f, 255.0f) / 255.0f) * 31.0f + 0.5f);
@@ -1500,6 +1673,11 @@ void GearboyCore::InitMemoryRules()
     m_pMemory->SetIORule(m_pIORegistersMemoryRule);
     m_pMemory->SetCommonRule(m_pCommonMemoryRule);
 
+    m_pScheduler = new Scheduler(m_pProcessor, m_pInput, m_pMBC3MemoryRule);
+    m_pProcessor->SetScheduler(m_pScheduler);
+    m_pIORegistersMemoryRule->SetScheduler(m_pScheduler);
+    m_pMBC3MemoryRule->SetScheduler(m_pScheduler);
+
     m_pIORegistersMemoryRule->SetTraceLogger(m_trace_logger);
     m_pRomOnlyMemoryRule->SetTraceLogger(m_trace_logger);
     m_pMBC1MemoryRule->SetTraceLogger(m_trace_logger);
@@ -1636,6 +1814,8 @@ void GearboyCore::Reset(bool bCGB, bool bGBA)
     m_pCartridge->UpdateCurrentRTC();
     m_iRTCUpdateCount = 0;
     m_master_clock_cycles = 0;
+    m_iSaveStateSize[0] = 0;
+    m_iSaveStateSize[1] = 0;
 
     m_pCommonMemoryRule->Reset(m_bCGB);
     m_pRomOnlyMemoryRule->Reset(m_bCGB);
@@ -1659,6 +1839,7 @@ void GearboyCore::Reset(bool bCGB, bool bGBA)
 
     m_pSGB->Reset();
     m_pIORegistersMemoryRule->SetSGB(m_bSGB ? m_pSGB : NULL);
+    m_pScheduler->Reset();
 
     if (m_bSGB)
         Log("Reset: Super Game Boy mode enabled");
@@ -1666,21 +1847,35 @@ void GearboyCore::Reset(bool bCGB, bool bGBA)
     m_bPaused = false;
 }
 
-void GearboyCore::RenderDMGFrame(u16* pFrameBuffer) const
+void GearboyCore::RenderDMGFrame(void* pFrameBuffer) const
 {
     if (IsValidPointer(pFrameBuffer))
     {
         int pixels = GAMEBOY_WIDTH * GAMEBOY_HEIGHT;
         const u8* pGameboyFrameBuffer = m_pVideo->GetFrameBuffer();
 
-        for (int i = 0; i < pixels; i++)
+        if (Is32BitPixelFormat(m_pixelFormat))
+        {
+            u32* pOutput = static_cast<u32*>(pFrameBuffer);
+
+            for (int i = 0; i < pixels; i++)
+            {
+                pOutput[i] = m_DMGRenderPalette[pGameboyFrameBuffer[i]];
+            }
+        }
+        else
         {
-            pFrameBuffer[i] = m_DMGPalette[pGameboyFrameBuffer[i]];
+            u16* pOutput = static_cast<u16*>(pFrameBuffer);
+
+            for (int i = 0; i < pixels; i++)
+            {
+                pOutput[i] = m_DMGPalette[pGameboyFrameBuffer[i]];
+            }
         }
     }
 }
 
-void GearboyCore::RenderDMGIndexFrame(u16* pFrameBuffer) const
+void GearboyCore::RenderDMGIndexFrame(void* pFrameBuffer) const
 {
     if (IsValidPointer(pFrameBuffer))
     {
@@ -1688,37 +1883,37 @@ void GearboyCore::RenderDMGIndexFrame(u16* pFrameBuffer) const
         const u8* pGameboyFrameBuffer = m_pVideo->GetFrameBuffer();
 
         // Normal DMG and SGB colors are derived from this index buffer.
-        for (int i = 0; i < pixels; i++)
+        if (Is32BitPixelFormat(m_pixelFormat))
         {
-            pFrameBuffer[i] = pGameboyFrameBuffer[i];
+            u32* pOutput = static_cast<u32*>(pFrameBuffer);
+
+            for (int i = 0; i < pixels; i++)
+            {
+                pOutput[i] = pGameboyFrameBuffer[i];
+            }
+        }
+        else
+        {
+            u16* pOutput = static_cast<u16*>(pFrameBuffer);
+
+            for (int i = 0; i < pixels; i++)
+            {
+                pOutput[i] = pGameboyFrameBuffer[i];
+            }
         }
     }
 }
 
-void GearboyCore::RenderSGBFrame(u16* pFrameBuffer)
+void GearboyCore::RenderSGBFrame(void* pFrameBuffer)
 {
     if (IsValidPointer(pFrameBuffer))
     {
-        m_pSGB->CopyScreenBuffer(m_pVideo->GetFrameBuffer());
+        u64 profiler_start = m_pProfiler->Begin();
 
-        if (m_bSGBBorder)
-        {
-            m_pSGB->Render(pFrameBuffer, m_pixelFormat, false);
-        }
-        else
-        {
-            // memset(m_pSGBFrameBuffer, 0, SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * sizeof(u16));
-            m_pSGB->Render(m_pSGBFrameBuffer, m_pixelFormat, false);
+        m_pSGB->CopyScreenBuffer(m_pVideo->GetFrameBuffer());
 
-            int offsetX = (SGB_SCREEN_WIDTH - GAMEBOY_WIDTH) / 2;
-            int offsetY = (SGB_SCREEN_HEIGHT - GAMEBOY_HEIGHT) / 2;
+        m_pSGB->Render(pFrameBuffer, m_pixelFormat, false, m_bSGBBorder);
 
-            for (int y = 0; y < GAMEBOY_HEIGHT; y++)
-            {
-                memcpy(&pFrameBuffer[y * GAMEBOY_WIDTH],
-                       &m_pSGBFrameBuffer[(offsetY + y) * SGB_SCREEN_WIDTH + offsetX],
-                       GAMEBOY_WIDTH * sizeof(u16));
-            }
-        }
+        m_pProfiler->End(PROFILER_SGB, profiler_start);
     }
 }
@@ -49,7 +49,10 @@ class SachenMMC2MemoryRule;
 class FlashcartMemoryRule;
 class MemoryRule;
 class TraceLogger;
+class CodeProfiler;
 class SGB;
+class Scheduler;
+class Profiler;
 
 class GearboyCore
 {
@@ -69,6 +72,7 @@ public:
     ~GearboyCore();
     void Init(GB_Color_Format pixelFormat = GB_PIXEL_RGB565);
     bool RunToVBlank(u16* pFrameBuffer, s16* pSampleBuffer, int* pSampleCount, bool bDMGbuffer = false, GB_Debug_Run* debug = NULL, bool render = true);
+    bool RunToVBlank(u32* pFrameBuffer, s16* pSampleBuffer, int* pSampleCount, bool bDMGbuffer = false, GB_Debug_Run* debug = NULL, bool render = true);
     bool LoadROM(const char* szFilePath, bool forceDMG, Cartridge::CartridgeTypes forceType = Cartridge::CartridgeNotSupported, bool forceGBA = false);
     bool LoadROMFromBuffer(const u8* buffer, int size, bool forceDMG, Cartridge::CartridgeTypes forceType = Cartridge::CartridgeNotSupported, bool forceGBA = false);
     bool GetRuntimeInfo(GB_RuntimeInfo& runtime_info);
@@ -85,6 +89,7 @@ public:
     void SetDMGPalette(GB_Color& color1, GB_Color& color2, GB_Color& color3, GB_Color& color4);
     u16* GetDMGInternalPalette();
     void EnableColorCorrection(bool enabled);
+    void EnableHaltSkip(bool enabled);
     void SaveRam();
     void SaveRam(const char* szPath, bool fullPath = false);
     void LoadRam();
@@ -100,6 +105,7 @@ public:
     bool GetSaveStateHeader(int index, const char* path, GB_SaveState_Header* header, bool* out_sgb = NULL);
     bool GetSaveStateScreenshot(int index, const char* path, GB_SaveState_Screenshot* screenshot);
     void RenderFrameBuffer(u16* frame_buffer);
+    void RenderFrameBuffer(u32* frame_buffer);
     void SetFrameBuffer(u8* frame_buffer);
     void SetCheat(const char* szCheat);
     void ClearCheats();
@@ -117,14 +123,19 @@ public:
     Input* GetInput();
     SGB* GetSGB();
     TraceLogger* GetTraceLogger();
+    Profiler* GetProfiler();
+    CodeProfiler* GetCodeProfiler();
     u64 GetMasterClockCycles();
     void SetAccelerometer(double x, double y);
 
 private:
-    void RenderDMGFrame(u16* pFrameBuffer) const;
-    void RenderDMGIndexFrame(u16* pFrameBuffer) const;
-    void RenderSGBFrame(u16* pFrameBuffer);
+    bool RunFrame(void* pFrameBuffer, s16* pSampleBuffer, int* pSampleCount, bool bDMGbuffer, GB_Debug_Run* debug, bool render);
+    void RenderFrame(void* pFrameBuffer);
+    void RenderDMGFrame(void* pFrameBuffer) const;
+    void RenderDMGIndexFrame(void* pFrameBuffer) const;
+    void RenderSGBFrame(void* pFrameBuffer);
     void BuildColorCorrectionLUT();
+    INLINE unsigned int HaltSkipCycles();
     void InitDMGPalette();
     void InitMemoryRules();
     bool AddMemoryRules(Cartridge::CartridgeTypes forceType = Cartridge::CartridgeNotSupported);
@@ -142,6 +153,8 @@ private:
     Input* m_pInput;
     Cartridge* m_pCartridge;
     SGB* m_pSGB;
+    Scheduler* m_pScheduler;
+    Profiler* m_pProfiler;
     CommonMemoryRule* m_pCommonMemoryRule;
     IORegistersMemoryRule* m_pIORegistersMemoryRule;
     RomOnlyMemoryRule* m_pRomOnlyMemoryRule;
@@ -166,17 +179,20 @@ private:
     bool m_bSGB;
     bool m_bPaused;
     u16 m_DMGPalette[4];
+    u32 m_DMGRenderPalette[4];
     bool m_bForceDMG;
     bool m_bSGBEnabled;
     bool m_bSGBBorder;
-    u16* m_pSGBFrameBuffer;
     int m_iRTCUpdateCount;
     RamChangedCallback m_pRamChangedCallback;
     GB_Color_Format m_pixelFormat;
     bool m_bColorCorrectionEnabled;
-    u16 m_ColorCorrectionLUT[65536];
+    bool m_bHaltSkip;
+    u32 m_ColorCorrectionLUT[65536];
     u8* m_pSaveStateFrameBuffer;
+    size_t m_iSaveStateSize[2];
     TraceLogger* m_trace_logger;
+    CodeProfiler* m_pCodeProfiler;
     u64 m_master_clock_cycles;
 };
 
@@ -29,6 +29,7 @@ IORegistersMemoryRule::IORegistersMemoryRule(Processor* pProcessor,
     m_pAudio = pAudio;
     InitPointer(m_pSGB);
     InitPointer(m_pTraceLogger);
+    InitPointer(m_pScheduler);
     m_bCGB = false;
 }
 
@@ -195,3 +196,8 @@ void IORegistersMemoryRule::SetSGB(SGB* pSGB)
 {
     m_pSGB = pSGB;
 }
+
+void IORegistersMemoryRule::SetScheduler(Scheduler* pScheduler)
+{
+    m_pScheduler = pScheduler;
+}
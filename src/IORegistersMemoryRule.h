@@ -29,6 +29,7 @@ class Audio;
 class Memory;
 class TraceLogger;
 class SGB;
+class Scheduler;
 
 class IORegistersMemoryRule
 {
@@ -40,6 +41,7 @@ public:
     void Reset(bool bCGB);
     void SetTraceLogger(TraceLogger* pTraceLogger);
     void SetSGB(SGB* pSGB);
+    void SetScheduler(Scheduler* pScheduler);
 
 private:
     INLINE void TraceInputEvent(u8 event, u8 value, u8 result = 0);
@@ -63,6 +65,7 @@ private:
     Audio* m_pAudio;
     SGB* m_pSGB;
     TraceLogger* m_pTraceLogger;
+    Scheduler* m_pScheduler;
     bool m_bCGB;
 };
 
@@ -73,6 +76,7 @@ private:
 #include "Memory.h"
 #include "TraceLogger.h"
 #include "SGB.h"
+#include "Scheduler.h"
 
 INLINE void IORegistersMemoryRule::TraceInputEvent(u8 event, u8 value, u8 result)
 {
@@ -185,6 +189,13 @@ inline u8 IORegistersMemoryRule::PerformRead(u16 address)
             // UNDOCUMENTED
             return 0xFF;
         }
+        case 0xFF04:
+        case 0xFF05:
+        {
+            // DIV, TIMA
+            m_pScheduler->Sync();
+            return m_pMemory->Retrieve(address);
+        }
         case 0xFF07:
         {
             // TAC
@@ -374,6 +385,7 @@ inline void IORegistersMemoryRule::PerformWrite(u16 address, u8 value)
         case 0xFF04:
         {
             // DIV
+            m_pScheduler->Sync();
             u8 tac = m_pMemory->Retrieve(0xFF07);
 
             if (tac & 0x04)
@@ -387,13 +399,16 @@ inline void IORegistersMemoryRule::PerformWrite(u16 address, u8 value)
             }
 
             m_pProcessor->ResetDIVCycles();
+            m_pScheduler->Sync();
             TraceTimerEvent(TRACE_TIMER_DIV_WRITE, value);
             break;
         }
         case 0xFF05:
         {
             // TIMA
+            m_pScheduler->Sync();
             m_pMemory->Load(address, value);
+            m_pScheduler->Sync();
             TraceTimerEvent(TRACE_TIMER_TIMA_WRITE, value);
             break;
         }
@@ -407,6 +422,7 @@ inline void IORegistersMemoryRule::PerformWrite(u16 address, u8 value)
         case 0xFF07:
         {
             // TAC
+            m_pScheduler->Sync();
             value &= 0x07;
             u8 current_tac = m_pMemory->Retrieve(0xFF07);
 
@@ -431,6 +447,7 @@ inline void IORegistersMemoryRule::PerformWrite(u16 address, u8 value)
                 m_pProcessor->ResetTIMACycles();
             }
             m_pMemory->Load(address, value);
+            m_pScheduler->Sync();
             TraceTimerEvent(TRACE_TIMER_TAC_WRITE, value);
             break;
         }
@@ -508,6 +525,7 @@ inline void IORegistersMemoryRule::PerformWrite(u16 address, u8 value)
                 m_pVideo->EnableScreen();
             else
                 m_pVideo->DisableScreen();
+            m_pVideo->MarkVideoDataChanged();
             TraceLCDRegister(address, value);
             break;
         }
@@ -546,13 +564,20 @@ inline void IORegistersMemoryRule::PerformWrite(u16 address, u8 value)
         }
         case 0xFF42:
         case 0xFF43:
+        case 0xFF4B:
+        {
+            // SCY, SCX, WX
+            m_pMemory->Load(address, value);
+            TraceLCDRegister(address, value);
+            break;
+        }
         case 0xFF47:
         case 0xFF48:
         case 0xFF49:
-        case 0xFF4B:
         {
-            // SCY, SCX, BGP, OBP0, OBP1, WX
+            // BGP, OBP0, OBP1
             m_pMemory->Load(address, value);
+            m_pVideo->MarkVideoDataChanged();
             TraceLCDRegister(address, value);
             break;
         }
@@ -32,6 +32,7 @@ public:
     void Init();
     void Reset();
     void Tick(unsigned int clockCycles);
+    unsigned int CyclesToNextUpdate() const;
     void KeyPressed(Gameboy_Keys key);
     void KeyReleased(Gameboy_Keys key);
     bool IsKeyPressed(Gameboy_Keys key) const;
@@ -66,6 +67,11 @@ INLINE void Input::Tick(unsigned int clockCycles)
     }
 }
 
+INLINE unsigned int Input::CyclesToNextUpdate() const
+{
+    return (m_iInputCycles < 10000) ? (unsigned int)(10000 - m_iInputCycles) : 0;
+}
+
 INLINE void Input::Write(u8 value)
 {
     m_P1 = (m_P1 & 0xCF) | (value & 0x30);
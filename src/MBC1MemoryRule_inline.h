@@ -0,0 +1,50 @@
+#ifndef MBC1MEMORYRULE_INLINE_H
+#define MBC1MEMORYRULE_INLINE_H
+
+#include "MBC1MemoryRule.h"
+#include "Memory.h"
+#include "Cartridge.h"
+
+INLINE u8 MBC1MemoryRule::PerformRead(u16 address)
+{
+    switch (address & 0xE000)
+    {
+        case 0x0000:
+        case 0x2000:
+        {
+            if (m_iMode == 1)
+            {
+                u8* pROM = m_pCartridge->GetTheROM();
+                int bank0 = (m_HigherRomBankBits << 5) & (m_pCartridge->GetROMBankCount() - 1);
+                return pROM[(bank0 * 0x4000) + address];
+            }
+            return m_pMemory->Retrieve(address);
+        }
+        case 0x4000:
+        case 0x6000:
+        {
+            u8* pROM = m_pCartridge->GetTheROM();
+            return pROM[(address - 0x4000) + m_CurrentROMAddress];
+        }
+        case 0xA000:
+        {
+            if (m_bRamEnabled)
+            {
+                if (m_iRamBytesSize > 0)
+                    return m_pRAMBanks[((address - 0xA000) + m_CurrentRAMAddress) & (m_iRamBytesSize - 1)];
+                return 0xFF;
+            }
+            else
+            {
+                Debug("--> ** Attempting to read from disabled ram %X", address);
+                return 0xFF;
+            }
+        }
+        default:
+        {
+            return m_pMemory->Retrieve(address);
+        }
+    }
+}
+
+#endif /* MBC1MEMORYRULE_INLINE_H */
@@ -41,6 +41,11 @@ bool MBC2MemoryRule::MapsROMDirectly()
     return true;
 }
 
+GB_Memory_Rule_Type MBC2MemoryRule::GetRuleType()
+{
+    return GB_Memory_Rule_MBC2;
+}
+
 void MBC2MemoryRule::Reset(bool bCGB)
 {
     m_bCGB = bCGB;
@@ -23,6 +23,7 @@
 #include "Processor.h"
 #include "Input.h"
 #include "Cartridge.h"
+#include "Scheduler.h"
 
 MBC3MemoryRule::MBC3MemoryRule(Processor* pProcessor,
         Memory* pMemory, Video* pVideo, Input* pInput,
@@ -31,6 +32,7 @@ pMemory, pVideo, pInput, pCartridge, pAudio)
 {
     m_iRAMBanksSize = 0;
     m_pRAMBanks = NULL;
+    InitPointer(m_pScheduler);
     Reset(false);
 }
 
@@ -44,6 +46,11 @@ bool MBC3MemoryRule::MapsROMDirectly()
     return !IsPoke2in1();
 }
 
+GB_Memory_Rule_Type MBC3MemoryRule::GetRuleType()
+{
+    return GB_Memory_Rule_MBC3;
+}
+
 void MBC3MemoryRule::Reset(bool bCGB)
 {
     ResizeRAMBanks();
@@ -232,83 +239,33 @@ void MBC3MemoryRule::WritePoke2in1RAM(u16 address, u8 value)
     m_pRAMBanks[((address - 0xA000) + m_CurrentRAMAddress) & (m_iRAMBanksSize - 1)] = value;
 }
 
-u8 MBC3MemoryRule::PerformRead(u16 address)
+u8 MBC3MemoryRule::ReadRTC(u16 address)
 {
-    switch (address & 0xE000)
-    {
-        case 0x0000:
-        case 0x2000:
-        {
-            if (IsPoke2in1())
-            {
-                u8* pROM = m_pCartridge->GetTheROM();
-                return pROM[address + m_CurrentROM0Address];
-            }
+    UNUSED(address);
 
-            return m_pMemory->Retrieve(address);
-        }
-        case 0x4000:
-        case 0x6000:
-        {
-            u8* pROM = m_pCartridge->GetTheROM();
-            return pROM[(address - 0x4000) + m_CurrentROMAddress];
-        }
-        case 0xA000:
+    if (m_pCartridge->IsRTCPresent() && m_bRTCEnabled)
+    {
+        switch (m_RTCRegister & 0x07)
         {
-            if (IsPoke2in1())
-                return ReadPoke2in1RAM(address);
-
-            if (IsPKJD())
-                return ReadPKJD(address);
-
-            if (m_iCurrentRAMBank >= 0)
-            {
-                if (m_bRamEnabled && (m_pCartridge->GetRAMBankCount() > 0))
-                {
-                    if (!m_pCartridge->IsMBC30() && m_pCartridge->IsRTCPresent() && (m_iCurrentRAMBank & 0x07) > 3)
-                        return 0xFF;
-                    return m_pRAMBanks[(address - 0xA000) + m_CurrentRAMAddress];
-                }
-                else
-                {
-                    Debug("--> ** Attempting to read from disabled ram %X", address);
-                    return 0xFF;
-                }
-            }
-            else if (m_pCartridge->IsRTCPresent() && m_bRTCEnabled)
-            {
-                switch (m_RTCRegister & 0x07)
-                {
-                    case 0x00:
-                        return m_RTC.LatchedSeconds & 0x3F;
-                        break;
-                    case 0x01:
-                        return m_RTC.LatchedMinutes & 0x3F;
-                        break;
-                    case 0x02:
-                        return m_RTC.LatchedHours & 0x1F;
-                        break;
-                    case 0x03:
-                        return m_RTC.LatchedDays;
-                        break;
-                    case 0x04:
-                        return m_RTC.LatchedControl & 0xC1;
-                        break;
-                    default:
-                        return 0xFF;
-                }
-            }
-            else
-            {
-                Debug("--> ** Attempting to read from disabled RTC %X", address);
+            case 0x00:
+                return m_RTC.LatchedSeconds & 0x3F;
+            case 0x01:
+                return m_RTC.LatchedMinutes & 0x3F;
+            case 0x02:
+                return m_RTC.LatchedHours & 0x1F;
+            case 0x03:
+                return m_RTC.LatchedDays;
+            case 0x04:
+                return m_RTC.LatchedControl & 0xC1;
+            default:
                 return 0xFF;
-            }
-        }
-        default:
-        {
-            return m_pMemory->Retrieve(address);
         }
     }
+    else
+    {
+        Debug("--> ** Attempting to read from disabled RTC %X", address);
+        return 0xFF;
+    }
 }
 
 void MBC3MemoryRule::PerformWrite(u16 address, u8 value)
@@ -434,6 +391,7 @@ void MBC3MemoryRule::PerformWrite(u16 address, u8 value)
             if (m_pCartridge->IsRTCPresent())
             {
                 // RTC Latch
+                m_pScheduler->Sync();
                 m_RTC.LatchedSeconds = m_RTC.Seconds;
                 m_RTC.LatchedMinutes = m_RTC.Minutes;
                 m_RTC.LatchedHours = m_RTC.Hours;
@@ -476,6 +434,8 @@ void MBC3MemoryRule::PerformWrite(u16 address, u8 value)
             }
             else if (m_pCartridge->IsRTCPresent() && m_bRTCEnabled)
             {
+                m_pScheduler->Sync();
+
                 switch (m_RTCRegister & 0x07)
                 {
                     case 0x00:
@@ -496,6 +456,8 @@ void MBC3MemoryRule::PerformWrite(u16 address, u8 value)
                         m_RTC.Control = value & 0xC1;
                         break;
                 }
+
+                m_pScheduler->Sync();
             }
             else
             {
@@ -511,6 +473,11 @@ void MBC3MemoryRule::PerformWrite(u16 address, u8 value)
     }
 }
 
+void MBC3MemoryRule::SetScheduler(Scheduler* pScheduler)
+{
+    m_pScheduler = pScheduler;
+}
+
 void MBC3MemoryRule::TickRTC()
 {
     while (m_iRTCCycles >= GEARBOY_MASTER_CLOCK_RATE)
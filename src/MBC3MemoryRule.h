@@ -23,6 +23,8 @@
 #include "MemoryRule.h"
 #include "Cartridge.h"
 
+class Scheduler;
+
 struct RTC_Registers
 {
     s32 Seconds;
@@ -48,6 +50,7 @@ public:
     virtual u8 PerformRead(u16 address);
     virtual void PerformWrite(u16 address, u8 value);
     virtual bool MapsROMDirectly();
+    virtual GB_Memory_Rule_Type GetRuleType();
     virtual void Reset(bool bCGB);
     virtual void SaveRam(std::ostream &file);
     virtual bool LoadRam(std::istream &file, s32 fileSize);
@@ -64,6 +67,8 @@ public:
     virtual void SaveState(std::ostream& stream);
     virtual void LoadState(std::istream& stream);
     INLINE void Tick(unsigned int clockCycles);
+    INLINE unsigned int CyclesToNextTick() const;
+    void SetScheduler(Scheduler* pScheduler);
 
 private:
     void ResizeRAMBanks();
@@ -75,6 +80,7 @@ private:
     int NormalizeROMBank(int bank) const;
     void SetPoke2in1ROMBank(u8 value);
     void SetPoke2in1BaseBank(int bank);
+    NO_INLINE u8 ReadRTC(u16 address);
     u8 ReadPKJD(u16 address);
     void WritePKJD(u16 address, u8 value);
     u8 ReadPoke2in1RAM(u16 address);
@@ -96,6 +102,7 @@ private:
     int m_CurrentRAMAddress;
     RTC_Registers m_RTC;
     u32 m_iRTCCycles;
+    Scheduler* m_pScheduler;
     bool m_bPKJDRAMSelected;
     u8 m_PKJDRegisters[7];
     int m_iPoke2in1BaseBank;
@@ -126,4 +133,12 @@ INLINE void MBC3MemoryRule::Tick(unsigned int clockCycles)
         TickRTC();
 }
 
+INLINE unsigned int MBC3MemoryRule::CyclesToNextTick() const
+{
+    if (!m_pCartridge->IsRTCPresent() || IsSetBit(m_RTC.Control, 6))
+        return 0x7FFFFFFF;
+
+    return (m_iRTCCycles < GEARBOY_MASTER_CLOCK_RATE) ? (GEARBOY_MASTER_CLOCK_RATE - m_iRTCCycles) : 0;
+}
+
 #endif	/* MBC3MEMORYRULE_H */
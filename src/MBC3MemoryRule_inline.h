@@ -0,0 +1,61 @@
+#ifndef MBC3MEMORYRULE_INLINE_H
+#define MBC3MEMORYRULE_INLINE_H
+
+#include "MBC3MemoryRule.h"
+#include "Memory.h"
+#include "Cartridge.h"
+
+// Plain ROM and RAM reads stay inline, the PKJD, Poke 2in1 and RTC
+// register paths are out of line
+INLINE u8 MBC3MemoryRule::PerformRead(u16 address)
+{
+    switch (address & 0xE000)
+    {
+        case 0x0000:
+        case 0x2000:
+        {
+            if (IsPoke2in1())
+            {
+                u8* pROM = m_pCartridge->GetTheROM();
+                return pROM[address + m_CurrentROM0Address];
+            }
+
+            return m_pMemory->Retrieve(address);
+        }
+        case 0x4000:
+        case 0x6000:
+        {
+            u8* pROM = m_pCartridge->GetTheROM();
+            return pROM[(address - 0x4000) + m_CurrentROMAddress];
+        }
+        case 0xA000:
+        {
+            if (IsPoke2in1())
+                return ReadPoke2in1RAM(address);
+
+            if (IsPKJD())
+                return ReadPKJD(address);
+
+            if (m_iCurrentRAMBank < 0)
+                return ReadRTC(address);
+
+            if (m_bRamEnabled && (m_pCartridge->GetRAMBankCount() > 0))
+            {
+                if (m_pCartridge->IsRTCPresent() && !m_pCartridge->IsMBC30() && (m_iCurrentRAMBank & 0x07) > 3)
+                    return 0xFF;
+                return m_pRAMBanks[(address - 0xA000) + m_CurrentRAMAddress];
+            }
+            else
+            {
+                Debug("--> ** Attempting to read from disabled ram %X", address);
+                return 0xFF;
+            }
+        }
+        default:
+        {
+            return m_pMemory->Retrieve(address);
+        }
+    }
+}
+
+#endif /* MBC3MEMORYRULE_INLINE_H */
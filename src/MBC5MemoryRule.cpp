@@ -43,6 +43,11 @@ bool MBC5MemoryRule::MapsROMDirectly()
     return true;
 }
 
+GB_Memory_Rule_Type MBC5MemoryRule::GetRuleType()
+{
+    return GB_Memory_Rule_MBC5;
+}
+
 void MBC5MemoryRule::Reset(bool bCGB)
 {
     m_bCGB = bCGB;
@@ -65,35 +70,6 @@ void MBC5MemoryRule::UpdateBanks()
     m_CurrentROMAddress = m_iCurrentROMBank * 0x4000;
 }
 
-u8 MBC5MemoryRule::PerformRead(u16 address)
-{
-    switch (address & 0xE000)
-    {
-        case 0x4000:
-        case 0x6000:
-        {
-            u8* pROM = m_pCartridge->GetTheROM();
-            return pROM[(address - 0x4000) + m_CurrentROMAddress];
-        }
-        case 0xA000:
-        {
-            if (m_bRamEnabled)
-            {
-                return m_pRAMBanks[(address - 0xA000) + m_CurrentRAMAddress];
-            }
-            else
-            {
-                Debug("--> ** Attempting to read from disabled ram %X", address);
-                return 0xFF;
-            }
-        }
-        default:
-        {
-            return m_pMemory->Retrieve(address);
-        }
-    }
-}
-
 void MBC5MemoryRule::PerformWrite(u16 address, u8 value)
 {
     switch (address & 0xE000)
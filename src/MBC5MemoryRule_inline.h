@@ -0,0 +1,37 @@
+#ifndef MBC5MEMORYRULE_INLINE_H
+#define MBC5MEMORYRULE_INLINE_H
+
+#include "MBC5MemoryRule.h"
+#include "Memory.h"
+#include "Cartridge.h"
+
+INLINE u8 MBC5MemoryRule::PerformRead(u16 address)
+{
+    switch (address & 0xE000)
+    {
+        case 0x4000:
+        case 0x6000:
+        {
+            u8* pROM = m_pCartridge->GetTheROM();
+            return pROM[(address - 0x4000) + m_CurrentROMAddress];
+        }
+        case 0xA000:
+        {
+            if (m_bRamEnabled)
+            {
+                return m_pRAMBanks[(address - 0xA000) + m_CurrentRAMAddress];
+            }
+            else
+            {
+                Debug("--> ** Attempting to read from disabled ram %X", address);
+                return 0xFF;
+            }
+        }
+        default:
+        {
+            return m_pMemory->Retrieve(address);
+        }
+    }
+}
+
+#endif /* MBC5MEMORYRULE_INLINE_H */
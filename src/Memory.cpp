@@ -23,23 +23,31 @@
 #include "TraceLogger.h"
 #include "Processor.h"
 #include "Video.h"
+#include "Cartridge.h"
 #include "common.h"
 
 Memory::Memory()
 {
     InitPointer(m_pProcessor);
     InitPointer(m_pVideo);
+    InitPointer(m_pCartridge);
     InitPointer(m_pMap);
-    InitPointer(m_pDisassembledMap);
-    InitPointer(m_pDisassembledROMMap);
+    InitPointer(m_pDisassembledROMPages);
+    InitPointer(m_pExecutedMap);
+    InitPointer(m_pExecutedROMMap);
+    m_iDisassembledROMSize = 0;
+    for (int i = 0; i < DISASSEMBLER_RAM_PAGE_COUNT; i++)
+        InitPointer(m_pDisassembledPages[i]);
     InitPointer(m_pWRAMBanks);
     InitPointer(m_pLCDRAMBank1);
     InitPointer(m_pCommonMemoryRule);
     InitPointer(m_pIORegistersMemoryRule);
     InitPointer(m_pTraceLogger);
+    InitPointer(m_pProfiler);
     InitPointer(m_pCurrentMemoryRule);
-    InitPointer(m_pDirectROMPages[0]);
-    InitPointer(m_pDirectROMPages[1]);
+    m_CurrentRuleType = GB_Memory_Rule_Generic;
+    for (int i = 0; i < 16; i++)
+        InitPointer(m_pReadPages[i]);
     InitPointer(m_pBootromDMG);
     InitPointer(m_pBootromGBC);
     m_bCGB = false;
@@ -68,6 +76,11 @@ void Memory::SetTraceLogger(TraceLogger* pTraceLogger)
     m_pTraceLogger = pTraceLogger;
 }
 
+void Memory::SetProfiler(Profiler* pProfiler)
+{
+    m_pProfiler = pProfiler;
+}
+
 void Memory::LogLCDDMAEvent(u8 event, u16 source, u16 destination, u16 length)
 {
 #if !defined(GEARBOY_DISABLE_DISASSEMBLER)
@@ -111,23 +124,10 @@ Memory::~Memory()
     SafeDeleteArray(m_pBootromDMG);
     SafeDeleteArray(m_pBootromGBC);
 
-    if (IsValidPointer(m_pDisassembledROMMap))
-    {
-        for (int i = 0; i < MAX_ROM_SIZE; i++)
-        {
-            SafeDelete(m_pDisassembledROMMap[i]);
-        }
-        SafeDeleteArray(m_pDisassembledROMMap);
-    }
-
-    if (IsValidPointer(m_pDisassembledMap))
-    {
-        for (int i = 0; i < 65536; i++)
-        {
-            SafeDelete(m_pDisassembledMap[i]);
-        }
-        SafeDeleteArray(m_pDisassembledMap);
-    }
+    FreeDisassemblerPages();
+    SafeDeleteArray(m_pDisassembledROMPages);
+    SafeDeleteArray(m_pExecutedMap);
+    SafeDeleteArray(m_pExecutedROMMap);
 }
 
 void Memory::SetProcessor(Processor* pProcessor)
@@ -135,6 +135,11 @@ void Memory::SetProcessor(Processor* pProcessor)
     m_pProcessor = pProcessor;
 }
 
+void Memory::SetCartridge(Cartridge* pCartridge)
+{
+    m_pCartridge = pCartridge;
+}
+
 void Memory::SetVideo(Video* pVideo)
 {
     m_pVideo = pVideo;
@@ -148,17 +153,9 @@ void Memory::Init()
     m_pBootromDMG = new u8[0x100];
     m_pBootromGBC = new u8[0x900];
 #ifndef GEARBOY_DISABLE_DISASSEMBLER
-    m_pDisassembledMap = new GB_Disassembler_Record*[65536];
-    for (int i = 0; i < 65536; i++)
-    {
-        InitPointer(m_pDisassembledMap[i]);
-    }
-
-    m_pDisassembledROMMap = new GB_Disassembler_Record*[MAX_ROM_SIZE];
-    for (int i = 0; i < MAX_ROM_SIZE; i++)
-    {
-        InitPointer(m_pDisassembledROMMap[i]);
-    }
+    m_pExecutedMap = new u8[65536 >> 3];
+    memset(m_pExecutedMap, 0, 65536 >> 3);
+    ResizeROMDisassembler(0x8000);
 #endif
     Reset(false);
 }
@@ -169,8 +166,7 @@ void Memory::Reset(bool bCGB, bool bSGB)
     InitPointer(m_pCommonMemoryRule);
     InitPointer(m_pIORegistersMemoryRule);
     InitPointer(m_pCurrentMemoryRule);
-    InitPointer(m_pDirectROMPages[0]);
-    InitPointer(m_pDirectROMPages[1]);
+    m_CurrentRuleType = GB_Memory_Rule_Generic;
     m_bCurrentRuleMapsROMDirectly = false;
     m_iCurrentWRAMBank = 1;
     m_iCurrentLCDRAMBank = 0;
@@ -287,6 +283,8 @@ void Memory::Reset(bool bCGB, bool bSGB)
         m_HDMADestination = ((hdma3 & 0x1F) << 8) | (hdma4 & 0xF0);
         m_HDMADestination |= 0x8000;
     }
+
+    RefreshReadPages();
 }
 
 void Memory::SetCurrentRule(MemoryRule* pRule)
@@ -296,26 +294,44 @@ void Memory::SetCurrentRule(MemoryRule* pRule)
             pRule->NeedsHighMemoryAccessNotifications();
     m_bCurrentRuleMapsROMDirectly = IsValidPointer(pRule) &&
             pRule->MapsROMDirectly();
-    RefreshDirectROMPages();
+    m_CurrentRuleType = IsValidPointer(pRule) ? pRule->GetRuleType() : GB_Memory_Rule_Generic;
+    RefreshReadPages();
 }
 
-void Memory::RefreshDirectROMPages()
+// Read pages map each 4KB of the address space straight to host memory
+// when a read has no side effects, NULL falls back to the memory rules
+void Memory::RefreshReadPages()
 {
-    InitPointer(m_pDirectROMPages[0]);
-    InitPointer(m_pDirectROMPages[1]);
+    for (int i = 0; i < 16; i++)
+        InitPointer(m_pReadPages[i]);
 
-    if (m_bCurrentRuleMapsROMDirectly)
-    {
-        m_pDirectROMPages[0] = m_pCurrentMemoryRule->GetRomBank0();
-        m_pDirectROMPages[1] = m_pCurrentMemoryRule->GetCurrentRomBank1();
+    RefreshROMReadPages();
+    RefreshWRAMReadPages();
+}
 
-        if (!IsValidPointer(m_pDirectROMPages[0]) ||
-                !IsValidPointer(m_pDirectROMPages[1]))
-        {
-            InitPointer(m_pDirectROMPages[0]);
-            InitPointer(m_pDirectROMPages[1]);
-        }
+void Memory::RefreshROMReadPages()
+{
+    for (int i = 0; i < 8; i++)
+        InitPointer(m_pReadPages[i]);
+
+    if (!m_bCurrentRuleMapsROMDirectly)
+        return;
+
+    u8* rom0 = m_pCurrentMemoryRule->GetRomBank0();
+    u8* rom1 = m_pCurrentMemoryRule->GetCurrentRomBank1();
+
+    if (!IsValidPointer(rom0) || !IsValidPointer(rom1))
+        return;
+
+    for (int i = 0; i < 4; i++)
+    {
+        m_pReadPages[i] = rom0 + (0x1000 * i);
+        m_pReadPages[i + 4] = rom1 + (0x1000 * i);
     }
+
+    // The boot ROM overlays the first page until it is unmapped
+    if (!m_bBootromRegistryDisabled && IsBootromEnabled())
+        InitPointer(m_pReadPages[0]);
 }
 
 void Memory::SetCommonRule(CommonMemoryRule* pRule)
@@ -349,7 +365,7 @@ void Memory::LoadBank0and1FromROM(u8* pTheROM)
 
 void Memory::MemoryDump(const char* szFilePath)
 {
-    if (!IsValidPointer(m_pDisassembledMap))
+    if (!IsValidPointer(m_pExecutedMap))
         return;
 
     using namespace std;
@@ -361,10 +377,12 @@ void Memory::MemoryDump(const char* szFilePath)
     {
         for (int i = 0; i < 65536; i++)
         {
-            if (IsValidPointer(m_pDisassembledMap[i]) && (m_pDisassembledMap[i]->name[0] != 0))
+            GB_Disassembler_Record* record = LookupDisassemblerRecord(i, false);
+
+            if (IsValidPointer(record) && (record->name[0] != 0))
             {
-                myfile << "0x" << hex << i << "\t " << m_pDisassembledMap[i]->name << "\n";
-                i += (m_pDisassembledMap[i]->size - 1);
+                myfile << "0x" << hex << i << "\t " << record->name << "\n";
+                i += (record->size - 1);
             }
             else
             {
@@ -418,6 +436,7 @@ void Memory::PerformDMA(u8 value)
             Load(0xFE00 + i, Read(address + i));
     }
 
+    m_pVideo->MarkOAMChanged();
     TraceLCDDMAEvent(TRACE_LCD_OAM_DMA_END, source, 0xFE00, 0x00A0);
 }
 
@@ -689,24 +708,52 @@ u8* Memory::GetWRAM1()
     return m_bCGB ? m_pWRAMBanks + (0x1000 * m_iCurrentWRAMBank) : m_pMap + 0xD000;
 }
 
+u8 Memory::DebugRetrieve(u16 address, u16 bank)
+{
+    if ((address >= 0x8000) || (bank == GetTraceBank(address)))
+        return DebugRetrieve(address);
+
+    u32 offset = GetDisassemblerOffset(address, bank);
+
+    if (IsValidPointer(m_pCartridge) && (offset < (u32)m_pCartridge->GetTotalSize()))
+        return m_pCartridge->GetTheROM()[offset];
+
+    return 0xFF;
+}
+
+GB_Disassembler_Record* Memory::FindDisassemblerRecord(u16 address, u16 bank)
+{
+    bool rom = (address < 0x8000);
+    u32 offset = GetDisassemblerOffset(address, bank);
+
+    if (rom && offset >= m_iDisassembledROMSize)
+        return NULL;
+
+    return LookupDisassemblerRecord(offset, rom);
+}
+
 GB_Disassembler_Record* Memory::GetOrCreateDisassemblerRecord(u16 address)
 {
-    u32 physical_address = GetPhysicalAddress(address);
+    return GetOrCreateDisassemblerRecord(address, GetTraceBank(address));
+}
+
+GB_Disassembler_Record* Memory::GetOrCreateDisassemblerRecord(u16 address, u16 bank)
+{
     bool rom = (address < 0x8000);
 
-    GB_Disassembler_Record** map = rom ? m_pDisassembledROMMap : m_pDisassembledMap;
-    u32 offset = rom ? physical_address : (u32)address;
+    u32 offset = GetDisassemblerOffset(address, bank);
 
-    if (rom && offset >= MAX_ROM_SIZE)
+    if (rom && offset >= m_iDisassembledROMSize)
         return NULL;
 
-    GB_Disassembler_Record* record = map[offset];
+    GB_Disassembler_Record** page = GetDisassemblerPage(offset, rom);
+    GB_Disassembler_Record* record = page[offset & DISASSEMBLER_PAGE_MASK];
 
     if (!IsValidPointer(record))
     {
         record = new GB_Disassembler_Record();
-        record->address = physical_address;
-        record->bank = GetBank(address);
+        record->address = offset;
+        record->bank = rom ? (u8)bank : 0;
         record->segment[0] = 0;
         record->name[0] = 0;
         record->bytes[0] = 0;
@@ -724,15 +771,81 @@ GB_Disassembler_Record* Memory::GetOrCreateDisassemblerRecord(u16 address)
         record->operand_offset = 0;
         record->operand_length = 0;
         record->auto_symbol[0] = 0;
-        map[offset] = record;
+        page[offset & DISASSEMBLER_PAGE_MASK] = record;
+    }
+
+    return record;
+}
+
+GB_Disassembler_Record* Memory::DecodeDisassemblerRecord(u16 address, u16 bank, u32 offset, bool rom)
+{
+    GB_Disassembler_Record* record = LookupDisassemblerRecord(offset, rom);
+
+    if (!IsValidPointer(record))
+        record = GetOrCreateDisassemblerRecord(address, bank);
+
+    bool changed = (record->size == 0);
+
+    // ROM never changes under a record, RAM may hold self modifying code
+    if (!changed && !rom)
+    {
+        int max_size = MIN(record->size, 4);
+        for (int i = 0; i < max_size; i++)
+        {
+            if (record->opcodes[i] != DebugRetrieve(address + i))
+            {
+                changed = true;
+                break;
+            }
+        }
     }
 
+    if (changed)
+        m_pProcessor->PopulateDisassemblerRecord(record, address, bank, 0);
+
     return record;
 }
 
+void Memory::ClearExecuted(u16 address, u16 bank)
+{
+    bool rom = (address < 0x8000);
+    u32 offset = GetDisassemblerOffset(address, bank);
+
+    if (rom && offset >= m_iDisassembledROMSize)
+        return;
+
+    u8* map = rom ? m_pExecutedROMMap : m_pExecutedMap;
+    map[offset >> 3] &= (u8)~(1 << (offset & 0x07));
+}
+
+void Memory::DisassembleExecuted()
+{
+    #ifndef GEARBOY_DISABLE_DISASSEMBLER
+
+    for (u32 i = 0; i < (m_iDisassembledROMSize >> 3); i++)
+    {
+        if (m_pExecutedROMMap[i] == 0)
+            continue;
+
+        for (u32 bit = 0; bit < 8; bit++)
+        {
+            if (!(m_pExecutedROMMap[i] & (1 << bit)))
+                continue;
+
+            u32 offset = (i << 3) + bit;
+            u16 bank = (u16)(offset >> 14);
+            u16 address = (u16)(((bank == 0) ? 0x0000 : 0x4000) | (offset & 0x3FFF));
+            GetDisassemblerRecord(address, bank);
+        }
+    }
+
+    #endif
+}
+
 void Memory::EnableBootromDMG(bool enable)
 {
     m_bBootromDMGEnabled = enable;
+    RefreshROMReadPages();
 
     if (m_bBootromDMGEnabled)
     {
@@ -747,6 +860,7 @@ void Memory::EnableBootromDMG(bool enable)
 void Memory::EnableBootromGBC(bool enable)
 {
     m_bBootromGBCEnabled = enable;
+    RefreshROMReadPages();
 
     if (m_bBootromGBCEnabled)
     {
@@ -785,6 +899,7 @@ void Memory::DisableBootromRegistry()
     }
 
     m_bBootromRegistryDisabled = true;
+    RefreshROMReadPages();
 }
 
 bool Memory::IsBootromRegistryEnabled()
@@ -796,59 +911,122 @@ void Memory::ResetDisassemblerRecords()
 {
     #ifndef GEARBOY_DISABLE_DISASSEMBLER
 
-    if (IsValidPointer(m_pDisassembledROMMap))
+    FreeDisassemblerPages();
+
+    if (IsValidPointer(m_pExecutedMap))
+        memset(m_pExecutedMap, 0, 65536 >> 3);
+
+    // Sized to the loaded cartridge so small ROMs only pay for what they use
+    u32 size = IsValidPointer(m_pCartridge) ? (u32)m_pCartridge->GetTotalSize() : 0;
+    ResizeROMDisassembler(MAX(size, 0x8000u));
+
+    #endif
+}
+
+u32 Memory::GetROMDisassemblerSize() const
+{
+    return m_iDisassembledROMSize;
+}
+
+GB_Disassembler_Record* Memory::GetROMDisassemblerRecord(u32 physical_address)
+{
+    if (physical_address >= m_iDisassembledROMSize)
+        return NULL;
+
+    return LookupDisassemblerRecord(physical_address, true);
+}
+
+GB_Disassembler_Record** Memory::GetDisassemblerPage(u32 offset, bool rom)
+{
+    GB_Disassembler_Record*** pages = rom ? m_pDisassembledROMPages : m_pDisassembledPages;
+    u32 index = offset >> DISASSEMBLER_PAGE_SHIFT;
+
+    if (!IsValidPointer(pages[index]))
     {
-        for (int i = 0; i < MAX_ROM_SIZE; i++)
-        {
-            SafeDelete(m_pDisassembledROMMap[i]);
-        }
+        pages[index] = new GB_Disassembler_Record*[DISASSEMBLER_PAGE_SIZE];
+        for (int i = 0; i < DISASSEMBLER_PAGE_SIZE; i++)
+            InitPointer(pages[index][i]);
     }
-    if (IsValidPointer(m_pDisassembledMap))
+
+    return pages[index];
+}
+
+void Memory::DeleteDisassemblerRecord(u32 offset, bool rom)
+{
+    if (rom && offset >= m_iDisassembledROMSize)
+        return;
+
+    GB_Disassembler_Record** page = rom ? m_pDisassembledROMPages[offset >> DISASSEMBLER_PAGE_SHIFT] : m_pDisassembledPages[offset >> DISASSEMBLER_PAGE_SHIFT];
+
+    if (IsValidPointer(page))
+        SafeDelete(page[offset & DISASSEMBLER_PAGE_MASK]);
+}
+
+void Memory::FreeDisassemblerPage(GB_Disassembler_Record**& page)
+{
+    if (!IsValidPointer(page))
+        return;
+
+    for (int i = 0; i < DISASSEMBLER_PAGE_SIZE; i++)
+        SafeDelete(page[i]);
+
+    SafeDeleteArray(page);
+}
+
+void Memory::FreeDisassemblerPages()
+{
+    if (IsValidPointer(m_pDisassembledROMPages))
     {
-        for (int i = 0; i < 65536; i++)
-        {
-            SafeDelete(m_pDisassembledMap[i]);
-        }
+        for (u32 i = 0; i < (m_iDisassembledROMSize >> DISASSEMBLER_PAGE_SHIFT); i++)
+            FreeDisassemblerPage(m_pDisassembledROMPages[i]);
     }
 
-    #endif
+    for (int i = 0; i < DISASSEMBLER_RAM_PAGE_COUNT; i++)
+        FreeDisassemblerPage(m_pDisassembledPages[i]);
 }
 
-void Memory::ResetBootromDisassembledMemory()
+void Memory::ResizeROMDisassembler(u32 size)
 {
-    #ifndef GEARBOY_DISABLE_DISASSEMBLER
+    size = (size + DISASSEMBLER_PAGE_SIZE - 1) & ~(u32)DISASSEMBLER_PAGE_MASK;
 
-    if (IsValidPointer(m_pDisassembledROMMap))
+    if (size != m_iDisassembledROMSize)
     {
-        for (int i = 0; i < 0x0100; i++)
-        {
-            SafeDelete(m_pDisassembledROMMap[i]);
-        }
+        FreeDisassemblerPages();
+        SafeDeleteArray(m_pDisassembledROMPages);
+        SafeDeleteArray(m_pExecutedROMMap);
+
+        m_iDisassembledROMSize = size;
+        m_pDisassembledROMPages = new GB_Disassembler_Record**[size >> DISASSEMBLER_PAGE_SHIFT];
+        m_pExecutedROMMap = new u8[size >> 3];
+
+        for (u32 i = 0; i < (size >> DISASSEMBLER_PAGE_SHIFT); i++)
+            InitPointer(m_pDisassembledROMPages[i]);
     }
-    if (IsValidPointer(m_pDisassembledMap))
+
+    memset(m_pExecutedROMMap, 0, size >> 3);
+}
+
+void Memory::ResetBootromDisassembledMemory()
+{
+    #ifndef GEARBOY_DISABLE_DISASSEMBLER
+
+    for (int i = 0; i < 0x0100; i++)
     {
-        for (int i = 0; i < 0x0100; i++)
-        {
-            SafeDelete(m_pDisassembledMap[i]);
-        }
+        DeleteDisassemblerRecord(i, true);
+        DeleteDisassemblerRecord(i, false);
     }
+    if (IsValidPointer(m_pExecutedROMMap))
+        memset(m_pExecutedROMMap, 0, 0x0100 >> 3);
 
     if (m_bCGB)
     {
-        if (IsValidPointer(m_pDisassembledROMMap))
+        for (int i = 0x0200; i < 0x0900; i++)
         {
-            for (int i = 0x0200; i < 0x0900; i++)
-            {
-                SafeDelete(m_pDisassembledROMMap[i]);
-            }
-        }
-        if (IsValidPointer(m_pDisassembledMap))
-        {
-            for (int i = 0x0200; i < 0x0900; i++)
-            {
-                SafeDelete(m_pDisassembledMap[i]);
-            }
+            DeleteDisassemblerRecord(i, true);
+            DeleteDisassemblerRecord(i, false);
         }
+        if (IsValidPointer(m_pExecutedROMMap))
+            memset(m_pExecutedROMMap + (0x0200 >> 3), 0, (0x0900 - 0x0200) >> 3);
     }
 
     #endif
@@ -910,6 +1088,8 @@ bool Memory::LoadBootromFromBuffer(const u8* buffer, int size, bool gbc)
     else
         m_bBootromDMGLoaded = true;
 
+    RefreshROMReadPages();
+
     return true;
 }
 
@@ -919,6 +1099,8 @@ void Memory::UnloadBootrom(bool gbc)
         m_bBootromGBCLoaded = false;
     else
         m_bBootromDMGLoaded = false;
+
+    RefreshROMReadPages();
 }
 
 bool Memory::IsBootromLoaded(bool gbc)
@@ -22,6 +22,7 @@
 
 #include "definitions.h"
 #include "MemoryRule.h"
+#include "Profiler.h"
 #include <vector>
 
 class Processor;
@@ -29,6 +30,12 @@ class Video;
 class CommonMemoryRule;
 class IORegistersMemoryRule;
 class TraceLogger;
+class Cartridge;
+
+#define DISASSEMBLER_PAGE_SHIFT 10
+#define DISASSEMBLER_PAGE_SIZE (1 << DISASSEMBLER_PAGE_SHIFT)
+#define DISASSEMBLER_PAGE_MASK (DISASSEMBLER_PAGE_SIZE - 1)
+#define DISASSEMBLER_RAM_PAGE_COUNT (0x10000 >> DISASSEMBLER_PAGE_SHIFT)
 
 class Memory
 {
@@ -37,13 +44,16 @@ public:
     ~Memory();
     void SetProcessor(Processor* pProcessor);
     void SetVideo(Video* pVideo);
+    void SetCartridge(Cartridge* pCartridge);
     void Init();
     void Reset(bool bCGB, bool bSGB = false);
     void SetCurrentRule(MemoryRule* pRule);
-    void RefreshDirectROMPages();
+    void RefreshReadPages();
+    void RefreshROMReadPages();
     void SetCommonRule(CommonMemoryRule* pRule);
     void SetIORule(IORegistersMemoryRule* pRule);
     void SetTraceLogger(TraceLogger* pTraceLogger);
+    void SetProfiler(Profiler* pProfiler);
     MemoryRule* GetCurrentRule();
     u8* GetMemoryMap();
     u8 Read(u16 address);
@@ -53,16 +63,24 @@ public:
     void SwitchCGBWRAM(u8 value);
     u8 ReadCGBLCDRAM(u16 address, bool forceBank1);
     void WriteCGBLCDRAM(u16 address, u8 value);
+    void WriteOAM(u16 address, u8 value);
     void SwitchCGBLCDRAM(u8 value);
     INLINE bool IsVRAMAccessBlocked() const;
     u8 Retrieve(u16 address);
     void Load(u16 address, u8 value);
     u8 DebugRetrieve(u16 address);
+    u8 DebugRetrieve(u16 address, u16 bank);
     GB_Disassembler_Record* GetDisassemblerRecord(u16 address);
     GB_Disassembler_Record* GetDisassemblerRecord(u16 address, u16 bank);
+    GB_Disassembler_Record* FindDisassemblerRecord(u16 address, u16 bank);
     GB_Disassembler_Record* GetOrCreateDisassemblerRecord(u16 address);
+    GB_Disassembler_Record* GetOrCreateDisassemblerRecord(u16 address, u16 bank);
+    INLINE void MarkExecuted(u16 address);
+    void ClearExecuted(u16 address, u16 bank);
+    void DisassembleExecuted();
     void ResetDisassemblerRecords();
-    GB_Disassembler_Record** GetAllDisassemblerRecords();
+    u32 GetROMDisassemblerSize() const;
+    GB_Disassembler_Record* GetROMDisassemblerRecord(u32 physical_address);
     void LoadBank0and1FromROM(u8* pTheROM);
     void MemoryDump(const char* szFilePath);
     void PerformDMA(u8 value);
@@ -103,6 +121,18 @@ public:
 private:
     void LoadBootroom(const char* szFilePath, bool gbc);
     NO_INLINE void CheckBreakpoints(u16 address, bool write);
+    INLINE void RefreshWRAMReadPages();
+    INLINE u8 PerformRuleRead(u16 address);
+    INLINE void PerformRuleWrite(u16 address, u8 value);
+    INLINE u32 GetDisassemblerOffset(u16 address, u16 bank);
+    INLINE GB_Disassembler_Record* LookupDisassemblerRecord(u32 offset, bool rom);
+    INLINE bool IsExecuted(u32 offset, bool rom);
+    GB_Disassembler_Record** GetDisassemblerPage(u32 offset, bool rom);
+    void DeleteDisassemblerRecord(u32 offset, bool rom);
+    void FreeDisassemblerPage(GB_Disassembler_Record**& page);
+    void FreeDisassemblerPages();
+    void ResizeROMDisassembler(u32 size);
+    NO_INLINE GB_Disassembler_Record* DecodeDisassemblerRecord(u16 address, u16 bank, u32 offset, bool rom);
     bool IsHDMASourceInvalid() const;
     INLINE void TraceLCDDMAEvent(u8 event, u16 source, u16 destination, u16 length);
     NO_INLINE void LogLCDDMAEvent(u8 event, u16 source, u16 destination, u16 length);
@@ -110,14 +140,20 @@ private:
 private:
     Processor* m_pProcessor;
     Video* m_pVideo;
+    Cartridge* m_pCartridge;
     CommonMemoryRule* m_pCommonMemoryRule;
     IORegistersMemoryRule* m_pIORegistersMemoryRule;
     TraceLogger* m_pTraceLogger;
+    Profiler* m_pProfiler;
     MemoryRule* m_pCurrentMemoryRule;
-    u8* m_pDirectROMPages[2];
+    GB_Memory_Rule_Type m_CurrentRuleType;
+    u8* m_pReadPages[16];
     u8* m_pMap;
-    GB_Disassembler_Record** m_pDisassembledMap;
-    GB_Disassembler_Record** m_pDisassembledROMMap;
+    GB_Disassembler_Record** m_pDisassembledPages[DISASSEMBLER_RAM_PAGE_COUNT];
+    GB_Disassembler_Record*** m_pDisassembledROMPages;
+    u32 m_iDisassembledROMSize;
+    u8* m_pExecutedMap;
+    u8* m_pExecutedROMMap;
     bool m_bCGB;
     int m_iCurrentWRAMBank;
     int m_iCurrentLCDRAMBank;
@@ -72,6 +72,11 @@ void MemoryRule::LogTraceMapperEvent(u16 address, u8 value, u8 event, u8 flags,
 #endif
 }
 
+GB_Memory_Rule_Type MemoryRule::GetRuleType()
+{
+    return GB_Memory_Rule_Generic;
+}
+
 bool MemoryRule::NeedsHighMemoryAccessNotifications()
 {
     return false;
@@ -32,6 +32,16 @@ class Input;
 class Cartridge;
 class Audio;
 
+enum GB_Memory_Rule_Type
+{
+    GB_Memory_Rule_Generic = 0,
+    GB_Memory_Rule_RomOnly,
+    GB_Memory_Rule_MBC1,
+    GB_Memory_Rule_MBC2,
+    GB_Memory_Rule_MBC3,
+    GB_Memory_Rule_MBC5
+};
+
 class MemoryRule
 {
 public:
@@ -42,6 +52,7 @@ public:
     virtual u8 PerformRead(u16 address) = 0;
     virtual void PerformWrite(u16 address, u8 value) = 0;
     virtual bool MapsROMDirectly();
+    virtual GB_Memory_Rule_Type GetRuleType();
     virtual bool NeedsHighMemoryAccessNotifications();
     virtual void NotifyHighMemoryRead(u16 address);
     virtual void NotifyHighMemoryWrite(u16 address, u8 value);
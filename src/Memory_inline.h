@@ -3,6 +3,15 @@
 
 #include "CommonMemoryRule.h"
 #include "IORegistersMemoryRule.h"
+#include "RomOnlyMemoryRule.h"
+#include "MBC1MemoryRule.h"
+#include "MBC2MemoryRule.h"
+#include "MBC3MemoryRule.h"
+#include "MBC5MemoryRule.h"
+#include "RomOnlyMemoryRule_inline.h"
+#include "MBC1MemoryRule_inline.h"
+#include "MBC3MemoryRule_inline.h"
+#include "MBC5MemoryRule_inline.h"
 
 INLINE void Memory::TraceLCDDMAEvent(u8 event, u16 source, u16 destination, u16 length)
 {
@@ -10,6 +19,53 @@ INLINE void Memory::TraceLCDDMAEvent(u8 event, u16 source, u16 destination, u16
         LogLCDDMAEvent(event, source, destination, length);
 }
 
+// The common mappers are called directly and their reads are defined
+// in the *_inline.h headers, so they inline without LTO. Anything else
+// goes through the virtual interface
+INLINE u8 Memory::PerformRuleRead(u16 address)
+{
+    switch (m_CurrentRuleType)
+    {
+        case GB_Memory_Rule_RomOnly:
+            return static_cast<RomOnlyMemoryRule*>(m_pCurrentMemoryRule)->RomOnlyMemoryRule::PerformRead(address);
+        case GB_Memory_Rule_MBC1:
+            return static_cast<MBC1MemoryRule*>(m_pCurrentMemoryRule)->MBC1MemoryRule::PerformRead(address);
+        case GB_Memory_Rule_MBC2:
+            return static_cast<MBC2MemoryRule*>(m_pCurrentMemoryRule)->MBC2MemoryRule::PerformRead(address);
+        case GB_Memory_Rule_MBC3:
+            return static_cast<MBC3MemoryRule*>(m_pCurrentMemoryRule)->MBC3MemoryRule::PerformRead(address);
+        case GB_Memory_Rule_MBC5:
+            return static_cast<MBC5MemoryRule*>(m_pCurrentMemoryRule)->MBC5MemoryRule::PerformRead(address);
+        default:
+            return m_pCurrentMemoryRule->PerformRead(address);
+    }
+}
+
+INLINE void Memory::PerformRuleWrite(u16 address, u8 value)
+{
+    switch (m_CurrentRuleType)
+    {
+        case GB_Memory_Rule_RomOnly:
+            static_cast<RomOnlyMemoryRule*>(m_pCurrentMemoryRule)->RomOnlyMemoryRule::PerformWrite(address, value);
+            break;
+        case GB_Memory_Rule_MBC1:
+            static_cast<MBC1MemoryRule*>(m_pCurrentMemoryRule)->MBC1MemoryRule::PerformWrite(address, value);
+            break;
+        case GB_Memory_Rule_MBC2:
+            static_cast<MBC2MemoryRule*>(m_pCurrentMemoryRule)->MBC2MemoryRule::PerformWrite(address, value);
+            break;
+        case GB_Memory_Rule_MBC3:
+            static_cast<MBC3MemoryRule*>(m_pCurrentMemoryRule)->MBC3MemoryRule::PerformWrite(address, value);
+            break;
+        case GB_Memory_Rule_MBC5:
+            static_cast<MBC5MemoryRule*>(m_pCurrentMemoryRule)->MBC5MemoryRule::PerformWrite(address, value);
+            break;
+        default:
+            m_pCurrentMemoryRule->PerformWrite(address, value);
+            break;
+    }
+}
+
 inline u8 Memory::Read(u16 address)
 {
     #ifndef GEARBOY_DISABLE_DISASSEMBLER
@@ -17,6 +73,11 @@ inline u8 Memory::Read(u16 address)
         CheckBreakpoints(address, false);
     #endif
 
+    u8* page = m_pReadPages[address >> 12];
+
+    if (likely(IsValidPointer(page)))
+        return page[address & 0x0FFF];
+
     switch (address & 0xE000)
     {
         case 0x0000:
@@ -35,25 +96,13 @@ inline u8 Memory::Read(u16 address)
                 }
             }
 
-            if (likely(IsValidPointer(m_pDirectROMPages[0])))
-                return m_pDirectROMPages[0][address];
-
-            return m_pCurrentMemoryRule->PerformRead(address);
+            return PerformRuleRead(address);
         }
         case 0x2000:
-        {
-            if (likely(IsValidPointer(m_pDirectROMPages[0])))
-                return m_pDirectROMPages[0][address];
-
-            return m_pCurrentMemoryRule->PerformRead(address);
-        }
         case 0x4000:
         case 0x6000:
         {
-            if (likely(IsValidPointer(m_pDirectROMPages[1])))
-                return m_pDirectROMPages[1][address & 0x3FFF];
-
-            return m_pCurrentMemoryRule->PerformRead(address);
+            return PerformRuleRead(address);
         }
         case 0x8000:
         {
@@ -61,7 +110,10 @@ inline u8 Memory::Read(u16 address)
         }
         case 0xA000:
         {
-            return m_pCurrentMemoryRule->PerformRead(address);
+            u64 profiler_start = m_pProfiler->Begin();
+            u8 value = PerformRuleRead(address);
+            m_pProfiler->End(PROFILER_MEMORY_RULES, profiler_start);
+            return value;
         }
         case 0xC000:
         case 0xE000:
@@ -95,9 +147,11 @@ inline void Memory::Write(u16 address, u8 value)
         case 0x4000:
         case 0x6000:
         {
-            m_pCurrentMemoryRule->PerformWrite(address, value);
+            u64 profiler_start = m_pProfiler->Begin();
+            PerformRuleWrite(address, value);
             if (m_bCurrentRuleMapsROMDirectly)
-                RefreshDirectROMPages();
+                RefreshROMReadPages();
+            m_pProfiler->End(PROFILER_MEMORY_RULES, profiler_start);
             break;
         }
         case 0x8000:
@@ -107,7 +161,9 @@ inline void Memory::Write(u16 address, u8 value)
         }
         case 0xA000:
         {
-            m_pCurrentMemoryRule->PerformWrite(address, value);
+            u64 profiler_start = m_pProfiler->Begin();
+            PerformRuleWrite(address, value);
+            m_pProfiler->End(PROFILER_MEMORY_RULES, profiler_start);
             break;
         }
         case 0xC000:
@@ -146,12 +202,37 @@ INLINE void Memory::WriteCGBWRAM(u16 address, u8 value)
         m_pWRAMBanks[(address - 0xD000) + (0x1000 * m_iCurrentWRAMBank)] = value;
 }
 
+INLINE void Memory::RefreshWRAMReadPages()
+{
+    // Rules that watch high memory need every access to reach them
+    if (m_bCurrentRuleNeedsHighMemoryAccessNotifications)
+    {
+        InitPointer(m_pReadPages[0xC]);
+        InitPointer(m_pReadPages[0xD]);
+        InitPointer(m_pReadPages[0xE]);
+    }
+    else if (m_bCGB)
+    {
+        m_pReadPages[0xC] = m_pWRAMBanks;
+        m_pReadPages[0xD] = m_pWRAMBanks + (0x1000 * m_iCurrentWRAMBank);
+        m_pReadPages[0xE] = m_pWRAMBanks;
+    }
+    else
+    {
+        m_pReadPages[0xC] = m_pMap + 0xC000;
+        m_pReadPages[0xD] = m_pMap + 0xD000;
+        m_pReadPages[0xE] = m_pMap + 0xE000;
+    }
+}
+
 INLINE void Memory::SwitchCGBWRAM(u8 value)
 {
     m_iCurrentWRAMBank = value & 0x07;
 
     if (m_iCurrentWRAMBank == 0)
         m_iCurrentWRAMBank = 1;
+
+    RefreshWRAMReadPages();
 }
 
 INLINE u8 Memory::ReadCGBLCDRAM(u16 address, bool forceBank1)
@@ -168,6 +249,14 @@ INLINE void Memory::WriteCGBLCDRAM(u16 address, u8 value)
         m_pLCDRAMBank1[address - 0x8000] = value;
     else
         Load(address, value);
+
+    m_pVideo->InvalidateTileRow(m_iCurrentLCDRAMBank, address);
+}
+
+INLINE void Memory::WriteOAM(u16 address, u8 value)
+{
+    Load(address, value);
+    m_pVideo->MarkOAMChanged();
 }
 
 INLINE void Memory::SwitchCGBLCDRAM(u8 value)
@@ -256,37 +345,58 @@ inline u16 Memory::GetTraceBank(u16 address)
         return (u16)m_pCurrentMemoryRule->GetCurrentRomBank1Index();
 }
 
-inline GB_Disassembler_Record* Memory::GetDisassemblerRecord(u16 address)
+INLINE u32 Memory::GetDisassemblerOffset(u16 address, u16 bank)
 {
-    u32 physical_address = GetPhysicalAddress(address);
-    bool rom = (address < 0x8000);
+    if (address >= 0x8000)
+        return (u32)address;
 
-    if (rom)
-    {
-        if (physical_address >= MAX_ROM_SIZE)
-            return NULL;
-        return m_pDisassembledROMMap[physical_address];
-    }
-    else
+    return (u32)(0x4000 * bank) + (address & 0x3FFF);
+}
+
+INLINE GB_Disassembler_Record* Memory::LookupDisassemblerRecord(u32 offset, bool rom)
+{
+    GB_Disassembler_Record** page = rom ? m_pDisassembledROMPages[offset >> DISASSEMBLER_PAGE_SHIFT] : m_pDisassembledPages[offset >> DISASSEMBLER_PAGE_SHIFT];
+    return IsValidPointer(page) ? page[offset & DISASSEMBLER_PAGE_MASK] : NULL;
+}
+
+INLINE bool Memory::IsExecuted(u32 offset, bool rom)
+{
+    u8* map = rom ? m_pExecutedROMMap : m_pExecutedMap;
+    return (map[offset >> 3] & (1 << (offset & 0x07))) != 0;
+}
+
+// The processor only flags executed addresses, records are decoded
+// the first time something asks for them
+INLINE void Memory::MarkExecuted(u16 address)
+{
+    if (address >= 0x8000)
     {
-        return m_pDisassembledMap[physical_address];
+        m_pExecutedMap[address >> 3] |= (u8)(1 << (address & 0x07));
+        return;
     }
+
+    u32 physical_address = GetPhysicalAddress(address);
+    if (physical_address < m_iDisassembledROMSize)
+        m_pExecutedROMMap[physical_address >> 3] |= (u8)(1 << (physical_address & 0x07));
+}
+
+inline GB_Disassembler_Record* Memory::GetDisassemblerRecord(u16 address)
+{
+    return GetDisassemblerRecord(address, GetTraceBank(address));
 }
 
 inline GB_Disassembler_Record* Memory::GetDisassemblerRecord(u16 address, u16 bank)
 {
-    if (address >= 0x8000)
-        return m_pDisassembledMap[address];
+    bool rom = (address < 0x8000);
+    u32 offset = GetDisassemblerOffset(address, bank);
 
-    u32 physical_address = (u32)(0x4000 * bank) + (address & 0x3FFF);
-    if (physical_address >= MAX_ROM_SIZE)
+    if (rom && offset >= m_iDisassembledROMSize)
         return NULL;
-    return m_pDisassembledROMMap[physical_address];
-}
 
-inline GB_Disassembler_Record** Memory::GetAllDisassemblerRecords()
-{
-    return m_pDisassembledROMMap;
+    if (IsExecuted(offset, rom))
+        return DecodeDisassemblerRecord(address, bank, offset, rom);
+
+    return LookupDisassemblerRecord(offset, rom);
 }
 
 INLINE bool Memory::IsVRAMAccessBlocked() const
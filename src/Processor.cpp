@@ -22,6 +22,7 @@
 #include <ctype.h>
 #include "Processor.h"
 #include "TraceLogger.h"
+#include "CodeProfiler.h"
 #include "opcode_timing.h"
 #include "opcode_names.h"
 #include "common.h"
@@ -31,6 +32,8 @@ Processor::Processor(Memory* pMemory)
     m_pMemory = pMemory;
     m_pMemory->SetProcessor(this);
     InitPointer(m_pTraceLogger);
+    InitPointer(m_pCodeProfiler);
+    InitPointer(m_pScheduler);
     InitOPCodeTable();
     m_bIME = false;
     m_bHalt = false;
@@ -47,6 +50,7 @@ Processor::Processor(Memory* pMemory)
     m_iSerialCycles = 0;
     m_bCGB = false;
     m_iUnhaltCycles = 0;
+    m_iInstructionCount = 0;
     m_iInterruptDelayCycles = 0;
     m_iAccurateOPCodeState = 0;
     m_iReadCache = 0;
@@ -78,6 +82,16 @@ void Processor::SetTraceLogger(TraceLogger* pTraceLogger)
     m_pTraceLogger = pTraceLogger;
 }
 
+void Processor::SetCodeProfiler(CodeProfiler* pCodeProfiler)
+{
+    m_pCodeProfiler = pCodeProfiler;
+}
+
+void Processor::SetScheduler(Scheduler* pScheduler)
+{
+    m_pScheduler = pScheduler;
+}
+
 void Processor::SetDisassemblerSyntax(GB_Disassembler_Syntax syntax)
 {
     if (syntax < GB_Disassembler_Syntax_Gearboy || syntax >= GB_Disassembler_Syntax_Count)
@@ -113,6 +127,7 @@ void Processor::Reset(bool bCGB, bool bGBA, bool bSGB)
     m_iSerialBit = 0;
     m_iSerialCycles = 0;
     m_iUnhaltCycles = 0;
+    m_iInstructionCount = 0;
 
     if(m_pMemory->IsBootromEnabled())
     {
@@ -191,10 +206,6 @@ void Processor::LogTraceInstruction(u16 pc, bool halt_bug)
         e.cpu.opcodes[i] = m_pMemory->DebugRetrieve(address);
     }
 
-    GB_Disassembler_Record* record = m_pMemory->GetDisassemblerRecord(pc, e.cpu.bank);
-    if (IsValidPointer(record))
-        strncpy_fit(e.cpu.name, record->name, sizeof(e.cpu.name));
-
     m_pTraceLogger->TraceLog(e);
 #else
     UNUSED(pc);
@@ -327,10 +338,13 @@ void Processor::ServeInterrupt(Interrupts interrupt)
             {
                 while (!m_disassembler_call_stack.empty())
                     m_disassembler_call_stack.pop();
+                m_pCodeProfiler->ClearFrames();
             }
             while (!temp.empty())
             {
                 m_disassembler_call_stack.push(temp.top());
+                if (found_same)
+                    m_pCodeProfiler->PushFrame(temp.top().dest, temp.top().bank);
                 temp.pop();
             }
         }
@@ -398,43 +412,23 @@ void Processor::DisassembleNextOPCode()
     CheckBreakpoints();
 
     u16 address = PC.GetValue();
-    GB_Disassembler_Record* record = m_pMemory->GetOrCreateDisassemblerRecord(address);
-
-    assert(IsValidPointer(record));
-
-    int opcode_size = record->size;
+    m_pMemory->MarkExecuted(address);
 
-    bool changed = (opcode_size == 0);
-
-    if (!changed)
+    // Interrupt handlers are decoded right away so the entry keeps its tag
+    if (m_debug_next_irq > 0)
     {
-        int maxSize = std::min(opcode_size, 4);
-        for (int i = 0; i < maxSize; i++)
-        {
-            u8 mem_byte = m_pMemory->DebugRetrieve(address + i);
-            if (record->opcodes[i] != mem_byte)
-            {
-                changed = true;
-                break;
-            }
-        }
-    }
+        u16 bank = m_pMemory->GetTraceBank(address);
+        GB_Disassembler_Record* record = m_pMemory->GetOrCreateDisassemblerRecord(address, bank);
 
-    if (!changed && record->size != 0)
-    {
-        if (m_debug_next_irq > 0)
-        {
-            record->irq = m_debug_next_irq;
-            m_debug_next_irq = 0;
-        }
-        return;
-    }
+        if (IsValidPointer(record))
+            PopulateDisassemblerRecord(record, address, bank, m_debug_next_irq);
 
-    PopulateDisassemblerRecord(record, address);
+        m_debug_next_irq = 0;
+    }
 #endif
 }
 
-void Processor::FormatDisassemblerDataBytes(char* text, size_t text_size, const u8* bytes, int size)
+void Processor::FormatDisassemblerDataBytes(char* text, size_t text_size, const u8* bytes, int size) const
 {
     const char* directive = (m_disassembler_syntax == GB_Disassembler_Syntax_WLADX) ? ".db" : "db";
 
@@ -443,6 +437,44 @@ void Processor::FormatDisassemblerDataBytes(char* text, size_t text_size, const
         pos += snprintf(text + pos, text_size - pos, "%s{o}$%02X", (i == 0) ? "" : ",", bytes[i]);
 }
 
+void Processor::FormatOPCodeName(u16 address, const u8* opcodes, char* text, size_t text_size) const
+{
+    bool cb_prefix = (opcodes[0] == 0xCB);
+    const stOPCodeInfo& info = cb_prefix ? kOPCodeCBNames[opcodes[1]] : kOPCodeNames[opcodes[0]];
+    int name_first = cb_prefix ? 1 : 0;
+    const char* format = info.name[m_disassembler_syntax];
+
+    switch (info.type)
+    {
+        case GB_OPCode_Type_Implied:
+            strncpy_fit(text, format, text_size);
+            break;
+        case GB_OPCode_Type_1b_Signed:
+            snprintf(text, text_size, format, (s8)opcodes[name_first + 1]);
+            break;
+        case GB_OPCode_Type_1b:
+            snprintf(text, text_size, format, opcodes[name_first + 1]);
+            break;
+        case GB_OPCode_Type_2b:
+            snprintf(text, text_size, format, (u16)((opcodes[name_first + 2] << 8) | opcodes[name_first + 1]));
+            break;
+        case GB_OPCode_Type_Relative:
+            if (m_disassembler_syntax == GB_Disassembler_Syntax_WLADX)
+                snprintf(text, text_size, format, opcodes[name_first + 1]);
+            else
+                snprintf(text, text_size, format, (u16)(address + info.size + (s8)opcodes[name_first + 1]), (s8)opcodes[name_first + 1]);
+            break;
+        case GB_OPCode_Type_Data:
+            if (m_disassembler_syntax == GB_Disassembler_Syntax_Gearboy)
+                strncpy_fit(text, format, text_size);
+            else
+                FormatDisassemblerDataBytes(text, text_size, opcodes, MIN(info.size, 4));
+            break;
+        default:
+            strncpy_fit(text, "PARSE ERROR", text_size);
+    }
+}
+
 void Processor::SetDisassemblerOperandText(GB_Disassembler_Record* record, const char* text)
 {
     if (!IsValidPointer(text) || (text[0] == 0))
@@ -471,12 +503,27 @@ void Processor::SetDisassemblerOperand(GB_Disassembler_Record* record, u16 addre
     SetDisassemblerOperandText(record, text);
 }
 
-void Processor::PopulateDisassemblerRecord(GB_Disassembler_Record* record, u16 address)
+u16 Processor::GetDisassemblerBank(u16 origin, u16 origin_bank, u16 address)
+{
+    // Bytes that spill into the next 16KB window belong to whatever is mapped there
+    if ((origin ^ address) & 0xC000)
+        return m_pMemory->GetTraceBank(address);
+
+    return origin_bank;
+}
+
+u8 Processor::DisassemblerRetrieve(u16 origin, u16 origin_bank, u16 address)
+{
+    return m_pMemory->DebugRetrieve(address, GetDisassemblerBank(origin, origin_bank, address));
+}
+
+void Processor::PopulateDisassemblerRecord(GB_Disassembler_Record* record, u16 address, u16 bank, int irq)
 {
 #ifndef GEARBOY_DISABLE_DISASSEMBLER
 
-    record->address = m_pMemory->GetPhysicalAddress(address);
-    record->bank = m_pMemory->GetBank(address);
+    bool rom = (address < 0x8000);
+    record->address = rom ? ((u32)(0x4000 * bank) + (address & 0x3FFF)) : (u32)address;
+    record->bank = rom ? (u8)bank : 0;
     record->name[0] = 0;
     record->bytes[0] = 0;
     record->segment[0] = 0;
@@ -485,26 +532,20 @@ void Processor::PopulateDisassemblerRecord(GB_Disassembler_Record* record, u16 a
     record->jump_address = 0;
     record->jump_bank = 0;
     record->subroutine = false;
-    record->irq = 0;
+    record->irq = irq;
     record->has_operand_address = false;
     record->operand_address = 0;
     record->operand_is_zp = false;
     record->operand_offset = 0;
     record->operand_length = 0;
 
-    if (m_debug_next_irq > 0)
-    {
-        record->irq = m_debug_next_irq;
-        m_debug_next_irq = 0;
-    }
-
-    u8 opcode = m_pMemory->DebugRetrieve(address);
+    u8 opcode = DisassemblerRetrieve(address, bank, address);
     bool cb_prefix = (opcode == 0xCB);
 
     stOPCodeInfo info;
     if (cb_prefix)
     {
-        u8 cb_opcode = m_pMemory->DebugRetrieve(address + 1);
+        u8 cb_opcode = DisassemblerRetrieve(address, bank, address + 1);
         info = kOPCodeCBNames[cb_opcode];
     }
     else
@@ -515,28 +556,20 @@ void Processor::PopulateDisassemblerRecord(GB_Disassembler_Record* record, u16 a
     record->size = info.size;
 
     for (int i = 0; i < info.size && i < 4; i++)
-        record->opcodes[i] = m_pMemory->DebugRetrieve(address + i);
+        record->opcodes[i] = DisassemblerRetrieve(address, bank, address + i);
 
     format_hex_bytes(record->opcodes,
                      MIN(record->size, (int)sizeof(record->opcodes)),
                      record->bytes, sizeof(record->bytes));
 
-    InvalidateOverlappingRecords(address, (u8)record->size);
+    InvalidateOverlappingRecords(address, bank, (u8)record->size);
 
     int name_first = cb_prefix ? 1 : 0;
-    const char* format = info.name[m_disassembler_syntax];
+
+    FormatOPCodeName(address, record->opcodes, record->name, sizeof(record->name));
 
     switch (info.type)
     {
-        case GB_OPCode_Type_Implied:
-            strcpy(record->name, format);
-            break;
-        case GB_OPCode_Type_1b_Signed:
-            snprintf(record->name, sizeof(record->name), format, (s8)record->opcodes[name_first + 1]);
-            break;
-        case GB_OPCode_Type_1b:
-            snprintf(record->name, sizeof(record->name), format, record->opcodes[name_first + 1]);
-            break;
         case GB_OPCode_Type_2b:
         {
             u16 operand = (record->opcodes[name_first + 2] << 8) | record->opcodes[name_first + 1];
@@ -548,7 +581,6 @@ void Processor::PopulateDisassemblerRecord(GB_Disassembler_Record* record, u16 a
                 record->jump_address = operand;
                 record->jump_bank = m_pMemory->GetBank(operand);
             }
-            snprintf(record->name, sizeof(record->name), format, operand);
             char operand_text[8];
             snprintf(operand_text, sizeof(operand_text), "$%04X", operand);
             SetDisassemblerOperand(record, operand, false, operand_text);
@@ -564,30 +596,20 @@ void Processor::PopulateDisassemblerRecord(GB_Disassembler_Record* record, u16 a
             record->jump_bank = m_pMemory->GetBank(jump_address);
             if (m_disassembler_syntax == GB_Disassembler_Syntax_WLADX)
             {
-                snprintf(record->name, sizeof(record->name), format, record->opcodes[name_first + 1]);
                 char operand_text[8];
                 snprintf(operand_text, sizeof(operand_text), "$%02X", record->opcodes[name_first + 1]);
                 SetDisassemblerOperandText(record, operand_text);
             }
             else
             {
-                snprintf(record->name, sizeof(record->name), format, jump_address, (s8)record->opcodes[name_first + 1]);
                 char operand_text[8];
                 snprintf(operand_text, sizeof(operand_text), "$%04X", jump_address);
                 SetDisassemblerOperandText(record, operand_text);
             }
             break;
         }
-        case GB_OPCode_Type_Data:
-        {
-            if (m_disassembler_syntax == GB_Disassembler_Syntax_Gearboy)
-                strcpy(record->name, format);
-            else
-                FormatDisassemblerDataBytes(record->name, sizeof(record->name), record->opcodes, record->size);
-            break;
-        }
         default:
-            strcpy(record->name, "PARSE ERROR");
+            break;
     }
 
     if (!cb_prefix)
@@ -665,10 +687,14 @@ void Processor::PopulateDisassemblerRecord(GB_Disassembler_Record* record, u16 a
 #else
     UNUSED(record);
     UNUSED(address);
+    UNUSED(bank);
+    UNUSED(irq);
 #endif
 }
 
-void Processor::InvalidateOverlappingRecords(u16 address, u8 opcode_size)
+// Raw lookups keep lazy decoding from recursing, and dropping the
+// executed flag keeps the overwritten record from decoding back
+void Processor::InvalidateOverlappingRecords(u16 address, u16 bank, u8 opcode_size)
 {
 #ifndef GEARBOY_DISABLE_DISASSEMBLER
     for (int back = 1; back < 4; ++back)
@@ -677,7 +703,8 @@ void Processor::InvalidateOverlappingRecords(u16 address, u8 opcode_size)
         if (prev_start < 0)
             continue;
 
-        GB_Disassembler_Record* prev = m_pMemory->GetDisassemblerRecord((u16)prev_start);
+        u16 prev_bank = GetDisassemblerBank(address, bank, (u16)prev_start);
+        GB_Disassembler_Record* prev = m_pMemory->FindDisassemblerRecord((u16)prev_start, prev_bank);
         if (!IsValidPointer(prev) || prev->size == 0)
             continue;
 
@@ -687,6 +714,7 @@ void Processor::InvalidateOverlappingRecords(u16 address, u8 opcode_size)
             prev->size = 0;
             prev->name[0] = 0;
             prev->bytes[0] = 0;
+            m_pMemory->ClearExecuted((u16)prev_start, prev_bank);
         }
     }
 
@@ -695,17 +723,20 @@ void Processor::InvalidateOverlappingRecords(u16 address, u8 opcode_size)
         for (int fwd = 1; fwd < opcode_size; ++fwd)
         {
             u16 fwd_addr = address + fwd;
-            GB_Disassembler_Record* fwd_record = m_pMemory->GetDisassemblerRecord(fwd_addr);
+            u16 fwd_bank = GetDisassemblerBank(address, bank, fwd_addr);
+            GB_Disassembler_Record* fwd_record = m_pMemory->FindDisassemblerRecord(fwd_addr, fwd_bank);
             if (!IsValidPointer(fwd_record) || fwd_record->size == 0)
                 continue;
 
             fwd_record->size = 0;
             fwd_record->name[0] = 0;
             fwd_record->bytes[0] = 0;
+            m_pMemory->ClearExecuted(fwd_addr, fwd_bank);
         }
     }
 #else
     UNUSED(address);
+    UNUSED(bank);
     UNUSED(opcode_size);
 #endif
 }
@@ -749,12 +780,7 @@ void Processor::DisassembleAhead(u16 start_address, int count, int depth)
         }
 
         if (changed || record->size == 0)
-        {
-            int saved_irq = m_debug_next_irq;
-            m_debug_next_irq = 0;
-            PopulateDisassemblerRecord(record, address);
-            m_debug_next_irq = saved_irq;
-        }
+            PopulateDisassemblerRecord(record, address, m_pMemory->GetTraceBank(address), 0);
 
         if (record->jump)
         {
@@ -854,11 +880,6 @@ bool Processor::RunToBreakpointHit()
     return m_run_to_breakpoint_hit;
 }
 
-bool Processor::Halted()
-{
-    return m_bHalt;
-}
-
 void Processor::EnableBreakpoints(bool enable, bool irqs)
 {
     m_breakpoints_enabled = enable;
@@ -1007,6 +1028,11 @@ void Processor::ClearDisassemblerCallStack()
 {
     while(!m_disassembler_call_stack.empty())
         m_disassembler_call_stack.pop();
+
+#if !defined(GEARBOY_DISABLE_DISASSEMBLER)
+    if (IsValidPointer(m_pCodeProfiler))
+        m_pCodeProfiler->ClearFrames();
+#endif
 }
 
 void Processor::CheckMemoryBreakpoints(int type, u16 address, bool read)
@@ -28,6 +28,8 @@
 
 class Memory;
 class TraceLogger;
+class CodeProfiler;
+class Scheduler;
 
 class Processor
 {
@@ -106,6 +108,7 @@ public:
     void IncrementTIMA();
     bool DuringOpCode() const;
     bool CGBSpeed() const;
+    u64 GetInstructionCount() const;
     void AddCycles(unsigned int cycles);
     bool InterruptIsAboutToRaise();
     void SaveState(std::ostream& stream);
@@ -116,8 +119,9 @@ public:
     void SetDisassemblerSyntax(GB_Disassembler_Syntax syntax);
     GB_Disassembler_Syntax GetDisassemblerSyntax() const;
     NO_INLINE void DisassembleNextOPCode();
-    NO_INLINE void PopulateDisassemblerRecord(GB_Disassembler_Record* record, u16 address);
-    void InvalidateOverlappingRecords(u16 address, u8 opcode_size);
+    NO_INLINE void PopulateDisassemblerRecord(GB_Disassembler_Record* record, u16 address, u16 bank, int irq);
+    void FormatOPCodeName(u16 address, const u8* opcodes, char* text, size_t text_size) const;
+    void InvalidateOverlappingRecords(u16 address, u16 bank, u8 opcode_size);
     void DisassembleAhead(int count);
     void DisassembleAhead(u16 start_address, int count, int depth);
     void EnableBreakpoints(bool enable, bool irqs);
@@ -135,10 +139,14 @@ public:
     void ClearDisassemblerCallStack();
     std::stack<GB_CallStackEntry>* GetDisassemblerCallStack();
     void CheckMemoryBreakpoints(int type, u16 address, bool read);
-    bool Halted();
+    bool Halted() const;
     void SetTraceLogger(TraceLogger* pTraceLogger);
-    INLINE void UpdateTimers(u8 ticks);
+    void SetCodeProfiler(CodeProfiler* pCodeProfiler);
+    void SetScheduler(Scheduler* pScheduler);
+    INLINE void UpdateTimers(unsigned int ticks);
     INLINE void UpdateSerial(u8 ticks);
+    INLINE unsigned int CyclesToTimerEvent();
+    INLINE unsigned int HaltSkipCycles(unsigned int limit);
 
 private:
     typedef void (Processor::*OPCmemberptr) (void);
@@ -154,6 +162,8 @@ private:
     OPCptr m_OPCodesCB[256];
     Memory* m_pMemory;
     TraceLogger* m_pTraceLogger;
+    CodeProfiler* m_pCodeProfiler;
+    Scheduler* m_pScheduler;
     SixteenBitRegister AF;
     SixteenBitRegister BC;
     SixteenBitRegister DE;
@@ -171,6 +181,7 @@ private:
     int m_iSerialCycles;
     int m_iIMECycles;
     int m_iUnhaltCycles;
+    u64 m_iInstructionCount;
     bool m_bCGB;
     int m_iInterruptDelayCycles;
     bool m_bCGBSpeed;
@@ -204,12 +215,16 @@ private:
     void CheckBreakpoints();
     void PushCallStack(u16 src, u16 dest, u16 back, u8 bank);
     void PopCallStack();
-    void FormatDisassemblerDataBytes(char* text, size_t text_size, const u8* bytes, int size);
+    void FormatDisassemblerDataBytes(char* text, size_t text_size, const u8* bytes, int size) const;
     void SetDisassemblerOperandText(GB_Disassembler_Record* record, const char* text);
     void SetDisassemblerOperand(GB_Disassembler_Record* record, u16 address, bool is_zp, const char* text);
+    u16 GetDisassemblerBank(u16 origin, u16 origin_bank, u16 address);
+    u8 DisassemblerRetrieve(u16 origin, u16 origin_bank, u16 address);
     Processor::Interrupts InterruptPending();
     void ServeInterrupt(Interrupts interrupt);
     INLINE void TraceInstruction(u16 pc, bool halt_bug);
+    INLINE void ProfileLocation(u16 pc, bool instruction);
+    INLINE void ProfileCycles(unsigned int cycles);
     INLINE void TraceIRQEvent(u16 pc, u16 vector, u8 irq_type);
     NO_INLINE void LogTraceInstruction(u16 pc, bool halt_bug);
     NO_INLINE void LogIRQEvent(u16 pc, u16 vector, u8 irq_type);
@@ -5,6 +5,7 @@
 #include "definitions.h"
 #include "log.h"
 #include "Memory.h"
+#include "CodeProfiler.h"
 #include "opcode_timing.h"
 
 INLINE void Processor::TraceInstruction(u16 pc, bool halt_bug)
@@ -13,6 +14,18 @@ INLINE void Processor::TraceInstruction(u16 pc, bool halt_bug)
         LogTraceInstruction(pc, halt_bug);
 }
 
+INLINE void Processor::ProfileLocation(u16 pc, bool instruction)
+{
+    if (m_pCodeProfiler->IsEnabled())
+        m_pCodeProfiler->Enter(pc, m_pMemory->GetPhysicalAddress(pc), instruction);
+}
+
+INLINE void Processor::ProfileCycles(unsigned int cycles)
+{
+    if (m_pCodeProfiler->IsEnabled())
+        m_pCodeProfiler->AddCycles(cycles);
+}
+
 INLINE void Processor::TraceIRQEvent(u16 pc, u16 vector, u8 irq_type)
 {
     if (m_pTraceLogger->IsEnabled(TRACE_CPU_IRQ))
@@ -121,11 +134,21 @@ inline bool Processor::DuringOpCode() const
     return m_iAccurateOPCodeState != 0;
 }
 
+inline bool Processor::Halted() const
+{
+    return m_bHalt;
+}
+
 inline bool Processor::CGBSpeed() const
 {
     return m_bCGBSpeed;
 }
 
+inline u64 Processor::GetInstructionCount() const
+{
+    return m_iInstructionCount;
+}
+
 inline void Processor::AddCycles(unsigned int cycles)
 {
     m_iCurrentClockCycles += cycles;
@@ -738,7 +761,10 @@ inline void Processor::PushCallStack(u16 src, u16 dest, u16 back, u8 bank)
     entry.back = back;
     entry.bank = bank;
     if (m_disassembler_call_stack.size() < 256)
+    {
         m_disassembler_call_stack.push(entry);
+        m_pCodeProfiler->PushFrame(dest, bank);
+    }
 #else
     UNUSED(src);
     UNUSED(dest);
@@ -751,7 +777,10 @@ inline void Processor::PopCallStack()
 {
 #if !defined(GEARBOY_DISABLE_DISASSEMBLER)
     if (!m_disassembler_call_stack.empty())
+    {
         m_disassembler_call_stack.pop();
+        m_pCodeProfiler->PopFrame();
+    }
 #endif
 }
 
@@ -802,13 +831,20 @@ INLINE u8 Processor::RunFor(u8 ticks)
             {
                 ServeInterrupt(interrupt);
                 interrupt_served = true;
+#if !defined(GEARBOY_DISABLE_DISASSEMBLER)
+                ProfileLocation(PC.GetValue(), false);
+#endif
             }
             else
             {
-#if !defined(GEARBOY_DISABLE_DISASSEMBLER)
                 if (m_iAccurateOPCodeState == 0)
+                {
+                    m_iInstructionCount++;
+#if !defined(GEARBOY_DISABLE_DISASSEMBLER)
                     TraceInstruction(PC.GetValue(), m_bSkipPCBug);
+                    ProfileLocation(PC.GetValue(), true);
 #endif
+                }
 
                 u8 opcode = m_pMemory->Read(PC.GetValue());
                 PC.Increment();
@@ -923,13 +959,17 @@ INLINE u8 Processor::RunFor(u8 ticks)
             }
         }
 
+#if !defined(GEARBOY_DISABLE_DISASSEMBLER)
+        ProfileCycles(m_iCurrentClockCycles);
+#endif
+
         executed += m_iCurrentClockCycles;
     }
 
     return executed;
 }
 
-INLINE void Processor::UpdateTimers(u8 ticks)
+INLINE void Processor::UpdateTimers(unsigned int ticks)
 {
     m_iDIVCycles += ticks;
 
@@ -998,4 +1038,73 @@ INLINE void Processor::UpdateSerial(u8 ticks)
         UpdateSerialActive(ticks, sc);
 }
 
+// Cycles until TIMA next overflows and requests the timer interrupt
+INLINE unsigned int Processor::CyclesToTimerEvent()
+{
+    u8 tac = m_pMemory->Retrieve(0xFF07);
+
+    if (!(tac & 0x04))
+        return 0x7FFFFFFF;
+
+    unsigned int freq = 0;
+
+    switch (tac & 0x03)
+    {
+        case 0:
+            freq = AdjustedCycles(1024);
+            break;
+        case 1:
+            freq = AdjustedCycles(16);
+            break;
+        case 2:
+            freq = AdjustedCycles(64);
+            break;
+        case 3:
+            freq = AdjustedCycles(256);
+            break;
+    }
+
+    u8 tima = m_pMemory->Retrieve(0xFF05);
+
+    return ((0xFF - tima) * freq) + (freq - m_iTIMACycles);
+}
+
+// Returns how many cycles the CPU can stay halted before anything it
+// could observe happens, given the cycles left until the next scheduled
+// or video event. The result is a whole number of machine cycles that
+// stops short of the earliest event, so batching them is equivalent to
+// running them one by one. Returns 0 when the CPU is not idle.
+INLINE unsigned int Processor::HaltSkipCycles(unsigned int limit)
+{
+    if (!m_bHalt || (m_iAccurateOPCodeState != 0) || (m_iUnhaltCycles != 0))
+        return 0;
+    if ((m_iIMECycles > 0) || (m_iInterruptDelayCycles > 0))
+        return 0;
+    if (InterruptPending() != None_Interrupt)
+        return 0;
+    if ((m_pMemory->Retrieve(0xFF02) & 0x81) == 0x81)
+        return 0;
+
+    // Serial takes the elapsed cycles as a u8
+    if (limit > 0xFF)
+        limit = 0xFF;
+
+    if (limit <= m_iMachineCycle)
+        return 0;
+
+    unsigned int cycles = ((limit - 1) / m_iMachineCycle) * m_iMachineCycle;
+
+#if !defined(GEARBOY_DISABLE_DISASSEMBLER)
+    m_cpu_breakpoint_hit = false;
+    m_memory_breakpoint_hit = false;
+    m_run_to_breakpoint_hit = false;
+
+    // The skipped cycles never go through RunFor, charge them to the
+    // HALT instruction here as RunFor would have
+    ProfileCycles(cycles);
+#endif
+
+    return cycles;
+}
+
 #endif	/* PROCESSOR_INLINE_H */
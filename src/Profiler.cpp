@@ -0,0 +1,135 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include "Profiler.h"
+
+struct ProfilerSectionInfo
+{
+    const char* name;
+    GB_Profiler_Section parent;
+};
+
+// Memory rules run inside the processor and RenderBG runs per pixel fetch
+// in the accurate renderer, but once per line from ScanLine in PERFORMANCE
+static const ProfilerSectionInfo k_profiler_sections[PROFILER_SECTION_COUNT] =
+{
+    { "Frame", PROFILER_FRAME },
+    { "Processor", PROFILER_FRAME },
+    { "Memory Rules", PROFILER_PROCESSOR },
+    { "Video", PROFILER_FRAME },
+    { "ScanLine", PROFILER_VIDEO },
+    { "RenderWindow", PROFILER_VIDEO_SCANLINE },
+    { "RenderSprites", PROFILER_VIDEO_SCANLINE },
+#if defined(PERFORMANCE)
+    { "RenderBG", PROFILER_VIDEO_SCANLINE },
+#else
+    { "RenderBG", PROFILER_VIDEO },
+#endif
+    { "Audio", PROFILER_FRAME },
+    { "Audio End Frame", PROFILER_FRAME },
+    { "Scheduler", PROFILER_FRAME },
+    { "Frame Output", PROFILER_FRAME },
+    { "SGB", PROFILER_FRAME_OUTPUT }
+};
+
+Profiler::Profiler()
+{
+    m_enabled = false;
+    Reset();
+}
+
+void Profiler::Enable(bool enable)
+{
+    if (enable && !m_enabled)
+        Reset();
+
+    m_enabled = enable;
+}
+
+void Profiler::Reset()
+{
+    m_frame_start = 0;
+    m_frame_count = 0;
+    memset(&m_current, 0, sizeof(m_current));
+    memset(&m_last, 0, sizeof(m_last));
+    memset(&m_totals, 0, sizeof(m_totals));
+}
+
+void Profiler::BeginFrame()
+{
+    if (!IsEnabled())
+        return;
+
+    memset(&m_current, 0, sizeof(m_current));
+    m_frame_start = Now();
+}
+
+void Profiler::EndFrame()
+{
+    if (!IsEnabled())
+        return;
+
+    End(PROFILER_FRAME, m_frame_start);
+
+    m_last = m_current;
+
+    for (int i = 0; i < PROFILER_SECTION_COUNT; i++)
+    {
+        m_totals.sections[i].time_ns += m_current.sections[i].time_ns;
+        m_totals.sections[i].calls += m_current.sections[i].calls;
+    }
+
+    m_frame_count++;
+}
+
+const GB_Profiler_Frame* Profiler::GetLastFrame() const
+{
+    return &m_last;
+}
+
+const GB_Profiler_Frame* Profiler::GetTotals() const
+{
+    return &m_totals;
+}
+
+u64 Profiler::GetFrameCount() const
+{
+    return m_frame_count;
+}
+
+const char* Profiler::GetSectionName(GB_Profiler_Section section)
+{
+    return k_profiler_sections[section].name;
+}
+
+GB_Profiler_Section Profiler::GetSectionParent(GB_Profiler_Section section)
+{
+    return k_profiler_sections[section].parent;
+}
+
+int Profiler::GetSectionDepth(GB_Profiler_Section section)
+{
+    int depth = 0;
+    while (section != PROFILER_FRAME)
+    {
+        section = k_profiler_sections[section].parent;
+        depth++;
+    }
+    return depth;
+}
@@ -0,0 +1,129 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include "definitions.h"
+
+enum GB_Profiler_Section
+{
+    PROFILER_FRAME = 0,
+    PROFILER_PROCESSOR,
+    PROFILER_MEMORY_RULES,
+    PROFILER_VIDEO,
+    PROFILER_VIDEO_SCANLINE,
+    PROFILER_VIDEO_RENDER_WINDOW,
+    PROFILER_VIDEO_RENDER_SPRITES,
+    PROFILER_VIDEO_RENDER_BG,
+    PROFILER_AUDIO,
+    PROFILER_AUDIO_END_FRAME,
+    PROFILER_SCHEDULER,
+    PROFILER_FRAME_OUTPUT,
+    PROFILER_SGB,
+    PROFILER_SECTION_COUNT
+};
+
+struct GB_Profiler_Counter
+{
+    u64 time_ns;
+    u64 calls;
+};
+
+struct GB_Profiler_Frame
+{
+    GB_Profiler_Counter sections[PROFILER_SECTION_COUNT];
+};
+
+class Profiler
+{
+public:
+    Profiler();
+    void Enable(bool enable);
+    INLINE bool IsEnabled() const;
+    void Reset();
+    void BeginFrame();
+    void EndFrame();
+    const GB_Profiler_Frame* GetLastFrame() const;
+    const GB_Profiler_Frame* GetTotals() const;
+    u64 GetFrameCount() const;
+    static const char* GetSectionName(GB_Profiler_Section section);
+    static GB_Profiler_Section GetSectionParent(GB_Profiler_Section section);
+    static int GetSectionDepth(GB_Profiler_Section section);
+    INLINE u64 Begin() const;
+    INLINE void End(GB_Profiler_Section section, u64 start);
+    INLINE u64 Lap(GB_Profiler_Section section, u64 start);
+
+private:
+    static INLINE u64 Now();
+
+private:
+    bool m_enabled;
+    u64 m_frame_start;
+    u64 m_frame_count;
+    GB_Profiler_Frame m_current;
+    GB_Profiler_Frame m_last;
+    GB_Profiler_Frame m_totals;
+};
+
+// With GEARBOY_DISABLE_PROFILER every hook folds to nothing
+INLINE bool Profiler::IsEnabled() const
+{
+#if defined(GEARBOY_DISABLE_PROFILER)
+    return false;
+#else
+    return m_enabled;
+#endif
+}
+
+INLINE u64 Profiler::Now()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+INLINE u64 Profiler::Begin() const
+{
+    return IsEnabled() ? Now() : 0;
+}
+
+INLINE void Profiler::End(GB_Profiler_Section section, u64 start)
+{
+    if (IsEnabled())
+    {
+        m_current.sections[section].time_ns += Now() - start;
+        m_current.sections[section].calls++;
+    }
+}
+
+// Closes a section and returns its end time, so back to back sections
+// only read the clock once
+INLINE u64 Profiler::Lap(GB_Profiler_Section section, u64 start)
+{
+    if (!IsEnabled())
+        return 0;
+
+    u64 now = Now();
+    m_current.sections[section].time_ns += now - start;
+    m_current.sections[section].calls++;
+    return now;
+}
+
+#endif /* PROFILER_H */
@@ -41,25 +41,14 @@ bool RomOnlyMemoryRule::MapsROMDirectly()
     return true;
 }
 
-void RomOnlyMemoryRule::Reset(bool bCGB)
+GB_Memory_Rule_Type RomOnlyMemoryRule::GetRuleType()
 {
-    m_bCGB = bCGB;
+    return GB_Memory_Rule_RomOnly;
 }
 
-u8 RomOnlyMemoryRule::PerformRead(u16 address)
+void RomOnlyMemoryRule::Reset(bool bCGB)
 {
-    if (address >= 0xA000 && address < 0xC000)
-    {
-        if (m_pCartridge->GetRAMSize() > 0)
-            return m_pMemory->Retrieve(address);
-        else
-        {
-            Debug("--> ** Attempting to read from RAM without ram in cart %X", address);
-            return 0xFF;
-        }
-    }
-    else
-        return m_pMemory->Retrieve(address);
+    m_bCGB = bCGB;
 }
 
 void RomOnlyMemoryRule::PerformWrite(u16 address, u8 value)
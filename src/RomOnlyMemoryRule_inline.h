@@ -0,0 +1,24 @@
+#ifndef ROMONLYMEMORYRULE_INLINE_H
+#define ROMONLYMEMORYRULE_INLINE_H
+
+#include "RomOnlyMemoryRule.h"
+#include "Memory.h"
+#include "Cartridge.h"
+
+INLINE u8 RomOnlyMemoryRule::PerformRead(u16 address)
+{
+    if (address >= 0xA000 && address < 0xC000)
+    {
+        if (m_pCartridge->GetRAMSize() > 0)
+            return m_pMemory->Retrieve(address);
+        else
+        {
+            Debug("--> ** Attempting to read from RAM without ram in cart %X", address);
+            return 0xFF;
+        }
+    }
+    else
+        return m_pMemory->Retrieve(address);
+}
+
+#endif /* ROMONLYMEMORYRULE_INLINE_H */
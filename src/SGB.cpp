@@ -69,6 +69,11 @@ void SGB::Reset()
     m_iBorderAnimation = 0;
     m_bBorderEmpty = true;
 
+    m_bBorderCacheDirty = true;
+    m_BorderCacheFade = 0;
+    m_BorderCacheColor0 = 0;
+    m_BorderCachePixelFormat = GB_PIXEL_RGB565;
+
     m_PreviousJOYP = 0xCF;
 
     LoadDefaultBorder();
@@ -172,10 +177,10 @@ void SGB::WriteJOYP(u8 value)
     }
 }
 
-void SGB::Render(u16* pFrameBuffer, GB_Color_Format pixelFormat, bool incomplete)
+// Without border the caller's buffer only holds the 160x144 game screen
+void SGB::Render(void* pFrameBuffer, GB_Color_Format pixelFormat, bool incomplete, bool border)
 {
-    if (m_bBorderEmpty)
-        memset(pFrameBuffer, 0, SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * sizeof(u16));
+    bool clear = border && m_bBorderEmpty;
 
     if (m_iVRAMTransferCountdown > 0)
     {
@@ -195,6 +200,7 @@ void SGB::Render(u16* pFrameBuffer, GB_Color_Format pixelFormat, bool incomplete
             m_pPendingBorder = temp;
             m_bBorderEmpty = false;
             m_iBorderAnimation = 32;
+            m_bBorderCacheDirty = true;
         }
         else
         {
@@ -204,6 +210,7 @@ void SGB::Render(u16* pFrameBuffer, GB_Color_Format pixelFormat, bool incomplete
                 Border* temp = m_pBorder;
                 m_pBorder = m_pPendingBorder;
                 m_pPendingBorder = temp;
+                m_bBorderCacheDirty = true;
             }
         }
     }
@@ -211,31 +218,49 @@ void SGB::Render(u16* pFrameBuffer, GB_Color_Format pixelFormat, bool incomplete
     if (m_MaskMode != MaskFreeze && !incomplete)
         memcpy(m_EffectiveScreenBuffer, m_ScreenBuffer, sizeof(m_EffectiveScreenBuffer));
 
+    if (Is32BitPixelFormat(pixelFormat))
+        RenderScreen(static_cast<u32*>(pFrameBuffer), pixelFormat, border, clear);
+    else
+        RenderScreen(static_cast<u16*>(pFrameBuffer), pixelFormat, border, clear);
+}
+
+template<typename T>
+void SGB::RenderScreen(T* pFrameBuffer, GB_Color_Format pixelFormat, bool border, bool clear)
+{
+    int stride = border ? SGB_SCREEN_WIDTH : GAMEBOY_WIDTH;
+    T* pGameScreen = pFrameBuffer;
+
+    if (border)
+    {
+        int offsetX = (SGB_SCREEN_WIDTH - GAMEBOY_WIDTH) / 2;
+        int offsetY = (SGB_SCREEN_HEIGHT - GAMEBOY_HEIGHT) / 2;
+        pGameScreen = &pFrameBuffer[offsetX + offsetY * SGB_SCREEN_WIDTH];
+
+        if (clear)
+            memset(pFrameBuffer, 0, SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT * sizeof(T));
+    }
+
     switch ((MaskMode)m_MaskMode)
     {
         case MaskDisabled:
         case MaskFreeze:
-            RenderGameScreen(pFrameBuffer, pixelFormat);
+            RenderGameScreen(pGameScreen, stride, pixelFormat);
             break;
         case MaskBlack:
         {
-            int offsetX = (SGB_SCREEN_WIDTH - GAMEBOY_WIDTH) / 2;
-            int offsetY = (SGB_SCREEN_HEIGHT - GAMEBOY_HEIGHT) / 2;
             for (int y = 0; y < GAMEBOY_HEIGHT; y++)
             {
-                u16* row = &pFrameBuffer[(offsetX) + (offsetY + y) * SGB_SCREEN_WIDTH];
-                memset(row, 0, GAMEBOY_WIDTH * sizeof(u16));
+                T* row = &pGameScreen[y * stride];
+                memset(row, 0, GAMEBOY_WIDTH * sizeof(T));
             }
             break;
         }
         case MaskColor0:
         {
-            u16 color0 = ConvertRGB15(m_EffectivePalettes[0], pixelFormat);
-            int offsetX = (SGB_SCREEN_WIDTH - GAMEBOY_WIDTH) / 2;
-            int offsetY = (SGB_SCREEN_HEIGHT - GAMEBOY_HEIGHT) / 2;
+            T color0 = (T)ConvertRGB15(m_EffectivePalettes[0], pixelFormat);
             for (int y = 0; y < GAMEBOY_HEIGHT; y++)
             {
-                u16* row = &pFrameBuffer[(offsetX) + (offsetY + y) * SGB_SCREEN_WIDTH];
+                T* row = &pGameScreen[y * stride];
                 for (int x = 0; x < GAMEBOY_WIDTH; x++)
                     row[x] = color0;
             }
@@ -244,7 +269,10 @@ void SGB::Render(u16* pFrameBuffer, GB_Color_Format pixelFormat, bool incomplete
     }
 
     if (!m_bBorderEmpty)
-        RenderBorder(pFrameBuffer, pixelFormat);
+    {
+        UpdateBorderCache(pixelFormat);
+        RenderBorder(pFrameBuffer, border);
+    }
 }
 
 void SGB::CopyScreenBuffer(const u8* pVideoFrameBuffer)
@@ -756,21 +784,19 @@ void SGB::LoadAttributeFile(int fileIndex)
     }
 }
 
-void SGB::RenderGameScreen(u16* pFrameBuffer, GB_Color_Format pixelFormat)
+template<typename T>
+void SGB::RenderGameScreen(T* pOutput, int stride, GB_Color_Format pixelFormat)
 {
-    u16 colors[4 * 4];
+    T colors[4 * 4];
     for (int i = 0; i < 4 * 4; i++)
     {
         u16 rawColor = m_EffectivePalettes[i];
 #ifdef IS_BIG_ENDIAN
         rawColor = (rawColor >> 8) | (rawColor << 8);
 #endif
-        colors[i] = ConvertRGB15(rawColor, pixelFormat);
+        colors[i] = (T)ConvertRGB15(rawColor, pixelFormat);
     }
 
-    int offsetX = (SGB_SCREEN_WIDTH - GAMEBOY_WIDTH) / 2;
-    int offsetY = (SGB_SCREEN_HEIGHT - GAMEBOY_HEIGHT) / 2;
-
     u8* input = m_EffectiveScreenBuffer;
 
     for (int attrY = 0; attrY < SGB_ATTR_MAP_HEIGHT; attrY++)
@@ -779,8 +805,7 @@ void SGB::RenderGameScreen(u16* pFrameBuffer, GB_Color_Format pixelFormat)
         for (int pixelY = 0; pixelY < 8; pixelY++)
         {
             int y = (attrY << 3) + pixelY;
-            u16* output = &pFrameBuffer[offsetX +
-                    (offsetY + y) * SGB_SCREEN_WIDTH];
+            T* output = &pOutput[y * stride];
 
             for (int attrX = 0; attrX < SGB_ATTR_MAP_WIDTH; attrX++)
             {
@@ -795,13 +820,53 @@ void SGB::RenderGameScreen(u16* pFrameBuffer, GB_Color_Format pixelFormat)
     }
 }
 
-void SGB::RenderBorder(u16* pFrameBuffer, GB_Color_Format pixelFormat)
+// Copies the border pixels over the frame. Pixels the border leaves
+// transparent keep whatever the frame already holds
+template<typename T>
+void SGB::RenderBorder(T* pFrameBuffer, bool border)
+{
+    if (border)
+    {
+        for (int i = 0; i < SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT; i++)
+        {
+            if (m_BorderCacheMask[i])
+                pFrameBuffer[i] = (T)m_BorderCache[i];
+        }
+        return;
+    }
+
+    int offsetX = (SGB_SCREEN_WIDTH - GAMEBOY_WIDTH) / 2;
+    int offsetY = (SGB_SCREEN_HEIGHT - GAMEBOY_HEIGHT) / 2;
+
+    for (int y = 0; y < GAMEBOY_HEIGHT; y++)
+    {
+        int input = offsetX + (offsetY + y) * SGB_SCREEN_WIDTH;
+        T* output = &pFrameBuffer[y * GAMEBOY_WIDTH];
+
+        for (int x = 0; x < GAMEBOY_WIDTH; x++)
+        {
+            if (m_BorderCacheMask[input + x])
+                output[x] = (T)m_BorderCache[input + x];
+        }
+    }
+}
+
+// Needed when the border data is edited in place, like from the debugger
+void SGB::InvalidateBorderCache()
+{
+    m_bBorderCacheDirty = true;
+}
+
+// The border only changes when a new one is swapped in, while it fades,
+// or when the game's color 0 changes, so it is composed once into a cache
+// instead of being decoded from its tiles every frame
+void SGB::UpdateBorderCache(GB_Color_Format pixelFormat)
 {
     u16 gameRawColor0 = m_EffectivePalettes[0];
 #ifdef IS_BIG_ENDIAN
     gameRawColor0 = (gameRawColor0 >> 8) | (gameRawColor0 << 8);
 #endif
-    u16 gameColor0 = ConvertRGB15(gameRawColor0, pixelFormat);
+    u32 gameColor0 = ConvertRGB15(gameRawColor0, pixelFormat);
 
     u8 fade = 0;
     if (m_iBorderAnimation > 0 && m_iBorderAnimation <= 64)
@@ -812,7 +877,17 @@ void SGB::RenderBorder(u16* pFrameBuffer, GB_Color_Format pixelFormat)
             fade = m_iBorderAnimation;
     }
 
-    u16 borderColors[16 * 4];
+    if (!m_bBorderCacheDirty && (fade == m_BorderCacheFade) && (gameColor0 == m_BorderCacheColor0) && (pixelFormat == m_BorderCachePixelFormat))
+        return;
+
+    m_bBorderCacheDirty = false;
+    m_BorderCacheFade = fade;
+    m_BorderCacheColor0 = gameColor0;
+    m_BorderCachePixelFormat = pixelFormat;
+
+    memset(m_BorderCacheMask, 0, sizeof(m_BorderCacheMask));
+
+    u32 borderColors[16 * 4];
     for (int i = 0; i < 16 * 4; i++)
     {
         u16 rawColor = m_pBorder->palette[i];
@@ -865,24 +940,25 @@ void SGB::RenderBorder(u16* pFrameBuffer, GB_Color_Format pixelFormat)
 
                     int outX = tile_x * 8 + x;
                     int outY = tile_y * 8 + y;
-
-                    u16* output = &pFrameBuffer[outX + outY * SGB_SCREEN_WIDTH];
+                    int output = outX + outY * SGB_SCREEN_WIDTH;
 
                     if (color == 0)
                     {
                         if (gbArea)
                             continue;
-                        *output = gameColor0;
+                        m_BorderCache[output] = gameColor0;
                     }
                     else
-                        *output = borderColors[color + palette * 16];
+                        m_BorderCache[output] = borderColors[color + palette * 16];
+
+                    m_BorderCacheMask[output] = 1;
                 }
             }
         }
     }
 }
 
-u16 SGB::ConvertRGB15(u16 color, GB_Color_Format pixelFormat)
+u32 SGB::ConvertRGB15(u16 color, GB_Color_Format pixelFormat)
 {
     u8 r5 = (color) & 0x1F;
     u8 g5 = (color >> 5) & 0x1F;
@@ -904,6 +980,10 @@ u16 SGB::ConvertRGB15(u16 color, GB_Color_Format pixelFormat)
         }
         case GB_PIXEL_BGR555:
             return 0x8000 | (b5 << 10) | (g5 << 5) | r5;
+        case GB_PIXEL_RGBA8888:
+        case GB_PIXEL_BGRA8888:
+        case GB_PIXEL_XRGB8888:
+            return PackColor32((u8)((r5 * 255) / 31), (u8)((g5 * 255) / 31), (u8)((b5 * 255) / 31), pixelFormat);
         default:
             return 0;
     }
@@ -979,6 +1059,7 @@ void SGB::LoadState(std::istream& stream)
     stream.read(reinterpret_cast<char*>(m_pPendingBorder), sizeof(Border));
     stream.read(reinterpret_cast<char*>(&m_iBorderAnimation), sizeof(m_iBorderAnimation));
     stream.read(reinterpret_cast<char*>(&m_bBorderEmpty), sizeof(m_bBorderEmpty));
+    m_bBorderCacheDirty = true;
 
     stream.read(reinterpret_cast<char*>(&m_PreviousJOYP), sizeof(m_PreviousJOYP));
 }
@@ -93,8 +93,9 @@ public:
     void Init();
     void Reset();
     void WriteJOYP(u8 value);
-    void Render(u16* pFrameBuffer, GB_Color_Format pixelFormat, bool incomplete);
+    void Render(void* pFrameBuffer, GB_Color_Format pixelFormat, bool incomplete, bool border = true);
     void CopyScreenBuffer(const u8* pVideoFrameBuffer);
+    void InvalidateBorderCache();
     int GetPlayerCount() const;
     int GetCurrentPlayer() const;
     MaskMode GetMaskMode() const;
@@ -135,9 +136,11 @@ private:
     void CommandMASK_EN();
     void PerformVRAMTransfer();
     void LoadAttributeFile(int fileIndex);
-    void RenderGameScreen(u16* pFrameBuffer, GB_Color_Format pixelFormat);
-    void RenderBorder(u16* pFrameBuffer, GB_Color_Format pixelFormat);
-    u16 ConvertRGB15(u16 color, GB_Color_Format pixelFormat);
+    template<typename T> NO_INLINE void RenderScreen(T* pFrameBuffer, GB_Color_Format pixelFormat, bool border, bool clear);
+    template<typename T> void RenderGameScreen(T* pOutput, int stride, GB_Color_Format pixelFormat);
+    template<typename T> void RenderBorder(T* pFrameBuffer, bool border);
+    void UpdateBorderCache(GB_Color_Format pixelFormat);
+    u32 ConvertRGB15(u16 color, GB_Color_Format pixelFormat);
     void LoadDefaultBorder();
 
 private:
@@ -175,6 +178,13 @@ private:
     u8 m_iBorderAnimation;
     bool m_bBorderEmpty;
 
+    u32 m_BorderCache[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+    u8 m_BorderCacheMask[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+    bool m_bBorderCacheDirty;
+    u8 m_BorderCacheFade;
+    u32 m_BorderCacheColor0;
+    GB_Color_Format m_BorderCachePixelFormat;
+
     u8 m_PreviousJOYP;
 };
 
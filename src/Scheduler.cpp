@@ -0,0 +1,57 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#include "Scheduler.h"
+#include "Processor.h"
+#include "Input.h"
+#include "MBC3MemoryRule.h"
+
+Scheduler::Scheduler(Processor* pProcessor, Input* pInput, MBC3MemoryRule* pMBC3MemoryRule)
+{
+    m_pProcessor = pProcessor;
+    m_pInput = pInput;
+    m_pMBC3MemoryRule = pMBC3MemoryRule;
+    m_iPendingCycles = 0;
+    m_iNextEventCycles = 0;
+}
+
+void Scheduler::Reset()
+{
+    m_iPendingCycles = 0;
+    Sync();
+}
+
+void Scheduler::Sync()
+{
+    unsigned int cycles = m_iPendingCycles;
+    m_iPendingCycles = 0;
+
+    if (cycles > 0)
+    {
+        m_pProcessor->UpdateTimers(cycles);
+        m_pInput->Tick(cycles);
+        m_pMBC3MemoryRule->Tick(cycles);
+    }
+
+    unsigned int next = m_pProcessor->CyclesToTimerEvent();
+    next = MIN(next, m_pInput->CyclesToNextUpdate());
+    next = MIN(next, m_pMBC3MemoryRule->CyclesToNextTick());
+
+    m_iNextEventCycles = next;
+}
@@ -0,0 +1,64 @@
+/*
+ * Gearboy - Nintendo Game Boy Emulator
+ * Copyright (C) 2012  Ignacio Sanchez
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ */
+
+#ifndef SCHEDULER_H
+#define	SCHEDULER_H
+
+#include "definitions.h"
+
+class Processor;
+class Input;
+class MBC3MemoryRule;
+
+// Services the subsystems that only need attention at known deadlines
+// (timer overflow, joypad polling and the MBC3 RTC) instead of ticking
+// them after every instruction. Cycles are accumulated and handed over
+// in one batch when the earliest deadline is reached, or earlier when a
+// register access needs the subsystems to be up to date.
+class Scheduler
+{
+public:
+    Scheduler(Processor* pProcessor, Input* pInput, MBC3MemoryRule* pMBC3MemoryRule);
+    void Reset();
+    INLINE void Tick(unsigned int clockCycles);
+    void Sync();
+    INLINE unsigned int CyclesToNextEvent() const;
+
+private:
+    Processor* m_pProcessor;
+    Input* m_pInput;
+    MBC3MemoryRule* m_pMBC3MemoryRule;
+    unsigned int m_iPendingCycles;
+    unsigned int m_iNextEventCycles;
+};
+
+INLINE void Scheduler::Tick(unsigned int clockCycles)
+{
+    m_iPendingCycles += clockCycles;
+
+    if (unlikely(m_iPendingCycles >= m_iNextEventCycles))
+        Sync();
+}
+
+INLINE unsigned int Scheduler::CyclesToNextEvent() const
+{
+    return m_iNextEventCycles - m_iPendingCycles;
+}
+
+#endif	/* SCHEDULER_H */
@@ -157,8 +157,8 @@ enum GB_Trace_Mapper_Event : u8
 
 struct GB_Trace_Entry
 {
-    GB_Trace_Type type;
     u64 cycle;
+    GB_Trace_Type type;
     union
     {
         struct
@@ -173,7 +173,6 @@ struct GB_Trace_Entry
             u8 size;
             u8 halt_bug;
             u8 opcodes[4];
-            char name[64];
         } cpu;
 
         struct
@@ -250,7 +249,7 @@ struct GB_Trace_Entry
     };
 };
 
-static_assert(sizeof(GB_Trace_Entry) <= 104, "Trace entry exceeds memory budget");
+static_assert(sizeof(GB_Trace_Entry) <= 32, "Trace entry exceeds memory budget");
 
 class TraceLogger
 {
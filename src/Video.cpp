@@ -31,7 +31,9 @@ Video::Video(Memory* pMemory, Processor* pProcessor)
     InitPointer(m_pColorFrameBuffer);
     InitPointer(m_pSpriteXCacheBuffer);
     InitPointer(m_pColorCacheBuffer);
+    InitPointer(m_pTileRowCache);
     InitPointer(m_pTraceLogger);
+    InitPointer(m_pProfiler);
     m_iStatusMode = 0;
     m_iStatusModeCounter = 0;
     m_iStatusModeCounterAux = 0;
@@ -54,6 +56,8 @@ Video::Video(Memory* pMemory, Processor* pProcessor)
     m_iHideFrames = 0;
     m_IRQ48Signal = 0;
     m_pixelFormat = GB_PIXEL_RGB565;
+    m_iVideoDataGeneration = 0;
+    m_iOAMGeneration = 0;
 }
 
 Video::~Video()
@@ -61,6 +65,7 @@ Video::~Video()
     SafeDeleteArray(m_pSpriteXCacheBuffer);
     SafeDeleteArray(m_pColorCacheBuffer);
     SafeDeleteArray(m_pFrameBuffer);
+    SafeDeleteArray(m_pTileRowCache);
 }
 
 void Video::Init()
@@ -68,14 +73,84 @@ void Video::Init()
     m_pFrameBuffer = new u8[GAMEBOY_WIDTH * GAMEBOY_HEIGHT];
     m_pSpriteXCacheBuffer = new int[GAMEBOY_WIDTH * GAMEBOY_HEIGHT];
     m_pColorCacheBuffer = new u8[GAMEBOY_WIDTH * GAMEBOY_HEIGHT];
+    m_pTileRowCache = new u64[2 * TILE_ROW_CACHE_ROWS * 2];
+    BuildTileRowLUT();
     Reset(false);
 }
 
+void Video::BuildTileRowLUT()
+{
+    // Spreads the bits of a tile plane byte one per byte, leftmost pixel
+    // first, with a mirrored table for horizontally flipped tiles
+    for (int i = 0; i < 256; i++)
+    {
+        u64 row = 0;
+        u64 row_flip = 0;
+
+        for (int x = 0; x < 8; x++)
+        {
+            if (IsSetBit(i, 7 - x))
+                row |= (u64)1 << (x << 3);
+            if (IsSetBit(i, x))
+                row_flip |= (u64)1 << (x << 3);
+        }
+
+        m_TileRowLUT[0][i] = row;
+        m_TileRowLUT[1][i] = row_flip;
+    }
+}
+
+// Also used after bulk changes that bypass the memory rules, such as
+// loading a state or editing memory from the debugger
+void Video::InvalidateTileCache()
+{
+    for (int i = 0; i < (2 * TILE_ROW_CACHE_ROWS); i++)
+        m_pTileRowCache[i << 1] = TILE_ROW_CACHE_INVALID;
+
+    m_iVideoDataGeneration++;
+    m_iOAMGeneration++;
+}
+
+u32 Video::GetVideoDataGeneration() const
+{
+    return m_iVideoDataGeneration;
+}
+
+u32 Video::GetOAMGeneration() const
+{
+    return m_iOAMGeneration;
+}
+
+void Video::FillTileRowCache(u64* pEntry, int bank, int address)
+{
+    u8 byte1 = 0;
+    u8 byte2 = 0;
+
+    if (bank == 1)
+    {
+        byte1 = m_pMemory->ReadCGBLCDRAM(address, true);
+        byte2 = m_pMemory->ReadCGBLCDRAM(address + 1, true);
+    }
+    else
+    {
+        byte1 = m_pMemory->Retrieve(address);
+        byte2 = m_pMemory->Retrieve(address + 1);
+    }
+
+    pEntry[0] = DecodeTileRow(byte1, byte2, false);
+    pEntry[1] = DecodeTileRow(byte1, byte2, true);
+}
+
 void Video::SetTraceLogger(TraceLogger* pTraceLogger)
 {
     m_pTraceLogger = pTraceLogger;
 }
 
+void Video::SetProfiler(Profiler* pProfiler)
+{
+    m_pProfiler = pProfiler;
+}
+
 void Video::LogTraceEvent(u8 event, u8 value)
 {
 #if !defined(GEARBOY_DISABLE_DISASSEMBLER)
@@ -118,6 +193,7 @@ void Video::Reset(bool bCGB)
         }
 
     RebuildCGBRenderPalettes();
+    InvalidateTileCache();
 
     m_iStatusMode = 1;
     m_iStatusModeCounter = 0;
@@ -172,23 +248,50 @@ void Video::DisableScreen()
     m_IRQ48Signal = 0;
     m_iHideFrames = disabled_in_vblank ? -1 : 0;
 
-    if (!disabled_in_vblank && IsValidPointer(m_pColorFrameBuffer))
+    if (!disabled_in_vblank)
+        ClearScreen();
+}
+
+void Video::ClearScreen()
+{
+    if (!IsValidPointer(m_pColorFrameBuffer))
+        return;
+
+    if (m_bCGB)
     {
-        if (m_bCGB)
-        {
-            for (int i = 0; i < GAMEBOY_WIDTH * GAMEBOY_HEIGHT; i++)
-                m_pColorFrameBuffer[i] = m_CGBWhiteColor;
-        }
-        else
-        {
-            if (!m_bSGBTransferMode)
-                memset(m_pFrameBuffer, 0, GAMEBOY_WIDTH * GAMEBOY_HEIGHT);
-            memset(m_pColorFrameBuffer, 0, GAMEBOY_WIDTH * GAMEBOY_HEIGHT * sizeof(u16));
-        }
+        FillPixels(0, GAMEBOY_WIDTH * GAMEBOY_HEIGHT, m_CGBWhiteColor);
+    }
+    else
+    {
+        if (!m_bSGBTransferMode)
+            memset(m_pFrameBuffer, 0, GAMEBOY_WIDTH * GAMEBOY_HEIGHT);
+        FillPixels(0, GAMEBOY_WIDTH * GAMEBOY_HEIGHT, 0);
+    }
+}
+
+void Video::FillPixels(int position, int count, u32 color)
+{
+    if (Is32BitPixelFormat(m_pixelFormat))
+    {
+        u32* pixels = static_cast<u32*>(m_pColorFrameBuffer) + position;
+        for (int i = 0; i < count; i++)
+            pixels[i] = color;
+    }
+    else
+    {
+        u16* pixels = static_cast<u16*>(m_pColorFrameBuffer) + position;
+        for (int i = 0; i < count; i++)
+            pixels[i] = (u16)color;
     }
 }
 
-void Video::SetColorCorrection(const u16* pColorCorrectionLUT, bool enabled)
+void Video::SetPixelFormat(GB_Color_Format pixelFormat)
+{
+    m_pixelFormat = pixelFormat;
+    RebuildCGBRenderPalettes();
+}
+
+void Video::SetColorCorrection(const u32* pColorCorrectionLUT, bool enabled)
 {
     m_pColorCorrectionLUT = pColorCorrectionLUT;
     m_bColorCorrectionEnabled = enabled;
@@ -206,18 +309,27 @@ void Video::RebuildCGBRenderPalettes()
         }
     }
 
-    m_CGBWhiteColor = (m_bColorCorrectionEnabled &&
-            IsValidPointer(m_pColorCorrectionLUT)) ?
-            m_pColorCorrectionLUT[0xFFFF] : 0xFFFF;
+    m_CGBWhiteColor = GetRenderColor(0xFFFF);
+}
+
+// 32-bit formats keep the palettes in RGB565 and expand them here, so the
+// scanline renderer writes final pixels straight to the frame buffer
+u32 Video::GetRenderColor(u16 color) const
+{
+    if (m_bColorCorrectionEnabled && IsValidPointer(m_pColorCorrectionLUT))
+        return m_pColorCorrectionLUT[color];
+
+    if (Is32BitPixelFormat(m_pixelFormat))
+        return RGB565ToColor32(color, m_pixelFormat);
+
+    return color;
 }
 
 void Video::UpdateCGBRenderPalette(bool background, int palette, int color)
 {
     u16 normal = background ? m_CGBBackgroundPalettes[palette][color][1] :
             m_CGBSpritePalettes[palette][color][1];
-    u16 render = (m_bColorCorrectionEnabled &&
-            IsValidPointer(m_pColorCorrectionLUT)) ?
-            m_pColorCorrectionLUT[normal] : normal;
+    u32 render = GetRenderColor(normal);
 
     if (background)
         m_CGBBackgroundRenderPalettes[palette][color] = render;
@@ -258,6 +370,7 @@ void Video::SetColorPalette(bool background, u8 value)
     u16* palette_color_final = background ? &m_CGBBackgroundPalettes[pal][index][1] : &m_CGBSpritePalettes[pal][index][1];
 
     *palette_color_gbc = hl ? (*palette_color_gbc & 0x00FF) | (value << 8) : (*palette_color_gbc & 0xFF00) | value;
+    m_iVideoDataGeneration++;
     
     u8 red_5bit = *palette_color_gbc & 0x1F;
     u8 blue_5bit = (*palette_color_gbc >> 10) & 0x1F;
@@ -265,6 +378,9 @@ void Video::SetColorPalette(bool background, u8 value)
     switch (m_pixelFormat)
     {
         case GB_PIXEL_RGB565:
+        case GB_PIXEL_RGBA8888:
+        case GB_PIXEL_BGRA8888:
+        case GB_PIXEL_XRGB8888:
         {
             u8 green_5bit = (*palette_color_gbc >> 5) & 0x1F;
             u8 green_6bit = (green_5bit << 1) | (green_5bit >> 4);
@@ -360,19 +476,22 @@ void Video::ScanLine(int line)
 
         if (m_bScreenEnabled && IsSetBit(lcdc, 7))
         {
+            u64 profiler_start = m_pProfiler->Begin();
 #ifdef PERFORMANCE
             RenderBG(line, 0);
+            profiler_start = m_pProfiler->Lap(PROFILER_VIDEO_RENDER_BG, profiler_start);
 #endif
             RenderWindow(line);
+            profiler_start = m_pProfiler->Lap(PROFILER_VIDEO_RENDER_WINDOW, profiler_start);
             RenderSprites(line);
+            m_pProfiler->End(PROFILER_VIDEO_RENDER_SPRITES, profiler_start);
         }
         else
         {
             int line_width = (line * GAMEBOY_WIDTH);
             if (m_bCGB)
             {
-                for (int x = 0; x < GAMEBOY_WIDTH; x++)
-                    m_pColorFrameBuffer[line_width + x] = m_CGBWhiteColor;
+                FillPixels(line_width, GAMEBOY_WIDTH, m_CGBWhiteColor);
             }
             else
             {
@@ -405,6 +524,8 @@ void Video::RenderBG(int line, int pixel)
         int tile_pixel_y_2 = tile_pixel_y << 1;
         int tile_pixel_y_flip_2 = (7 - tile_pixel_y) << 1;
         u8 palette = m_pMemory->Retrieve(0xFF47);
+        u8 dmg_colors[4] = { (u8)(palette & 0x03), (u8)((palette >> 2) & 0x03),
+                (u8)((palette >> 4) & 0x03), (u8)((palette >> 6) & 0x03) };
         int screen_pixel_x = pixel;
         int remaining = pixels_to_render;
 
@@ -444,59 +565,37 @@ void Video::RenderBG(int line, int pixel)
                 int final_pixely_2 = cgb_tile_yflip ?
                         tile_pixel_y_flip_2 : tile_pixel_y_2;
                 int tile_address = tile_start_addr + map_tile_16 + final_pixely_2;
-                u8 byte1 = 0;
-                u8 byte2 = 0;
-
-                if (cgb_tile_bank)
-                {
-                    byte1 = m_pMemory->ReadCGBLCDRAM(tile_address, true);
-                    byte2 = m_pMemory->ReadCGBLCDRAM(tile_address + 1, true);
-                }
-                else
-                {
-                    byte1 = m_pMemory->Retrieve(tile_address);
-                    byte2 = m_pMemory->Retrieve(tile_address + 1);
-                }
-
-                int pixel_bit = cgb_tile_xflip ?
-                        (0x01 << map_tile_offset_x) :
-                        (0x80 >> map_tile_offset_x);
+                u64 row = GetTileRow(cgb_tile_bank ? 1 : 0, tile_address,
+                        cgb_tile_xflip) >> (map_tile_offset_x << 3);
+                const u32* render_palette =
+                        m_CGBBackgroundRenderPalettes[cgb_tile_pal];
+                u8 priority = cgb_tile_priority ? 0x04 : 0x00;
+                int index = line_width + screen_pixel_x;
 
                 for (int i = 0; i < run; i++)
                 {
-                    int pixel_data = (byte1 & pixel_bit) ? 1 : 0;
-                    pixel_data |= (byte2 & pixel_bit) ? 2 : 0;
-
-                    int index = line_width + screen_pixel_x + i;
-                    m_pColorCacheBuffer[index] = pixel_data & 0x03;
-                    if (cgb_tile_priority && (pixel_data != 0))
-                        m_pColorCacheBuffer[index] =
-                                SetBit(m_pColorCacheBuffer[index], 2);
-                    m_pColorFrameBuffer[index] =
-                            m_CGBBackgroundRenderPalettes[cgb_tile_pal][pixel_data];
-
-                    pixel_bit = cgb_tile_xflip ?
-                            (pixel_bit << 1) : (pixel_bit >> 1);
+                    int pixel_data = row & 0x03;
+                    row >>= 8;
+
+                    m_pColorCacheBuffer[index + i] =
+                            pixel_data ? (pixel_data | priority) : 0;
+                    WritePixel(index + i, render_palette[pixel_data]);
                 }
             }
             else
             {
                 int tile_address = tile_start_addr + map_tile_16 + tile_pixel_y_2;
-                u8 byte1 = m_pMemory->Retrieve(tile_address);
-                u8 byte2 = m_pMemory->Retrieve(tile_address + 1);
-                int pixel_bit = 0x80 >> map_tile_offset_x;
+                u64 row = GetTileRow(0, tile_address, false) >>
+                        (map_tile_offset_x << 3);
+                int index = line_width + screen_pixel_x;
 
                 for (int i = 0; i < run; i++)
                 {
-                    int pixel_data = (byte1 & pixel_bit) ? 1 : 0;
-                    pixel_data |= (byte2 & pixel_bit) ? 2 : 0;
-
-                    int index = line_width + screen_pixel_x + i;
-                    m_pColorCacheBuffer[index] = pixel_data & 0x03;
-                    m_pFrameBuffer[index] =
-                            (palette >> (pixel_data << 1)) & 0x03;
+                    int pixel_data = row & 0x03;
+                    row >>= 8;
 
-                    pixel_bit >>= 1;
+                    m_pColorCacheBuffer[index + i] = pixel_data;
+                    m_pFrameBuffer[index + i] = dmg_colors[pixel_data];
                 }
             }
 
@@ -578,21 +677,10 @@ void Video::RenderWindow(int line)
         bool cgb_tile_yflip = m_bCGB ? IsSetBit(cgb_tile_attr, 6) : false;
         int mapOffsetX = x << 3;
         int tile_16 = tile << 4;
-        u8 byte1 = 0;
-        u8 byte2 = 0;
         int final_pixely_2 = (m_bCGB && cgb_tile_yflip) ? pixely_2_flip : pixely_2;
         int tile_address = tiles + tile_16 + final_pixely_2;
-
-        if (m_bCGB && cgb_tile_bank)
-        {
-            byte1 = m_pMemory->ReadCGBLCDRAM(tile_address, true);
-            byte2 = m_pMemory->ReadCGBLCDRAM(tile_address + 1, true);
-        }
-        else
-        {
-            byte1 = m_pMemory->Retrieve(tile_address);
-            byte2 = m_pMemory->Retrieve(tile_address + 1);
-        }
+        u64 row = GetTileRow((m_bCGB && cgb_tile_bank) ? 1 : 0, tile_address,
+                m_bCGB && cgb_tile_xflip);
 
         for (int pixelx = 0; pixelx < 8; pixelx++)
         {
@@ -601,15 +689,7 @@ void Video::RenderWindow(int line)
             if (bufferX < 0 || bufferX >= GAMEBOY_WIDTH)
                 continue;
 
-            int pixelx_pos = pixelx;
-
-            if (m_bCGB && cgb_tile_xflip)
-            {
-                pixelx_pos = 7 - pixelx_pos;
-            }
-
-            int pixel = (byte1 & (0x1 << (7 - pixelx_pos))) ? 1 : 0;
-            pixel |= (byte2 & (0x1 << (7 - pixelx_pos))) ? 2 : 0;
+            int pixel = (row >> (pixelx << 3)) & 0x03;
 
             int position = line_width + bufferX;
             m_pColorCacheBuffer[position] = pixel & 0x03;
@@ -619,8 +699,7 @@ void Video::RenderWindow(int line)
                 bool cgb_tile_priority = IsSetBit(cgb_tile_attr, 7) && IsSetBit(lcdc, 0);
                 if (cgb_tile_priority && (pixel != 0))
                     m_pColorCacheBuffer[position] = SetBit(m_pColorCacheBuffer[position], 2);
-                m_pColorFrameBuffer[position] =
-                        m_CGBBackgroundRenderPalettes[cgb_tile_pal][pixel];
+                WritePixel(position, m_CGBBackgroundRenderPalettes[cgb_tile_pal][pixel]);
             }
             else
             {
@@ -653,8 +732,6 @@ INLINE void Video::RenderSprite(int line, int sprite, int sprite_height, int lin
     int cgb_tile_pal = sprite_flags & 0x07;
     int tiles = 0x8000;
     int pixel_y = yflip ? ((sprite_height == 16) ? 15 : 7) - (line - sprite_y) : line - sprite_y;
-    u8 byte1 = 0;
-    u8 byte2 = 0;
     int pixel_y_2 = 0;
     int offset = 0;
 
@@ -667,22 +744,14 @@ INLINE void Video::RenderSprite(int line, int sprite, int sprite_height, int lin
         pixel_y_2 = pixel_y << 1;
 
     int tile_address = tiles + sprite_tile_16 + pixel_y_2 + offset;
+    u64 row = GetTileRow((m_bCGB && cgb_tile_bank) ? 1 : 0, tile_address, xflip);
 
-    if (m_bCGB && cgb_tile_bank)
-    {
-        byte1 = m_pMemory->ReadCGBLCDRAM(tile_address, true);
-        byte2 = m_pMemory->ReadCGBLCDRAM(tile_address + 1, true);
-    }
-    else
-    {
-        byte1 = m_pMemory->Retrieve(tile_address);
-        byte2 = m_pMemory->Retrieve(tile_address + 1);
-    }
+    if (row == 0)
+        return;
 
     for (int pixelx = 0; pixelx < 8; pixelx++)
     {
-        int pixel = (byte1 & (0x01 << (xflip ? pixelx : 7 - pixelx))) ? 1 : 0;
-        pixel |= (byte2 & (0x01 << (xflip ? pixelx : 7 - pixelx))) ? 2 : 0;
+        int pixel = (row >> (pixelx << 3)) & 0x03;
 
         if (pixel == 0)
             continue;
@@ -714,8 +783,7 @@ INLINE void Video::RenderSprite(int line, int sprite, int sprite_height, int lin
         m_pSpriteXCacheBuffer[position] = sprite_x;
         if (m_bCGB)
         {
-            m_pColorFrameBuffer[position] =
-                    m_CGBSpriteRenderPalettes[cgb_tile_pal][pixel];
+            WritePixel(position, m_CGBSpriteRenderPalettes[cgb_tile_pal][pixel]);
         }
         else
         {
@@ -875,6 +943,7 @@ void Video::LoadState(std::istream& stream, u32 version)
     }
 
     RebuildCGBRenderPalettes();
+    InvalidateTileCache();
 }
 
 PaletteMatrix Video::GetCGBBackgroundPalettes()
@@ -22,10 +22,14 @@
 
 #include "definitions.h"
 #include "TraceLogger.h"
+#include "Profiler.h"
 
 class Memory;
 class Processor;
 
+#define TILE_ROW_CACHE_ROWS 0x0C00
+#define TILE_ROW_CACHE_INVALID 0xFFFFFFFFFFFFFFFFULL
+
 typedef u16 (*PaletteMatrix)[8][4][2];
 
 class Video
@@ -36,15 +40,17 @@ public:
     void Init();
     void Reset(bool bCGB);
     void ResetToBootromState();
-    inline bool Tick(unsigned int &clockCycles, u16* pColorFrameBuffer, GB_Color_Format pixelFormat);
+    inline bool Tick(unsigned int &clockCycles, void* pColorFrameBuffer);
+    inline unsigned int CyclesToNextEvent() const;
     void EnableScreen();
     void DisableScreen();
     void SetSGBTransferMode(bool enabled);
     void SetNoSpriteLimit(bool noSpriteLimit);
     INLINE bool IsScreenEnabled() const;
     INLINE const u8* GetFrameBuffer() const;
-    INLINE const u16* GetColorFrameBuffer() const;
-    void SetColorCorrection(const u16* pColorCorrectionLUT, bool enabled);
+    INLINE const void* GetColorFrameBuffer() const;
+    void SetPixelFormat(GB_Color_Format pixelFormat);
+    void SetColorCorrection(const u32* pColorCorrectionLUT, bool enabled);
     void UpdatePaletteToSpecification(bool background, u8 value);
     void SetColorPalette(bool background, u8 value);
     INLINE bool VRAMAccessBlocked() const;
@@ -61,6 +67,13 @@ public:
     PaletteMatrix GetCGBBackgroundPalettes();
     PaletteMatrix GetCGBSpritePalettes();
     void SetTraceLogger(TraceLogger* pTraceLogger);
+    void SetProfiler(Profiler* pProfiler);
+    INLINE void InvalidateTileRow(int bank, u16 address);
+    void InvalidateTileCache();
+    INLINE void MarkVideoDataChanged();
+    INLINE void MarkOAMChanged();
+    u32 GetVideoDataGeneration() const;
+    u32 GetOAMGeneration() const;
 
 private:
     void ScanLine(int line);
@@ -70,6 +83,14 @@ private:
     NO_INLINE void RenderSpritesNoLimit(int line, int spriteHeight, int lineWidth);
     INLINE void RenderSprite(int line, int sprite, int spriteHeight, int lineWidth);
     void RebuildCGBRenderPalettes();
+    u32 GetRenderColor(u16 color) const;
+    void ClearScreen();
+    void FillPixels(int position, int count, u32 color);
+    INLINE void WritePixel(int position, u32 color);
+    void BuildTileRowLUT();
+    INLINE u64 DecodeTileRow(u8 byte1, u8 byte2, bool xflip) const;
+    INLINE u64 GetTileRow(int bank, int address, bool xflip);
+    NO_INLINE void FillTileRowCache(u64* pEntry, int bank, int address);
     NO_INLINE void UpdateCGBRenderPalette(bool background, int palette, int color);
     void UpdateStatRegister();
     INLINE void TraceEvent(u8 event, u8 value);
@@ -79,7 +100,7 @@ private:
     Memory* m_pMemory;
     Processor* m_pProcessor;
     u8* m_pFrameBuffer;
-    u16* m_pColorFrameBuffer;
+    void* m_pColorFrameBuffer;
     int* m_pSpriteXCacheBuffer;
     u8* m_pColorCacheBuffer;
     int m_iStatusMode;
@@ -104,11 +125,16 @@ private:
     u8 m_IRQ48Signal;
     GB_Color_Format m_pixelFormat;
     TraceLogger* m_pTraceLogger;
-    u16 m_CGBSpriteRenderPalettes[8][4];
-    u16 m_CGBBackgroundRenderPalettes[8][4];
-    const u16* m_pColorCorrectionLUT;
+    Profiler* m_pProfiler;
+    u32 m_CGBSpriteRenderPalettes[8][4];
+    u32 m_CGBBackgroundRenderPalettes[8][4];
+    const u32* m_pColorCorrectionLUT;
     bool m_bColorCorrectionEnabled;
-    u16 m_CGBWhiteColor;
+    u32 m_CGBWhiteColor;
+    u64 m_TileRowLUT[2][256];
+    u64* m_pTileRowCache;
+    u32 m_iVideoDataGeneration;
+    u32 m_iOAMGeneration;
 };
 
 INLINE void Video::TraceEvent(u8 event, u8 value)
@@ -127,11 +153,19 @@ INLINE const u8* Video::GetFrameBuffer() const
     return m_pFrameBuffer;
 }
 
-INLINE const u16* Video::GetColorFrameBuffer() const
+INLINE const void* Video::GetColorFrameBuffer() const
 {
     return m_pColorFrameBuffer;
 }
 
+INLINE void Video::WritePixel(int position, u32 color)
+{
+    if (Is32BitPixelFormat(m_pixelFormat))
+        static_cast<u32*>(m_pColorFrameBuffer)[position] = color;
+    else
+        static_cast<u16*>(m_pColorFrameBuffer)[position] = (u16)color;
+}
+
 INLINE bool Video::CGBPaletteAccessBlocked() const
 {
     return m_bCGB && m_bScreenEnabled && (m_iStatusMode == 3);
@@ -152,6 +186,48 @@ INLINE u8 Video::GetIRQ48Signal() const
     return m_IRQ48Signal;
 }
 
+// Decodes both planes of a tile row at once, the color index of screen
+// pixel x ends up in byte x of the result
+INLINE u64 Video::DecodeTileRow(u8 byte1, u8 byte2, bool xflip) const
+{
+    const u64* lut = m_TileRowLUT[xflip ? 1 : 0];
+    return lut[byte1] | (lut[byte2] << 1);
+}
+
+// The cache holds both flip variants of every decoded row of the 384
+// tiles in each VRAM bank, rows are decoded again after being written
+INLINE u64 Video::GetTileRow(int bank, int address, bool xflip)
+{
+    u64* entry = m_pTileRowCache +
+            (((bank * TILE_ROW_CACHE_ROWS) + ((address - 0x8000) >> 1)) << 1);
+
+    if (unlikely(entry[0] == TILE_ROW_CACHE_INVALID))
+        FillTileRowCache(entry, bank, address);
+
+    return entry[xflip ? 1 : 0];
+}
+
+INLINE void Video::InvalidateTileRow(int bank, u16 address)
+{
+    m_iVideoDataGeneration++;
+
+    if (address < 0x9800)
+        m_pTileRowCache[((bank * TILE_ROW_CACHE_ROWS) +
+                ((address - 0x8000) >> 1)) << 1] = TILE_ROW_CACHE_INVALID;
+}
+
+// Generations let frontends skip rebuilding their VRAM viewers. Video data
+// covers VRAM, palettes and LCDC, OAM is counted on its own
+INLINE void Video::MarkVideoDataChanged()
+{
+    m_iVideoDataGeneration++;
+}
+
+INLINE void Video::MarkOAMChanged()
+{
+    m_iOAMGeneration++;
+}
+
 #include "Video_inline.h"
 
 #endif	/* VIDEO_H */
@@ -4,10 +4,9 @@
 #include "Processor.h"
 #include "Memory.h"
 
-inline bool Video::Tick(unsigned int &clockCycles, u16* pColorFrameBuffer, GB_Color_Format pixelFormat)
+inline bool Video::Tick(unsigned int &clockCycles, void* pColorFrameBuffer)
 {
     m_pColorFrameBuffer = pColorFrameBuffer;
-    m_pixelFormat = pixelFormat;
 
     bool vblank = false;
     m_iStatusModeCounter += clockCycles;
@@ -63,20 +62,7 @@ inline bool Video::Tick(unsigned int &clockCycles, u16* pColorFrameBuffer, GB_Co
                         {
                             m_iHideFrames--;
 
-                            if (IsValidPointer(m_pColorFrameBuffer))
-                            {
-                                if (m_bCGB)
-                                {
-                                    for (int i = 0; i < GAMEBOY_WIDTH * GAMEBOY_HEIGHT; i++)
-                                        m_pColorFrameBuffer[i] = m_CGBWhiteColor;
-                                }
-                                else
-                                {
-                                    if (!m_bSGBTransferMode)
-                                        memset(m_pFrameBuffer, 0, GAMEBOY_WIDTH * GAMEBOY_HEIGHT);
-                                    memset(m_pColorFrameBuffer, 0, GAMEBOY_WIDTH * GAMEBOY_HEIGHT * sizeof(u16));
-                                }
-                            }
+                            ClearScreen();
 
                             vblank = true;
                         }
@@ -155,7 +141,9 @@ inline bool Video::Tick(unsigned int &clockCycles, u16* pColorFrameBuffer, GB_Co
                         {
                             if (IsValidPointer(m_pColorFrameBuffer))
                             {
+                                u64 profiler_start = m_pProfiler->Begin();
                                 RenderBG(m_iStatusModeLYCounter, m_iPixelCounter);
+                                m_pProfiler->End(PROFILER_VIDEO_RENDER_BG, profiler_start);
                             }
                             m_iPixelCounter += 4;
                             m_iTileCycleCounter -= 3;
@@ -171,7 +159,9 @@ inline bool Video::Tick(unsigned int &clockCycles, u16* pColorFrameBuffer, GB_Co
 
                 if (m_iStatusModeCounter >= 160 && !m_bScanLineTransfered)
                 {
+                    u64 profiler_start = m_pProfiler->Begin();
                     ScanLine(m_iStatusModeLYCounter);
+                    m_pProfiler->End(PROFILER_VIDEO_SCANLINE, profiler_start);
                     m_bScanLineTransfered = true;
                 }
 
@@ -241,20 +231,7 @@ inline bool Video::Tick(unsigned int &clockCycles, u16* pColorFrameBuffer, GB_Co
             m_iStatusModeCounter -= 70224;
             m_iHideFrames = 0;
 
-            if (IsValidPointer(m_pColorFrameBuffer))
-            {
-                if (m_bCGB)
-                {
-                    for (int i = 0; i < GAMEBOY_WIDTH * GAMEBOY_HEIGHT; i++)
-                        m_pColorFrameBuffer[i] = m_CGBWhiteColor;
-                }
-                else
-                {
-                    if (!m_bSGBTransferMode)
-                        memset(m_pFrameBuffer, 0, GAMEBOY_WIDTH * GAMEBOY_HEIGHT);
-                    memset(m_pColorFrameBuffer, 0, GAMEBOY_WIDTH * GAMEBOY_HEIGHT * sizeof(u16));
-                }
-            }
+            ClearScreen();
 
             vblank = true;
         }
@@ -262,4 +239,43 @@ inline bool Video::Tick(unsigned int &clockCycles, u16* pColorFrameBuffer, GB_Co
     return vblank;
 }
 
+// Cycles until Tick() reaches its next mode, line or interrupt transition
+inline unsigned int Video::CyclesToNextEvent() const
+{
+    int cycles = 0x7FFFFFFF;
+
+    if (m_iPendingVBlankInterruptCycles > 0)
+        cycles = m_iPendingVBlankInterruptCycles;
+
+    if (m_bScreenEnabled)
+    {
+        switch (m_iStatusMode)
+        {
+            case 0:
+                cycles = MIN(cycles, 204 - m_iStatusModeCounter);
+                break;
+            case 1:
+                cycles = MIN(cycles, 456 - m_iStatusModeCounterAux);
+                cycles = MIN(cycles, 4560 - m_iStatusModeCounter);
+                if (m_iStatusModeLYCounter == 153)
+                    cycles = MIN(cycles, MAX(4104 - m_iStatusModeCounter, 4 - m_iStatusModeCounterAux));
+                break;
+            case 2:
+                cycles = MIN(cycles, 80 - m_iStatusModeCounter);
+                break;
+            case 3:
+                if (!m_bScanLineTransfered)
+                    cycles = MIN(cycles, 160 - m_iStatusModeCounter);
+                cycles = MIN(cycles, 172 - m_iStatusModeCounter);
+                break;
+        }
+    }
+    else if (m_iScreenEnableDelayCycles > 0)
+        cycles = MIN(cycles, m_iScreenEnableDelayCycles);
+    else
+        cycles = MIN(cycles, 70224 - m_iStatusModeCounter);
+
+    return (cycles > 0) ? (unsigned int)cycles : 0;
+}
+
 #endif /* VIDEO_INLINE_H */
@@ -167,12 +167,17 @@ struct GB_Color
     u8 blue;
 };
 
+// RGBA8888 and BGRA8888 give the byte order in memory, XRGB8888 is a
+// native endian 0xXXRRGGBB word. 32-bit formats take u32 frame buffers
 enum GB_Color_Format
 {
     GB_PIXEL_RGB565,
     GB_PIXEL_RGB555,
     GB_PIXEL_BGR565,
-    GB_PIXEL_BGR555
+    GB_PIXEL_BGR555,
+    GB_PIXEL_RGBA8888,
+    GB_PIXEL_BGRA8888,
+    GB_PIXEL_XRGB8888
 };
 
 enum Gameboy_Keys
@@ -245,6 +250,68 @@ inline int AsHex(const char c)
   return c >= 'A' ? c - 'A' + 0xA : c - '0';
 }
 
+inline bool Is32BitPixelFormat(GB_Color_Format format)
+{
+    return format >= GB_PIXEL_RGBA8888;
+}
+
+inline u32 PackColor32(u8 red, u8 green, u8 blue, GB_Color_Format format)
+{
+    u32 r = red;
+    u32 g = green;
+    u32 b = blue;
+
+    switch (format)
+    {
+        case GB_PIXEL_RGBA8888:
+#if defined(IS_BIG_ENDIAN)
+            return (r << 24) | (g << 16) | (b << 8) | 0xFF;
+#else
+            return 0xFF000000 | (b << 16) | (g << 8) | r;
+#endif
+        case GB_PIXEL_BGRA8888:
+#if defined(IS_BIG_ENDIAN)
+            return (b << 24) | (g << 16) | (r << 8) | 0xFF;
+#else
+            return 0xFF000000 | (r << 16) | (g << 8) | b;
+#endif
+        case GB_PIXEL_XRGB8888:
+            return 0xFF000000 | (r << 16) | (g << 8) | b;
+        default:
+            return 0;
+    }
+}
+
+inline GB_Color UnpackColor32(u32 color, GB_Color_Format format)
+{
+    GB_Color out;
+    u32 rgb = color;
+
+    // Bring every format to 0xXXRRGGBB
+#if defined(IS_BIG_ENDIAN)
+    if (format != GB_PIXEL_XRGB8888)
+        rgb = color >> 8;
+    if (format == GB_PIXEL_BGRA8888)
+        rgb = ((rgb & 0xFF) << 16) | (rgb & 0xFF00) | ((rgb >> 16) & 0xFF);
+#else
+    if (format == GB_PIXEL_RGBA8888)
+        rgb = ((color & 0xFF) << 16) | (color & 0xFF00) | ((color >> 16) & 0xFF);
+#endif
+
+    out.red = (rgb >> 16) & 0xFF;
+    out.green = (rgb >> 8) & 0xFF;
+    out.blue = rgb & 0xFF;
+    return out;
+}
+
+inline u32 RGB565ToColor32(u16 color, GB_Color_Format format)
+{
+    u8 red = (u8)((((color >> 11) & 0x1F) * 255) / 31);
+    u8 green = (u8)((((color >> 5) & 0x3F) * 255) / 63);
+    u8 blue = (u8)(((color & 0x1F) * 255) / 31);
+    return PackColor32(red, green, blue, format);
+}
+
 #if !defined(DEBUG_GEARBOY)
     #if defined(__GNUC__) || defined(__clang__)
         #if !defined(__OPTIMIZE__) && !defined(__OPTIMIZE_SIZE__)
@@ -33,6 +33,8 @@
 #include "SixteenBitRegister.h"
 #include "MemoryRule.h"
 #include "TraceLogger.h"
+#include "Profiler.h"
+#include "CodeProfiler.h"
 
 #endif	/* GEARBOY_H */
 
@@ -27,8 +27,6 @@
 #if defined(__LIBRETRO__)
 #include "libretro.h"
 extern retro_log_printf_t log_cb;
-#else
-extern bool g_mcp_stdio_mode;
 #endif
 
 #if defined(DEBUG_GEARBOY)
@@ -44,8 +42,24 @@ extern bool g_mcp_stdio_mode;
 #define Log(msg, ...) (Log_func(msg, ##__VA_ARGS__))
 #define Error(msg, ...) (Log_func("ERROR [%s:%d] " msg, __FILE__, __LINE__, ##__VA_ARGS__))
 
+// Frontends that own stdout, like headless tools or a stdio transport,
+// silence the core through this switch
+inline bool& Log_quiet()
+{
+    static bool quiet = false;
+    return quiet;
+}
+
+inline void Log_set_quiet(bool quiet)
+{
+    Log_quiet() = quiet;
+}
+
 NO_INLINE COLD inline void Log_func(const char* const msg, ...)
 {
+    if (Log_quiet())
+        return;
+
     char buffer[512];
     va_list args;
     va_start(args, msg);
@@ -65,9 +79,6 @@ NO_INLINE COLD inline void Log_func(const char* const msg, ...)
         return;
     }
 #else
-    if (g_mcp_stdio_mode)
-        return;
-
     printf("%s\n", buffer);
     fflush(stdout);
     return;
@@ -107,6 +107,65 @@ public:
     }
 };
 
+// Discards everything written to it and only counts the bytes, so the
+// serialized size can be measured without building the state anywhere
+class counting_buffer : public std::streambuf
+{
+private:
+    size_t count;
+
+public:
+    counting_buffer()
+    {
+        count = 0;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+protected:
+    std::streamsize xsputn(const char*, std::streamsize n) override
+    {
+        count += (size_t)n;
+        return n;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if (c != EOF)
+            count++;
+        return traits_type::not_eof(c);
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which = std::ios_base::out) override
+    {
+        if ((which & std::ios_base::out) && (dir == std::ios_base::cur) && (off == 0))
+            return pos_type(off_type(count));
+
+        return pos_type(off_type(-1));
+    }
+};
+
+class counting_stream : public std::ostream
+{
+private:
+    counting_buffer buf;
+
+public:
+    counting_stream()
+        : std::ostream(NULL)
+    {
+        rdbuf(&buf);
+    }
+
+    size_t size() const
+    {
+        return buf.size();
+    }
+};
+
 class memory_input_buffer : public std::streambuf {
 private:
     const char* buffer_start;
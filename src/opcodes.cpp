@@ -19,6 +19,7 @@
 
 #include "Processor.h"
 #include "Memory.h"
+#include "Scheduler.h"
 #include "opcode_timing.h"
 
 void Processor::OPCode0x00()
@@ -131,6 +132,7 @@ void Processor::OPCode0x10()
 {
     // STOP
     PC.Increment();
+    m_pScheduler->Sync();
     ResetDIVCycles();
 
     if (m_bCGB)
@@ -155,6 +157,8 @@ void Processor::OPCode0x10()
             m_iMachineCycle = 4 >> m_iSpeedMultiplier;
         }
     }
+
+    m_pScheduler->Sync();
 }
 
 void Processor::OPCode0x11()